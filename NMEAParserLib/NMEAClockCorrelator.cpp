@@ -0,0 +1,315 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include "NMEAClockCorrelator.h"
+
+namespace {
+	static const double			c_dSecondsPerDay = 86400.0;
+	static const double			c_dDefaultMaxResidual = 0.25;					///< seconds
+	static const double			c_dMinPairSpan = 0.5;							///< Shortest UTC distance of a sample pair used for a slope (seconds)
+	static const double			c_dMaxDrift = 1.0e-3;							///< Rates further than this from 1 are not a clock (ie: a log read from a file)
+
+	///
+	/// \brief Median of the first uCount values, reorders them
+	///
+	double Median(std::vector<double> &vdValues, size_t uCount)
+	{
+		size_t uMiddle = uCount / 2;
+		std::nth_element(vdValues.begin(), vdValues.begin() + uMiddle, vdValues.begin() + uCount);
+		double dMedian = vdValues[uMiddle];
+		if ((uCount & 1) == 0)
+		{
+			double dLower = *std::max_element(vdValues.begin(), vdValues.begin() + uMiddle);
+			dMedian = (dMedian + dLower) / 2.0;
+		}
+		return dMedian;
+	}
+}
+
+CNMEAClockCorrelator::CNMEAClockCorrelator() :
+	m_nSamples(0),
+	m_nNext(0),
+	m_nOutliers(0),
+	m_nSinceFit(0),
+	m_nHoldOff(0),
+	m_dLastTimeOfDay(-1.0),
+	m_dLastUTC(0.0),
+	m_nDay(0),
+	m_bDateKnown(false),
+	m_dLatency(0.0),
+	m_dMaxResidual(c_dDefaultMaxResidual)
+{
+	m_vdScratch.reserve(c_nMaxSamples * (c_nMaxSamples - 1) / 2);
+	Reset();
+}
+
+CNMEAClockCorrelator::~CNMEAClockCorrelator()
+{
+}
+
+void CNMEAClockCorrelator::Reset(void)
+{
+	m_nSamples = 0;
+	m_nNext = 0;
+	m_nOutliers = 0;
+	m_nSinceFit = 0;
+	m_nHoldOff = 0;
+	m_dLastTimeOfDay = -1.0;
+	m_dLastUTC = 0.0;
+	m_nDay = 0;
+	m_bDateKnown = false;
+	memset(&m_Fit, 0, sizeof(m_Fit));
+	m_Fit.m_dRate = 1.0;
+	m_Snapshot.Publish(m_Fit);
+}
+
+void CNMEAClockCorrelator::Restart(void)
+{
+	m_nSamples = 0;
+	m_nNext = 0;
+	m_nOutliers = 0;
+	m_nSinceFit = 0;
+	m_nHoldOff = 0;
+	m_Fit.m_bValid = false;
+	m_Fit.m_uSamples = 0;
+	m_Fit.m_uResets++;
+	m_Snapshot.Publish(m_Fit);
+}
+
+bool CNMEAClockCorrelator::AddFix(const CNMEAParserData::FIX_RECORD_T & fix)
+{
+	const uint32_t uTimed = CNMEAParserData::FIX_HAS_GGA | CNMEAParserData::FIX_HAS_RMC | CNMEAParserData::FIX_HAS_GLL | CNMEAParserData::FIX_HAS_ZDA;
+	if ((fix.m_uContentMask & uTimed) == 0)
+	{
+		return false;
+	}
+
+	double dTimeOfDay = (double)fix.m_nHour * 3600.0 + (double)fix.m_nMinute * 60.0 + fix.m_dSecond;
+	if (fix.m_uContentMask & CNMEAParserData::FIX_HAS_DATE)
+	{
+		if (m_bDateKnown == false)
+		{
+			//
+			// The samples so far count days from the first fix, start again on the calendar
+			//
+			if (m_nSamples != 0)
+			{
+				Restart();
+			}
+			m_bDateKnown = true;
+		}
+		m_nDay = DaysFromCivil(fix.m_nYear, fix.m_nMonth, fix.m_nDay);
+	}
+	else if (m_dLastTimeOfDay >= 0.0 && dTimeOfDay < m_dLastTimeOfDay - c_dSecondsPerDay / 2.0)
+	{
+		m_nDay++;
+	}
+	m_dLastTimeOfDay = dTimeOfDay;
+	m_dLastUTC = (double)m_nDay * c_dSecondsPerDay + dTimeOfDay;
+
+	return AddSample(m_dLastUTC, fix.m_nRxTimeNs - (int64_t)(m_dLatency * 1.0e9));
+}
+
+bool CNMEAClockCorrelator::AddSample(double dUTC, int64_t nHostNs)
+{
+	if (m_nSamples != 0)
+	{
+		const SAMPLE_T &newest = m_pSamples[(m_nNext + c_nMaxSamples - 1) % c_nMaxSamples];
+		if (dUTC == newest.dUTC)
+		{
+			return false;		// same epoch again
+		}
+		if (dUTC < newest.dUTC || nHostNs <= newest.nHostNs)
+		{
+			Restart();			// time went backwards, ie: receiver reset or a new log
+		}
+	}
+
+	//
+	// A sample far off the fit is skipped; several in a row mean the time jumped
+	//
+	if (m_Fit.m_bValid)
+	{
+		int64_t nPredictedNs;
+		UTCToHost(m_Fit, dUTC, nPredictedNs);
+		double dResidual = (double)(nHostNs - nPredictedNs) * 1.0e-9;
+		if (fabs(dResidual) > m_dMaxResidual)
+		{
+			if (++m_nOutliers < c_nMaxOutliers)
+			{
+				return false;
+			}
+			Restart();
+		}
+		else
+		{
+			m_nOutliers = 0;
+		}
+	}
+
+	m_pSamples[m_nNext].dUTC = dUTC;
+	m_pSamples[m_nNext].nHostNs = nHostNs;
+	if (m_nSamples < c_nMaxSamples)
+	{
+		m_nSamples++;
+	}
+	UpdateSlopes(m_nNext);
+	m_nNext = (m_nNext + 1) % c_nMaxSamples;
+
+	//
+	// Fit every sample until the fit is valid, then every c_nRefitInterval samples.
+	// A valid fit between refits still predicts the new samples, they are checked above.
+	//
+	m_Fit.m_uSamples = (uint32_t)m_nSamples;
+	m_Fit.m_bDateKnown = m_bDateKnown;
+	m_nSinceFit++;
+	if (m_nHoldOff > 0)
+	{
+		m_nHoldOff--;
+	}
+	else if (m_nSamples >= c_nMinSamples && (m_Fit.m_bValid == false || m_nSinceFit >= c_nRefitInterval))
+	{
+		Fit();
+		m_nSinceFit = 0;
+	}
+	m_Snapshot.Publish(m_Fit);
+	return m_Fit.m_bValid;
+}
+
+void CNMEAClockCorrelator::Fit(void)
+{
+	//
+	// Slope: median of the pairwise slopes
+	//
+	m_vdScratch.clear();
+	for (int i = 0; i < m_nSamples; i++)
+	{
+		for (int j = i + 1; j < m_nSamples; j++)
+		{
+			double dSlope = m_pdSlopes[i][j];
+			if (dSlope == dSlope)
+			{
+				m_vdScratch.push_back(dSlope);
+			}
+		}
+	}
+	if (m_vdScratch.empty())
+	{
+		m_Fit.m_bValid = false;
+		return;
+	}
+	double dRate = Median(m_vdScratch, m_vdScratch.size());
+	if (fabs(dRate - 1.0) > c_dMaxDrift)
+	{
+		//
+		// Not a clock, or too few samples to tell yet. Wait as many samples as there
+		// are before trying again, a log replay then costs a fit every window.
+		//
+		m_Fit.m_bValid = false;
+		m_nHoldOff = m_nSamples;
+		return;
+	}
+
+	//
+	// Relative to the newest sample, so the doubles keep full resolution
+	//
+	const SAMPLE_T &newest = m_pSamples[(m_nNext + c_nMaxSamples - 1) % c_nMaxSamples];
+	double pdX[c_nMaxSamples];
+	double pdY[c_nMaxSamples];
+	for (int i = 0; i < m_nSamples; i++)
+	{
+		pdX[i] = m_pSamples[i].dUTC - newest.dUTC;
+		pdY[i] = (double)(m_pSamples[i].nHostNs - newest.nHostNs) * 1.0e-9;
+	}
+
+	//
+	// Intercept: median of the intercepts through every sample
+	//
+	m_vdScratch.resize(m_nSamples);
+	for (int i = 0; i < m_nSamples; i++)
+	{
+		m_vdScratch[i] = pdY[i] - dRate * pdX[i];
+	}
+	double dIntercept = Median(m_vdScratch, m_nSamples);
+
+	for (int i = 0; i < m_nSamples; i++)
+	{
+		m_vdScratch[i] = fabs(pdY[i] - dIntercept - dRate * pdX[i]);
+	}
+
+	m_Fit.m_dResidual = Median(m_vdScratch, m_nSamples);
+	m_Fit.m_dUTCRef = newest.dUTC;
+	m_Fit.m_nHostRefNs = newest.nHostNs + (int64_t)llround(dIntercept * 1.0e9);
+	m_Fit.m_dRate = dRate;
+	m_Fit.m_bValid = true;
+}
+
+void CNMEAClockCorrelator::UpdateSlopes(int nSlot)
+{
+	const SAMPLE_T &sample = m_pSamples[nSlot];
+	for (int i = 0; i < m_nSamples; i++)
+	{
+		double dX = m_pSamples[i].dUTC - sample.dUTC;
+		double dSlope = NAN;
+		if (i != nSlot && fabs(dX) >= c_dMinPairSpan)
+		{
+			dSlope = (double)(m_pSamples[i].nHostNs - sample.nHostNs) * 1.0e-9 / dX;
+		}
+		m_pdSlopes[nSlot][i] = dSlope;
+		m_pdSlopes[i][nSlot] = dSlope;
+	}
+}
+
+bool CNMEAClockCorrelator::UTCToHost(const CNMEAParserData::CLOCK_FIT_T & fit, double dUTC, int64_t & nHostNs)
+{
+	if (fit.m_bValid == false)
+	{
+		return false;
+	}
+	nHostNs = fit.m_nHostRefNs + (int64_t)llround((dUTC - fit.m_dUTCRef) * fit.m_dRate * 1.0e9);
+	return true;
+}
+
+bool CNMEAClockCorrelator::HostToUTC(const CNMEAParserData::CLOCK_FIT_T & fit, int64_t nHostNs, double & dUTC)
+{
+	if (fit.m_bValid == false)
+	{
+		return false;
+	}
+	dUTC = fit.m_dUTCRef + (double)(nHostNs - fit.m_nHostRefNs) * 1.0e-9 / fit.m_dRate;
+	return true;
+}
+
+int64_t CNMEAClockCorrelator::DaysFromCivil(int nYear, int nMonth, int nDay)
+{
+	int64_t y = nYear - (nMonth <= 2 ? 1 : 0);
+	int64_t nEra = (y >= 0 ? y : y - 399) / 400;
+	int64_t nYearOfEra = y - nEra * 400;
+	int64_t nDayOfYear = (153 * (nMonth + (nMonth > 2 ? -3 : 9)) + 2) / 5 + nDay - 1;
+	int64_t nDayOfEra = nYearOfEra * 365 + nYearOfEra / 4 - nYearOfEra / 100 + nDayOfYear;
+	return nEra * 146097 + nDayOfEra - 719468;
+}
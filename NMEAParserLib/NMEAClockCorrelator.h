@@ -0,0 +1,180 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include "NMEAParserData.h"
+#include "NMEASnapshot.h"
+
+///
+/// \class CNMEAClockCorrelator
+/// \brief Fits GNSS UTC epochs against their host receive times (monotonic clock).
+///
+/// Every fix record gives one sample: the UTC time of the epoch and the monotonic clock
+/// time its first byte was received. The receive times carry serial and scheduling jitter
+/// and the occasional late read, so the line through the last c_nMaxSamples samples is a
+/// Theil-Sen fit: the median of the pairwise slopes and the median intercept, which
+/// ignores up to about a third of bad samples.
+///
+/// The pairwise slopes are kept between samples, so a new sample only computes its own
+/// pairs. Once the fit is valid it is refitted every c_nRefitInterval samples; a rate that
+/// is not a clock (ie: a log read from a file) holds off fitting for as many samples as
+/// the window holds.
+///
+/// The fit is published as a CNMEASnapshot, so any thread can convert with UTCToHost() and
+/// HostToUTC() without waiting for the parser. The host times include the constant output
+/// latency of the receiver (time from the epoch to the first byte); SetLatency() removes
+/// it if it is known, ie: measured against PPS.
+///
+class CNMEAClockCorrelator
+{
+public:
+	static const int				c_nMaxSamples = 64;							///< Fit window (fixes)
+	static const int				c_nMinSamples = 4;							///< Samples needed for a fit
+	static const int				c_nMaxOutliers = 3;							///< Consecutive samples off the fit that start it again
+	static const int				c_nRefitInterval = 16;						///< Samples between refits of a valid fit
+
+private:
+	typedef struct _SAMPLE_T {
+		double						dUTC;										///< UTC (seconds)
+		int64_t						nHostNs;									///< Host monotonic clock (nanoseconds)
+	} SAMPLE_T;
+
+	SAMPLE_T						m_pSamples[c_nMaxSamples];					///< Ring of samples
+	int								m_nSamples;									///< Samples in m_pSamples
+	int								m_nNext;									///< Next ring position
+	int								m_nOutliers;								///< Consecutive samples off the fit
+	int								m_nSinceFit;								///< Samples added since the last fit
+	int								m_nHoldOff;									///< Samples to add before fitting again after a rejected rate
+	double							m_dLastTimeOfDay;							///< Time of day of the last sample, -1 if none
+	double							m_dLastUTC;									///< UTC of the last fix added
+	int64_t							m_nDay;										///< Day of the last sample, days since 1970 or since the first fix
+	bool							m_bDateKnown;								///< m_nDay is a calendar day
+	double							m_dLatency;									///< Receiver output latency (seconds)
+	double							m_dMaxResidual;								///< Distance from the fit that makes a sample an outlier (seconds)
+	CNMEAParserData::CLOCK_FIT_T	m_Fit;										///< Current fit
+	CNMEASnapshot<CNMEAParserData::CLOCK_FIT_T>	m_Snapshot;					///< Published copy of m_Fit
+	double							m_pdSlopes[c_nMaxSamples][c_nMaxSamples];	///< Pairwise slopes by ring position, NaN if the pair is too close
+	std::vector<double>				m_vdScratch;								///< Pairwise slopes and residuals, reused
+
+public:
+	CNMEAClockCorrelator();
+	virtual ~CNMEAClockCorrelator();
+
+	///
+	/// \brief Drops all samples and the fit
+	///
+	void Reset(void);
+
+	///
+	/// \brief Sets the receiver output latency subtracted from the receive times (seconds)
+	///
+	void SetLatency(double dSeconds) { m_dLatency = dSeconds; }
+
+	///
+	/// \brief Sets how far a sample may be from the fit before it counts as an outlier (seconds, default 0.25)
+	///
+	void SetMaxResidual(double dSeconds) { m_dMaxResidual = dSeconds; }
+
+	///
+	/// \brief Adds the UTC time and receive time of a fix record
+	///
+	/// Records without a time are ignored. The date comes from the record if it has one;
+	/// before the first date the days are counted from the first fix.
+	///
+	/// \return true if the fit is valid
+	///
+	bool AddFix(const CNMEAParserData::FIX_RECORD_T &fix);
+
+	///
+	/// \brief Adds one sample
+	///
+	/// \param dUTC UTC time of the epoch (seconds, same origin for all samples)
+	/// \param nHostNs Host monotonic clock time the epoch was received (nanoseconds)
+	/// \return true if the fit is valid
+	///
+	bool AddSample(double dUTC, int64_t nHostNs);
+
+	///
+	/// \brief Returns the host time of the last fix added according to the fit
+	///
+	/// Free of the receive time jitter of that fix, ie: the time stamp for a filter.
+	///
+	/// \param nHostNs Returned host time (nanoseconds)
+	/// \return false if the fit is not valid
+	///
+	bool GetLastFixHostTime(int64_t &nHostNs) const { return UTCToHost(m_Fit, m_dLastUTC, nHostNs); }
+
+	///
+	/// \brief Returns the current fit
+	///
+	const CNMEAParserData::CLOCK_FIT_T &GetFit(void) const { return m_Fit; }
+
+	///
+	/// \brief Returns the published fit. Safe to read from any thread.
+	///
+	const CNMEASnapshot<CNMEAParserData::CLOCK_FIT_T> &GetSnapshot(void) const { return m_Snapshot; }
+
+	///
+	/// \brief Converts UTC to the host monotonic clock
+	///
+	/// \param fit Fit, see GetFit() or GetSnapshot()
+	/// \param dUTC UTC (seconds, see CLOCK_FIT_T::m_bDateKnown)
+	/// \param nHostNs Returned host time (nanoseconds)
+	/// \return false if the fit is not valid
+	///
+	static bool UTCToHost(const CNMEAParserData::CLOCK_FIT_T &fit, double dUTC, int64_t &nHostNs);
+
+	///
+	/// \brief Converts the host monotonic clock to UTC
+	///
+	/// \param fit Fit, see GetFit() or GetSnapshot()
+	/// \param nHostNs Host time (nanoseconds), see CNMEAClock::GetTimeNs()
+	/// \param dUTC Returned UTC (seconds)
+	/// \return false if the fit is not valid
+	///
+	static bool HostToUTC(const CNMEAParserData::CLOCK_FIT_T &fit, int64_t nHostNs, double &dUTC);
+
+	///
+	/// \brief Days since 1970-01-01 of a calendar date
+	///
+	static int64_t DaysFromCivil(int nYear, int nMonth, int nDay);
+
+private:
+	///
+	/// \brief Theil-Sen fit of the samples into m_Fit
+	///
+	void Fit(void);
+
+	///
+	/// \brief Computes the slopes between the sample at nSlot and the other samples
+	///
+	void UpdateSlopes(int nSlot);
+
+	///
+	/// \brief Drops the samples but keeps counting resets
+	///
+	void Restart(void);
+};
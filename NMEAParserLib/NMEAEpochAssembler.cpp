@@ -0,0 +1,400 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include <string.h>
+#include "NMEAEpochAssembler.h"
+#include "NMEASentenceGGA.h"
+#include "NMEASentenceGSA.h"
+#include "NMEASentenceGSV.h"
+#include "NMEASentenceRMC.h"
+#include "NMEASentenceVTG.h"
+#include "NMEASentenceZDA.h"
+#include "NMEASentenceGST.h"
+#include "NMEASentenceGLL.h"
+#include "NMEASentenceHDT.h"
+#include "NMEAClock.h"
+
+CNMEAEpochAssembler::CNMEAEpochAssembler()
+{
+	Reset();
+}
+
+CNMEAEpochAssembler::~CNMEAEpochAssembler()
+{
+}
+
+void CNMEAEpochAssembler::Reset(void)
+{
+	memset(&m_Fix, 0, sizeof(m_Fix));
+	m_bOpen = false;
+	m_nTimeOfDayMs = -1;
+	m_nPositionRank = 0;
+	m_nLastTimeOfDayMs = -1;
+	m_bEarlyComplete = false;
+	m_uExpectedCount = 0;
+	m_bSkyViewOpen = false;
+	m_nSkyViewTalkers = 0;
+	m_nDateYear = 0;
+	m_nDateMonth = 0;
+	m_nDateDay = 0;
+	m_nDateTimeOfDayMs = -1;
+	m_uEpoch = 0;
+	m_uSatelliteSerial = 0;
+	m_pLastFix.reset();
+}
+
+void CNMEAEpochAssembler::AddSentence(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID, const CNMEASentenceBase * pSentence, int64_t nRxTimeNs)
+{
+	bool bTimed = false;
+	switch (nSentenceID)
+	{
+	case CNMEAParserData::SID_GGA:
+	case CNMEAParserData::SID_RMC:
+	case CNMEAParserData::SID_ZDA:
+	case CNMEAParserData::SID_GST:
+	case CNMEAParserData::SID_GLL:
+		bTimed = true;
+		break;
+	case CNMEAParserData::SID_GSA:
+	case CNMEAParserData::SID_GSV:
+	case CNMEAParserData::SID_VTG:
+	case CNMEAParserData::SID_HDT:
+		break;
+	default:
+		return;
+	}
+
+	//
+	// Sentences without a time join the open epoch. With no epoch open the last one was
+	// completed too early; leave the sentence out and measure the burst again.
+	//
+	if (bTimed == false && m_bOpen == false)
+	{
+		if (m_bEarlyComplete == true)
+		{
+			m_uExpectedCount = 0;
+			return;
+		}
+		Open(nRxTimeNs);
+	}
+
+	switch (nSentenceID)
+	{
+	case CNMEAParserData::SID_GGA:
+		{
+			const CNMEAParserData::GGA_DATA_T &ggaData = static_cast<const CNMEASentenceGGA *>(pSentence)->GetSentenceData();
+			if (SetTime(ggaData.m_nHour, ggaData.m_nMinute, ggaData.m_nSecond, ggaData.m_dSecond, nRxTimeNs) == false)
+			{
+				return;
+			}
+			if (TakePosition(3, nTalkerID) == true)
+			{
+				m_Fix.m_dLatitude = ggaData.m_dLatitude;
+				m_Fix.m_dLongitude = ggaData.m_dLongitude;
+			}
+			m_Fix.m_dAltitudeMSL = ggaData.m_dAltitudeMSL;
+			m_Fix.m_dGeoidalSep = ggaData.m_dGeoidalSep;
+			m_Fix.m_nGPSQuality = ggaData.m_nGPSQuality;
+			m_Fix.m_nSatsUsed = ggaData.m_nSatsInView;
+			m_Fix.m_dHDOP = ggaData.m_dHDOP;
+			m_Fix.m_dDifferentialAge = ggaData.m_dDifferentialAge;
+			m_Fix.m_nDifferentialID = ggaData.m_nDifferentialID;
+			m_Fix.m_uContentMask |= CNMEAParserData::FIX_HAS_GGA;
+		}
+		break;
+
+	case CNMEAParserData::SID_RMC:
+		{
+			const CNMEAParserData::RMC_DATA_T &rmcData = static_cast<const CNMEASentenceRMC *>(pSentence)->GetSentenceData();
+			if (SetTime(rmcData.m_nHour, rmcData.m_nMinute, rmcData.m_nSecond, rmcData.m_dSecond, nRxTimeNs) == false)
+			{
+				return;
+			}
+			if (TakePosition(2, nTalkerID) == true)
+			{
+				m_Fix.m_dLatitude = rmcData.m_dLatitude;
+				m_Fix.m_dLongitude = rmcData.m_dLongitude;
+			}
+			m_Fix.m_nStatus = rmcData.m_nStatus;
+			if ((m_Fix.m_uContentMask & CNMEAParserData::FIX_HAS_VTG) == 0)
+			{
+				m_Fix.m_dSpeedKnots = rmcData.m_dSpeedKnots;
+				m_Fix.m_dTrackAngle = rmcData.m_dTrackAngle;
+			}
+			m_Fix.m_dMagneticVariation = rmcData.m_dMagneticVariation;
+			SetDate(rmcData.m_nYear, rmcData.m_nMonth, rmcData.m_nDay);
+			m_Fix.m_uContentMask |= CNMEAParserData::FIX_HAS_RMC;
+		}
+		break;
+
+	case CNMEAParserData::SID_ZDA:
+		{
+			const CNMEAParserData::ZDA_DATA_T &zdaData = static_cast<const CNMEASentenceZDA *>(pSentence)->GetSentenceData();
+			if (SetTime(zdaData.m_nHour, zdaData.m_nMinute, zdaData.m_nSecond, zdaData.m_dSecond, nRxTimeNs) == false)
+			{
+				return;
+			}
+			SetDate(zdaData.m_nYear, zdaData.m_nMonth, zdaData.m_nDay);
+			m_Fix.m_uContentMask |= CNMEAParserData::FIX_HAS_ZDA;
+		}
+		break;
+
+	case CNMEAParserData::SID_GST:
+		{
+			const CNMEAParserData::GST_DATA_T &gstData = static_cast<const CNMEASentenceGST *>(pSentence)->GetSentenceData();
+			if (SetTime(gstData.m_nHour, gstData.m_nMinute, gstData.m_nSecond, gstData.m_dSecond, nRxTimeNs) == false)
+			{
+				return;
+			}
+			m_Fix.m_dLatitudeSigma = gstData.m_dLatitudeSigma;
+			m_Fix.m_dLongitudeSigma = gstData.m_dLongitudeSigma;
+			m_Fix.m_dAltitudeSigma = gstData.m_dAltitudeSigma;
+			m_Fix.m_uContentMask |= CNMEAParserData::FIX_HAS_GST;
+		}
+		break;
+
+	case CNMEAParserData::SID_GLL:
+		{
+			const CNMEAParserData::GLL_DATA_T &gllData = static_cast<const CNMEASentenceGLL *>(pSentence)->GetSentenceData();
+			if (SetTime(gllData.m_nHour, gllData.m_nMinute, gllData.m_nSecond, gllData.m_dSecond, nRxTimeNs) == false)
+			{
+				return;
+			}
+			if (TakePosition(1, nTalkerID) == true)
+			{
+				m_Fix.m_dLatitude = gllData.m_dLatitude;
+				m_Fix.m_dLongitude = gllData.m_dLongitude;
+			}
+			if ((m_Fix.m_uContentMask & CNMEAParserData::FIX_HAS_RMC) == 0)
+			{
+				m_Fix.m_nStatus = gllData.m_nStatus;
+			}
+			m_Fix.m_uContentMask |= CNMEAParserData::FIX_HAS_GLL;
+		}
+		break;
+
+	case CNMEAParserData::SID_GSA:
+		{
+			const CNMEASentenceGSA *pGSA = static_cast<const CNMEASentenceGSA *>(pSentence);
+			const CNMEAParserData::GSA_DATA_T &gsaData = pGSA->GetSentenceData();
+			m_Fix.m_nFixMode = gsaData.nMode;
+			m_Fix.m_dPDOP = gsaData.dPDOP;
+			m_Fix.m_dVDOP = gsaData.dVDOP;
+			if ((m_Fix.m_uContentMask & CNMEAParserData::FIX_HAS_GGA) == 0)
+			{
+				m_Fix.m_dHDOP = gsaData.dHDOP;
+			}
+			int nCount = 0;
+			const int *pnPRN = pGSA->GetSentencePRNs(nCount);
+			AddActivePRNs(pnPRN, nCount);
+			m_Fix.m_uContentMask |= CNMEAParserData::FIX_HAS_GSA;
+		}
+		break;
+
+	case CNMEAParserData::SID_GSV:
+		AddSkyView(nTalkerID, static_cast<const CNMEASentenceGSV *>(pSentence)->GetSentenceData());
+		m_Fix.m_uContentMask |= CNMEAParserData::FIX_HAS_GSV;
+		break;
+
+	case CNMEAParserData::SID_VTG:
+		{
+			const CNMEAParserData::VTG_DATA_T &vtgData = static_cast<const CNMEASentenceVTG *>(pSentence)->GetSentenceData();
+			m_Fix.m_dSpeedKnots = vtgData.m_dSpeedKnots;
+			m_Fix.m_dTrackAngle = vtgData.m_dTrackTrue;
+			m_Fix.m_uContentMask |= CNMEAParserData::FIX_HAS_VTG;
+		}
+		break;
+
+	case CNMEAParserData::SID_HDT:
+		m_Fix.m_dHeading = static_cast<const CNMEASentenceHDT *>(pSentence)->GetSentenceData().m_dHeading;
+		m_Fix.m_uContentMask |= CNMEAParserData::FIX_HAS_HDT;
+		break;
+
+	default:
+		return;
+	}
+
+	//
+	// Complete as soon as the epoch is as long as the last measured one
+	//
+	m_Fix.m_uSentenceCount++;
+	if (m_uExpectedCount != 0 && m_Fix.m_uSentenceCount >= m_uExpectedCount && m_bSkyViewOpen == false && m_nTimeOfDayMs >= 0)
+	{
+		Complete();
+		m_bEarlyComplete = true;
+	}
+}
+
+void CNMEAEpochAssembler::Flush(void)
+{
+	Complete();
+}
+
+void CNMEAEpochAssembler::Open(int64_t nRxTimeNs)
+{
+	memset(&m_Fix, 0, sizeof(m_Fix));
+	m_Fix.m_nRxTimeNs = nRxTimeNs;
+	m_bOpen = true;
+	m_bEarlyComplete = false;
+	m_nTimeOfDayMs = -1;
+	m_nPositionRank = 0;
+	m_bSkyViewOpen = false;
+	m_nSkyViewTalkers = 0;
+}
+
+void CNMEAEpochAssembler::Complete(void)
+{
+	if (m_bOpen == false)
+	{
+		return;
+	}
+
+	//
+	// Carry the last date into epochs without RMC or ZDA until UTC passes midnight
+	//
+	if ((m_Fix.m_uContentMask & CNMEAParserData::FIX_HAS_DATE) == 0 && m_nDateTimeOfDayMs >= 0)
+	{
+		if (m_nTimeOfDayMs >= m_nDateTimeOfDayMs)
+		{
+			m_Fix.m_nYear = m_nDateYear;
+			m_Fix.m_nMonth = m_nDateMonth;
+			m_Fix.m_nDay = m_nDateDay;
+			m_Fix.m_uContentMask |= CNMEAParserData::FIX_HAS_DATE;
+		}
+		else
+		{
+			m_nDateTimeOfDayMs = -1;
+		}
+	}
+
+	m_Fix.m_uEpoch = ++m_uEpoch;
+	m_Fix.m_uSatelliteSerial = m_uSatelliteSerial;
+	m_Fix.m_nCompleteNs = CNMEAClock::GetTimeNs();
+	m_pLastFix = std::make_shared<CNMEAParserData::FIX_RECORD_T>(m_Fix);
+	m_nLastTimeOfDayMs = m_nTimeOfDayMs;
+	m_bOpen = false;
+
+	if (m_Callback)
+	{
+		m_Callback(m_pLastFix);
+	}
+}
+
+bool CNMEAEpochAssembler::SetTime(int nHour, int nMinute, int nSecond, double dSecond, int64_t nRxTimeNs)
+{
+	int nTimeOfDayMs = (nHour * 3600 + nMinute * 60) * 1000 + (int)(dSecond * 1000.0 + 0.5);
+
+	//
+	// A new time starts a new epoch. The sentence count of a complete epoch is what
+	// the next epochs are expected to hold.
+	//
+	if (m_bOpen == true && m_nTimeOfDayMs >= 0 && nTimeOfDayMs != m_nTimeOfDayMs)
+	{
+		m_uExpectedCount = m_Fix.m_uSentenceCount;
+		Complete();
+	}
+
+	if (m_bOpen == false)
+	{
+		if (m_bEarlyComplete == true && nTimeOfDayMs == m_nLastTimeOfDayMs)
+		{
+			m_uExpectedCount = 0;
+			return false;
+		}
+		Open(nRxTimeNs);
+	}
+
+	if (m_nTimeOfDayMs < 0)
+	{
+		m_nTimeOfDayMs = nTimeOfDayMs;
+		m_Fix.m_nHour = nHour;
+		m_Fix.m_nMinute = nMinute;
+		m_Fix.m_nSecond = nSecond;
+		m_Fix.m_dSecond = dSecond;
+	}
+	return true;
+}
+
+void CNMEAEpochAssembler::SetDate(int nYear, int nMonth, int nDay)
+{
+	if (nDay == 0)
+	{
+		return;
+	}
+	m_Fix.m_nYear = m_nDateYear = nYear;
+	m_Fix.m_nMonth = m_nDateMonth = nMonth;
+	m_Fix.m_nDay = m_nDateDay = nDay;
+	m_nDateTimeOfDayMs = m_nTimeOfDayMs;
+	m_Fix.m_uContentMask |= CNMEAParserData::FIX_HAS_DATE;
+}
+
+bool CNMEAEpochAssembler::TakePosition(int nRank, CNMEAParserData::TALKER_ID_E nTalkerID)
+{
+	if (nRank <= m_nPositionRank)
+	{
+		return false;
+	}
+	m_nPositionRank = nRank;
+	m_Fix.m_nTalkerID = nTalkerID;
+	return true;
+}
+
+void CNMEAEpochAssembler::AddActivePRNs(const int * pnPRN, int nCount)
+{
+	for (int i = 0; i < nCount; i++)
+	{
+		if (pnPRN[i] == CNMEAParserData::c_nInvlidPRN)
+		{
+			continue;
+		}
+
+		int j = 0;
+		while (j < m_Fix.m_nActiveSats && m_Fix.m_pnActivePRN[j] != pnPRN[i])
+		{
+			j++;
+		}
+		if (j == m_Fix.m_nActiveSats && m_Fix.m_nActiveSats < CNMEAParserData::c_nMaxFixActiveSats)
+		{
+			m_Fix.m_pnActivePRN[m_Fix.m_nActiveSats++] = pnPRN[i];
+		}
+	}
+}
+
+void CNMEAEpochAssembler::AddSkyView(CNMEAParserData::TALKER_ID_E nTalkerID, const CNMEAParserData::GSV_DATA_T & gsvData)
+{
+	m_bSkyViewOpen = gsvData.nSentenceNumber < gsvData.nTotalNumberOfSentences;
+
+	for (int i = 0; i < m_nSkyViewTalkers; i++)
+	{
+		if (m_pnSkyViewTalkers[i] == nTalkerID)
+		{
+			return;
+		}
+	}
+	if (m_nSkyViewTalkers < c_nMaxSkyViewTalkers)
+	{
+		m_pnSkyViewTalkers[m_nSkyViewTalkers++] = nTalkerID;
+		m_Fix.m_nSatsInView += gsvData.nSatsInView;
+	}
+}
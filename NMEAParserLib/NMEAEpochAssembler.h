@@ -0,0 +1,154 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <stdint.h>
+#include <functional>
+#include <memory>
+#include "NMEAParserData.h"
+#include "NMEASentenceBase.h"
+
+///
+/// \class CNMEAEpochAssembler
+/// \brief Merges the sentences of one navigation epoch into a single FIX_RECORD_T.
+///
+/// A receiver sends a burst of sentences (GGA, RMC, GSA, GSV, ...) for every position
+/// update. All sentences that carry the same UTC time belong to the same epoch; sentences
+/// without a time (GSA, GSV, VTG, HDT) belong to the epoch that is open when they arrive.
+///
+/// An epoch is completed when a sentence with a different UTC time arrives, or as soon as
+/// it holds as many sentences as the last epoch that was completed by a time change and no
+/// GSV group is half received. The second rule delivers the record at the end of the burst
+/// instead of one update period later. Sentences that still arrive for an epoch that was
+/// completed early are left out of the record and early completion is suspended until the
+/// next time change has measured the burst again.
+///
+/// Records are immutable and handed out as shared pointers, so any number of consumers can
+/// keep them without copying.
+///
+class CNMEAEpochAssembler
+{
+public:
+	typedef std::shared_ptr<const CNMEAParserData::FIX_RECORD_T> FIX_PTR_T;
+	typedef std::function<void(const FIX_PTR_T &)> FIX_CALLBACK_T;
+
+	static const int				c_nMaxSkyViewTalkers = 8;					///< Maximum number of GSV talkers counted in one epoch
+
+private:
+	CNMEAParserData::FIX_RECORD_T	m_Fix;										///< Epoch being assembled
+	bool							m_bOpen;									///< m_Fix holds at least one sentence
+	int								m_nTimeOfDayMs;								///< UTC time of m_Fix in milliseconds of the day, -1 if not known yet
+	int								m_nPositionRank;							///< Rank of the sentence that supplied the position, GGA 3, RMC 2, GLL 1
+	int								m_nLastTimeOfDayMs;							///< UTC time of the last completed epoch, -1 if none
+	bool							m_bEarlyComplete;							///< The last epoch was completed on m_uExpectedCount
+	uint32_t						m_uExpectedCount;							///< Sentences per epoch, 0 until measured
+	bool							m_bSkyViewOpen;								///< A GSV group has been started but not finished
+	int								m_nSkyViewTalkers;							///< Number of entries in m_pnSkyViewTalkers
+	CNMEAParserData::TALKER_ID_E	m_pnSkyViewTalkers[c_nMaxSkyViewTalkers];	///< GSV talkers already counted in m_Fix.m_nSatsInView
+	int								m_nDateYear;								///< Last received date
+	int								m_nDateMonth;								///< Last received date
+	int								m_nDateDay;									///< Last received date
+	int								m_nDateTimeOfDayMs;							///< UTC time the last date was received, -1 if none
+	uint32_t						m_uEpoch;									///< Number of records completed
+	uint32_t						m_uSatelliteSerial;							///< Current satellite database serial
+	FIX_PTR_T						m_pLastFix;									///< Last completed record
+	FIX_CALLBACK_T					m_Callback;									///< Called for every completed record
+
+public:
+	CNMEAEpochAssembler();
+	virtual ~CNMEAEpochAssembler();
+
+	///
+	/// \brief Drops the open epoch and everything learned about the sentence stream
+	///
+	void Reset(void);
+
+	///
+	/// \brief Sets the function that is called with every completed record
+	///
+	void SetCallback(const FIX_CALLBACK_T &callback) { m_Callback = callback; }
+
+	///
+	/// \brief Sets the satellite database serial copied into the records
+	///
+	void SetSatelliteSerial(uint32_t uSerial) { m_uSatelliteSerial = uSerial; }
+
+	///
+	/// \brief Adds a decoded sentence. May complete an epoch and call the callback.
+	///
+	/// \param nTalkerID Talker ID
+	/// \param nSentenceID Sentence ID
+	/// \param pSentence Sentence object that just decoded the sentence
+	/// \param nRxTimeNs Start of message time of the sentence
+	///
+	void AddSentence(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID, const CNMEASentenceBase *pSentence, int64_t nRxTimeNs);
+
+	///
+	/// \brief Completes the open epoch, if any. Use it at the end of a log.
+	///
+	void Flush(void);
+
+	///
+	/// \brief Returns the last completed record, empty if none
+	///
+	const FIX_PTR_T &GetLastFix(void) const { return m_pLastFix; }
+
+private:
+	///
+	/// \brief Starts a new epoch
+	///
+	void Open(int64_t nRxTimeNs);
+
+	///
+	/// \brief Publishes m_Fix and closes the epoch
+	///
+	void Complete(void);
+
+	///
+	/// \brief Sets the epoch time from a sentence with a UTC time, completes the open epoch first if the time changed
+	///
+	/// \return false if the sentence belongs to an epoch that was already completed
+	///
+	bool SetTime(int nHour, int nMinute, int nSecond, double dSecond, int64_t nRxTimeNs);
+
+	///
+	/// \brief Records a date received in the open epoch
+	///
+	void SetDate(int nYear, int nMonth, int nDay);
+
+	///
+	/// \brief Takes the position of a sentence if no better ranked sentence supplied one
+	///
+	bool TakePosition(int nRank, CNMEAParserData::TALKER_ID_E nTalkerID);
+
+	///
+	/// \brief Adds the PRNs of one GSA sentence to the active satellites, without duplicates
+	///
+	void AddActivePRNs(const int *pnPRN, int nCount);
+
+	///
+	/// \brief Adds the satellites in view of a GSV talker once per epoch
+	///
+	void AddSkyView(CNMEAParserData::TALKER_ID_E nTalkerID, const CNMEAParserData::GSV_DATA_T &gsvData);
+};
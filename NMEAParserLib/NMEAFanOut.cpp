@@ -0,0 +1,148 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include <stdio.h>
+#include <string.h>
+#include "NMEAFanOut.h"
+#include "NMEAParser.h"
+#include "NMEAScan.h"
+
+namespace {
+
+///
+/// \brief Appends "*CS\r\n" for the sentence body pBuffer[1..uLength), returns the new length
+///
+size_t AppendChecksum(char *pBuffer, size_t uLength)
+{
+	static const char c_pHex[] = "0123456789ABCDEF";
+	uint8_t u8Checksum = CNMEAScan::XorReduce(&pBuffer[1], uLength - 1);
+	pBuffer[uLength++] = '*';
+	pBuffer[uLength++] = c_pHex[u8Checksum >> 4];
+	pBuffer[uLength++] = c_pHex[u8Checksum & 0x0F];
+	pBuffer[uLength++] = '\r';
+	pBuffer[uLength++] = '\n';
+	return uLength;
+}
+
+}
+
+CNMEAFanOut::CNMEAFanOut(size_t uCapacity) :
+	m_Ring(uCapacity),
+	m_pParser(NULL),
+	m_uRawID(0),
+	m_uFixID(0)
+{
+}
+
+CNMEAFanOut::~CNMEAFanOut()
+{
+	Detach();
+}
+
+void CNMEAFanOut::Attach(CNMEAParser & parser)
+{
+	Detach();
+	m_pParser = &parser;
+	m_uRawID = parser.SubscribeRaw([this](const CNMEAParserData::SENTENCE_T &sentence) {
+		PublishSentence(sentence.pCmd, sentence.pData);
+	});
+	m_uFixID = parser.SubscribeFix([this](const CNMEAEpochAssembler::FIX_PTR_T &pFix) {
+		PublishFix(*pFix);
+	});
+}
+
+void CNMEAFanOut::Detach(void)
+{
+	if (m_pParser != NULL)
+	{
+		m_pParser->Unsubscribe(m_uRawID);
+		m_pParser->Unsubscribe(m_uFixID);
+		m_pParser = NULL;
+	}
+}
+
+void CNMEAFanOut::PublishSentence(const char * pCmd, const char * pData)
+{
+	char pBuffer[CNMEAParserData::c_uMaxCmdLen + CNMEAParserData::c_uMaxDataLen + 8];
+	size_t uCmdLen = strlen(pCmd);
+	size_t uDataLen = strlen(pData);
+	if (uCmdLen >= CNMEAParserData::c_uMaxCmdLen || uDataLen >= CNMEAParserData::c_uMaxDataLen)
+	{
+		return;
+	}
+
+	size_t uLength = 0;
+	pBuffer[uLength++] = '$';
+	memcpy(&pBuffer[uLength], pCmd, uCmdLen);
+	uLength += uCmdLen;
+	if (uDataLen != 0)
+	{
+		pBuffer[uLength++] = ',';
+		memcpy(&pBuffer[uLength], pData, uDataLen);
+		uLength += uDataLen;
+	}
+	uLength = AppendChecksum(pBuffer, uLength);
+	m_Ring.Write(RECORD_RAW, pBuffer, uLength);
+}
+
+void CNMEAFanOut::PublishFix(const CNMEAParserData::FIX_RECORD_T & fix)
+{
+	char pBuffer[c_uMaxFixLen];
+	size_t uLength = FormatFix(fix, pBuffer, sizeof(pBuffer));
+	if (uLength != 0)
+	{
+		m_Ring.Write(RECORD_FIX, pBuffer, uLength);
+	}
+}
+
+size_t CNMEAFanOut::FormatFix(const CNMEAParserData::FIX_RECORD_T & fix, char * pBuffer, size_t uBufferSize)
+{
+	char pDate[12] = "";
+	if (fix.m_uContentMask & CNMEAParserData::FIX_HAS_DATE)
+	{
+		snprintf(pDate, sizeof(pDate), "%02d%02d%02d", fix.m_nDay % 100, fix.m_nMonth % 100, fix.m_nYear % 100);
+	}
+
+	int nLength = snprintf(pBuffer, uBufferSize, "$PGSFX,%u,%02d%02d%06.3f,%s,%.8f,%.8f,%.3f,%d,%d,%d,%d,%.2f,%.3f,%.2f",
+		fix.m_uEpoch,
+		fix.m_nHour, fix.m_nMinute, fix.m_dSecond,
+		pDate,
+		fix.m_dLatitude, fix.m_dLongitude, fix.m_dAltitudeMSL,
+		(int)fix.m_nGPSQuality, (int)fix.m_nFixMode,
+		fix.m_nSatsUsed, fix.m_nSatsInView,
+		fix.m_dHDOP,
+		fix.m_dSpeedKnots * 0.514444,
+		fix.m_dTrackAngle);
+
+	//
+	// Leave room for "*CS\r\n" and the terminator
+	//
+	if (nLength < 0 || (size_t)nLength + 6 > uBufferSize)
+	{
+		return 0;
+	}
+	size_t uLength = AppendChecksum(pBuffer, (size_t)nLength);
+	pBuffer[uLength] = '\0';
+	return uLength;
+}
@@ -0,0 +1,110 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include "NMEAFanOutRing.h"
+#include "NMEAParserData.h"
+
+class CNMEAParser;
+
+///
+/// \class CNMEAFanOut
+/// \brief Publishes raw sentences and compact fix records of one parser into a CNMEAFanOutRing
+///
+/// The parser side only formats into a stack buffer and appends to the ring; it never
+/// waits for a client. Clients (see FanOutServer) read the ring with their own cursors
+/// and record type mask.
+///
+/// Fix records are one proprietary sentence per epoch, valid NMEA so they pass through
+/// any NMEA tool:
+///
+/// $PGSFX,epoch,hhmmss.sss,ddmmyy,lat,lon,altMSL,quality,mode,used,inview,hdop,speed,track*CS
+///
+/// lat/lon in signed decimal degrees, altitude in meters, speed in m/s, track in degrees.
+///
+class CNMEAFanOut
+{
+public:
+	///
+	/// Record types written to the ring
+	///
+	enum RECORD_TYPE_E {
+		RECORD_RAW = 0,															///< Raw sentence as received, "$...*CS\r\n"
+		RECORD_FIX = 1,															///< $PGSFX fix record
+	};
+
+	static const uint32_t			c_uMaskRaw = 1u << RECORD_RAW;				///< Read() mask for raw sentences
+	static const uint32_t			c_uMaskFix = 1u << RECORD_FIX;				///< Read() mask for fix records
+	static const size_t				c_uMaxFixLen = 160;							///< Longest $PGSFX sentence
+
+private:
+	CNMEAFanOutRing					m_Ring;										///< Shared ring
+	CNMEAParser						*m_pParser;									///< Attached parser, NULL if none
+	uint32_t						m_uRawID;									///< Raw sentence subscription
+	uint32_t						m_uFixID;									///< Fix record subscription
+
+public:
+	///
+	/// \param uCapacity Ring size in bytes, see CNMEAFanOutRing
+	///
+	explicit CNMEAFanOut(size_t uCapacity = CNMEAFanOutRing::c_uDefaultCapacity);
+	virtual ~CNMEAFanOut();
+
+	///
+	/// \brief Subscribes to the raw sentences and fix records of parser
+	///
+	/// parser must outlive this object or be detached first.
+	///
+	void Attach(CNMEAParser &parser);
+
+	///
+	/// \brief Removes the subscriptions of Attach()
+	///
+	void Detach(void);
+
+	///
+	/// \brief Appends one raw sentence, rebuilt as "$cmd,data*CS\r\n"
+	///
+	void PublishSentence(const char *pCmd, const char *pData);
+
+	///
+	/// \brief Appends one fix record
+	///
+	void PublishFix(const CNMEAParserData::FIX_RECORD_T &fix);
+
+	///
+	/// \brief Formats fix as a $PGSFX sentence including "\r\n"
+	///
+	/// \param fix Fix record
+	/// \param pBuffer Buffer to receive the sentence, null terminated
+	/// \param uBufferSize Size of pBuffer, c_uMaxFixLen is enough
+	/// \return Sentence length, 0 if it did not fit
+	///
+	static size_t FormatFix(const CNMEAParserData::FIX_RECORD_T &fix, char *pBuffer, size_t uBufferSize);
+
+	///
+	/// \brief Returns the ring clients read from
+	///
+	const CNMEAFanOutRing &GetRing(void) const { return m_Ring; }
+};
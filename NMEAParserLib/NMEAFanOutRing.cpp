@@ -0,0 +1,152 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include <string.h>
+#include "NMEAFanOutRing.h"
+
+CNMEAFanOutRing::CNMEAFanOutRing(size_t uCapacity) :
+	m_uMask(0),
+	m_uHead(0),
+	m_uReserve(0)
+{
+	size_t uSize = 64;
+	while (uSize < uCapacity)
+	{
+		uSize <<= 1;
+	}
+	m_vBuffer.resize(uSize);
+	m_uMask = uSize - 1;
+}
+
+bool CNMEAFanOutRing::Write(uint8_t uType, const char * pData, size_t uLength)
+{
+	if (uLength > c_uMaxRecordLen || uLength + c_uRecordHeaderLen > m_vBuffer.size())
+	{
+		return false;
+	}
+
+	char pHeader[c_uRecordHeaderLen];
+	pHeader[0] = (char)(uLength & 0xFF);
+	pHeader[1] = (char)(uLength >> 8);
+	pHeader[2] = (char)uType;
+	pHeader[3] = 0;
+
+	//
+	// Announce the bytes about to be overwritten before touching them
+	//
+	uint64_t uHead = m_uHead.load(std::memory_order_relaxed);
+	uint64_t uEnd = uHead + c_uRecordHeaderLen + uLength;
+	m_uReserve.store(uEnd, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	const char *pParts[2] = { pHeader, pData };
+	size_t puLengths[2] = { c_uRecordHeaderLen, uLength };
+	uint64_t uPosition = uHead;
+	for (int p = 0; p < 2; p++)
+	{
+		size_t uOffset = (size_t)(uPosition & m_uMask);
+		size_t uFirst = m_vBuffer.size() - uOffset;
+		if (uFirst >= puLengths[p])
+		{
+			memcpy(&m_vBuffer[uOffset], pParts[p], puLengths[p]);
+		}
+		else
+		{
+			memcpy(&m_vBuffer[uOffset], pParts[p], uFirst);
+			memcpy(&m_vBuffer[0], pParts[p] + uFirst, puLengths[p] - uFirst);
+		}
+		uPosition += puLengths[p];
+	}
+
+	m_uHead.store(uEnd, std::memory_order_release);
+	return true;
+}
+
+size_t CNMEAFanOutRing::Read(uint64_t & uCursor, uint32_t uTypeMask, char * pBuffer, size_t uBufferSize, uint64_t & uSkipped) const
+{
+	size_t uCopied = 0;
+	uSkipped = 0;
+	uint64_t uHead = m_uHead.load(std::memory_order_acquire);
+
+	while (uCursor < uHead)
+	{
+		//
+		// Copy the record, then make sure the writer did not reach it meanwhile
+		//
+		char pHeader[c_uRecordHeaderLen];
+		CopyOut(uCursor, pHeader, c_uRecordHeaderLen);
+		size_t uLength = (size_t)(uint8_t)pHeader[0] | ((size_t)(uint8_t)pHeader[1] << 8);
+		uint8_t uType = (uint8_t)pHeader[2];
+		bool bWanted = uType < 32 && (uTypeMask & (1u << uType)) != 0;
+		bool bFits = uLength <= uBufferSize - uCopied;
+
+		//
+		// A lapped reader can see a torn header; a record longer than the ring is one,
+		// and its length must not reach CopyOut()
+		//
+		bool bTorn = uLength + c_uRecordHeaderLen > m_vBuffer.size();
+		if (bWanted && bFits && bTorn == false)
+		{
+			CopyOut(uCursor + c_uRecordHeaderLen, pBuffer + uCopied, uLength);
+		}
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (bTorn || m_uReserve.load(std::memory_order_relaxed) > uCursor + m_vBuffer.size())
+		{
+			//
+			// Overwritten, this reader is too slow: skip ahead to live data
+			//
+			uint64_t uLive = m_uHead.load(std::memory_order_acquire);
+			uSkipped += uLive - uCursor;
+			uCursor = uLive;
+			break;
+		}
+
+		if (bWanted)
+		{
+			if (bFits == false)
+			{
+				break;
+			}
+			uCopied += uLength;
+		}
+		uCursor += c_uRecordHeaderLen + uLength;
+	}
+	return uCopied;
+}
+
+void CNMEAFanOutRing::CopyOut(uint64_t uPosition, char * pDest, size_t uLength) const
+{
+	size_t uOffset = (size_t)(uPosition & m_uMask);
+	size_t uFirst = m_vBuffer.size() - uOffset;
+	if (uFirst >= uLength)
+	{
+		memcpy(pDest, &m_vBuffer[uOffset], uLength);
+	}
+	else
+	{
+		memcpy(pDest, &m_vBuffer[uOffset], uFirst);
+		memcpy(pDest + uFirst, &m_vBuffer[0], uLength - uFirst);
+	}
+}
@@ -0,0 +1,102 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+
+///
+/// \class CNMEAFanOutRing
+/// \brief Single writer, many reader ring of records. Readers keep their own cursor.
+///
+/// The writer (the parser thread) appends records and never waits: it does not know how
+/// many readers there are or where they are. Each reader keeps a cursor, a byte position
+/// that only grows, and copies the records between its cursor and the head with Read().
+///
+/// A reader that falls more than the ring capacity behind has lost data. Read() detects
+/// this, also when the writer overwrites a record while it is being copied (the same
+/// sequence check as CNMEASnapshot), drops the partial record and moves the cursor to the
+/// head: the reader skips ahead to live data instead of holding up anybody.
+///
+class CNMEAFanOutRing
+{
+public:
+	static const size_t				c_uDefaultCapacity = 1u << 20;				///< Default capacity (1 MiB)
+	static const size_t				c_uRecordHeaderLen = 4;						///< Length (2 bytes), type, spare
+	static const size_t				c_uMaxRecordLen = 0xFFFF;					///< Longest record payload
+
+private:
+	std::vector<char>				m_vBuffer;									///< Record storage, a power of two in size
+	size_t							m_uMask;									///< Capacity - 1
+	std::atomic<uint64_t>			m_uHead;									///< End of the last complete record
+	std::atomic<uint64_t>			m_uReserve;									///< End of the record being written, readers must not trust bytes before m_uReserve - capacity
+
+public:
+	///
+	/// \param uCapacity Ring size in bytes, rounded up to a power of two
+	///
+	explicit CNMEAFanOutRing(size_t uCapacity = c_uDefaultCapacity);
+
+	///
+	/// \brief Appends a record. Only one thread may write.
+	///
+	/// \param uType Record type, 0 to 31 (readers filter on 1 << uType)
+	/// \param pData Payload
+	/// \param uLength Payload length, at most c_uMaxRecordLen and less than the capacity
+	/// \return false if the record is too long
+	///
+	bool Write(uint8_t uType, const char *pData, size_t uLength);
+
+	///
+	/// \brief Returns the current head, the cursor of a reader that wants live data only
+	///
+	uint64_t GetHead(void) const { return m_uHead.load(std::memory_order_acquire); }
+
+	///
+	/// \brief Returns the ring capacity in bytes
+	///
+	size_t GetCapacity(void) const { return m_vBuffer.size(); }
+
+	///
+	/// \brief Copies the payloads of the records after uCursor, concatenated
+	///
+	/// Stops at the head, or before the first record that does not fit into pBuffer.
+	///
+	/// \param uCursor Reader cursor, moved past the records read or skipped
+	/// \param uTypeMask Records to copy, bit (1 << type). Other records are passed over.
+	/// \param pBuffer Buffer to receive the payloads
+	/// \param uBufferSize Size of pBuffer, at least c_uMaxRecordLen to never stall on a long record
+	/// \param uSkipped Returned number of bytes the cursor skipped because they were overwritten
+	/// \return Number of bytes copied into pBuffer
+	///
+	size_t Read(uint64_t &uCursor, uint32_t uTypeMask, char *pBuffer, size_t uBufferSize, uint64_t &uSkipped) const;
+
+private:
+	///
+	/// \brief Copies uLength bytes at ring position uPosition, wrapping as needed
+	///
+	void CopyOut(uint64_t uPosition, char *pDest, size_t uLength) const;
+};
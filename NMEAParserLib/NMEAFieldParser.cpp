@@ -0,0 +1,308 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include <stdlib.h>
+#include <string.h>
+#include "NMEAFieldParser.h"
+
+namespace {
+
+	const int		c_nMaxFastDigits = 15;										///< Significant digits that always fit in a double mantissa
+	const size_t	c_uMaxSlowField = 64;										///< Largest field handed to the strtod fallback
+
+	const double	c_pdPow10[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+	};																			///< Powers of ten that are exact in a double
+
+	const int64_t	c_pnPow10[] = {
+		1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL, 1000000000LL,
+	};
+
+	///
+	/// \brief Decimal number split into its digits. "-12.0340" -> bNegative, uMantissa = 120340, nDecimals = 4
+	///
+	typedef struct _DECIMAL_T {
+		bool		bNegative;													///< Leading '-'
+		uint64_t	uMantissa;													///< All digits, without the decimal point
+		int			nDigits;													///< Significant digits in uMantissa (leading zeros excluded)
+		int			nDecimals;													///< Digits after the decimal point
+	} DECIMAL_T;
+
+	///
+	/// \brief Splits a decimal field. Fails on anything that is not [+-]digits[.digits].
+	///
+	bool SplitDecimal(const char *pField, size_t uLength, DECIMAL_T &dec)
+	{
+		size_t i = 0;
+		dec.bNegative = false;
+		dec.uMantissa = 0;
+		dec.nDigits = 0;
+		dec.nDecimals = 0;
+
+		if (pField == NULL || uLength == 0)
+		{
+			return false;
+		}
+
+		if (pField[0] == '-' || pField[0] == '+')
+		{
+			dec.bNegative = (pField[0] == '-');
+			i++;
+		}
+
+		bool bPoint = false;
+		bool bAnyDigit = false;
+		for (; i < uLength; i++)
+		{
+			char c = pField[i];
+			if (c >= '0' && c <= '9')
+			{
+				bAnyDigit = true;
+				if (dec.nDigits < 19)
+				{
+					dec.uMantissa = dec.uMantissa * 10 + (uint64_t)(c - '0');
+					if (dec.uMantissa != 0)
+					{
+						dec.nDigits++;
+					}
+					if (bPoint)
+					{
+						dec.nDecimals++;
+					}
+				}
+				else
+				{
+					//
+					// Too many digits to hold, flag it so the caller takes the slow path
+					//
+					dec.nDigits = 20;
+				}
+			}
+			else if (c == '.' && bPoint == false)
+			{
+				bPoint = true;
+			}
+			else
+			{
+				return false;
+			}
+		}
+		return bAnyDigit;
+	}
+}
+
+CNMEAParserData::ERROR_E CNMEAFieldParser::ParseInt(const char * pField, size_t uLength, int & nValue)
+{
+	if (pField == NULL || uLength == 0)
+	{
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	size_t i = 0;
+	bool bNegative = false;
+	if (pField[0] == '-' || pField[0] == '+')
+	{
+		bNegative = (pField[0] == '-');
+		i++;
+	}
+	if (i == uLength)
+	{
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	int64_t nResult = 0;
+	for (; i < uLength; i++)
+	{
+		char c = pField[i];
+		if (c < '0' || c > '9')
+		{
+			return CNMEAParserData::ERROR_FAIL;
+		}
+		nResult = nResult * 10 + (c - '0');
+		if (nResult > 0x80000000LL)
+		{
+			return CNMEAParserData::ERROR_FAIL;
+		}
+	}
+
+	if (bNegative)
+	{
+		nResult = -nResult;
+	}
+	if (nResult > 0x7FFFFFFFLL)
+	{
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	nValue = (int)nResult;
+	return CNMEAParserData::ERROR_OK;
+}
+
+CNMEAParserData::ERROR_E CNMEAFieldParser::ParseFixed(const char * pField, size_t uLength, int nDecimals, int64_t & nValue)
+{
+	DECIMAL_T dec;
+	if (nDecimals < 0 || nDecimals > 9 || SplitDecimal(pField, uLength, dec) == false || dec.nDigits > 18)
+	{
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	int64_t nResult = (int64_t)dec.uMantissa;
+	if (dec.nDecimals > nDecimals)
+	{
+		//
+		// Drop the extra decimals, rounding half away from zero
+		//
+		int nDrop = dec.nDecimals - nDecimals;
+		if (nDrop > 18)
+		{
+			nResult = 0;
+		}
+		else
+		{
+			int64_t nDiv = 1;
+			for (int i = 0; i < nDrop; i++)
+			{
+				nDiv *= 10;
+			}
+			nResult = (nResult + nDiv / 2) / nDiv;
+		}
+	}
+	else
+	{
+		//
+		// Scale up, checking for overflow
+		//
+		for (int i = dec.nDecimals; i < nDecimals; i++)
+		{
+			if (nResult > INT64_MAX / 10)
+			{
+				return CNMEAParserData::ERROR_FAIL;
+			}
+			nResult *= 10;
+		}
+	}
+
+	nValue = dec.bNegative ? -nResult : nResult;
+	return CNMEAParserData::ERROR_OK;
+}
+
+CNMEAParserData::ERROR_E CNMEAFieldParser::ParseDouble(const char * pField, size_t uLength, double & dValue)
+{
+	DECIMAL_T dec;
+	if (SplitDecimal(pField, uLength, dec) == false)
+	{
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	//
+	// Fast path: the mantissa and the power of ten are both exact doubles, so a single
+	// division gives the correctly rounded result, same as strtod.
+	//
+	if (dec.nDigits <= c_nMaxFastDigits && dec.nDecimals <= 22)
+	{
+		double dResult = (double)dec.uMantissa / c_pdPow10[dec.nDecimals];
+		dValue = dec.bNegative ? -dResult : dResult;
+		return CNMEAParserData::ERROR_OK;
+	}
+
+	//
+	// Slow path for very long fields. The field was validated above, so the only locale
+	// sensitive character is the decimal point.
+	//
+	if (uLength >= c_uMaxSlowField)
+	{
+		return CNMEAParserData::ERROR_FAIL;
+	}
+	char szField[c_uMaxSlowField];
+	memcpy(szField, pField, uLength);
+	szField[uLength] = '\0';
+	dValue = strtod(szField, NULL);
+	return CNMEAParserData::ERROR_OK;
+}
+
+CNMEAParserData::ERROR_E CNMEAFieldParser::ParseCoordinate(const char * pField, size_t uLength, int nDegreeDigits, int64_t & nNanoDegrees)
+{
+	if (pField == NULL || nDegreeDigits < 1 || uLength <= (size_t)nDegreeDigits)
+	{
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	int64_t nDegrees = 0;
+	for (int i = 0; i < nDegreeDigits; i++)
+	{
+		char c = pField[i];
+		if (c < '0' || c > '9')
+		{
+			return CNMEAParserData::ERROR_FAIL;
+		}
+		nDegrees = nDegrees * 10 + (c - '0');
+	}
+
+	//
+	// Minutes scaled to 10^-9 minute, then converted to nano-degrees (1 degree = 60 minutes)
+	//
+	int64_t nNanoMinutes = 0;
+	if (pField[nDegreeDigits] == '-' || pField[nDegreeDigits] == '+' ||
+		ParseFixed(pField + nDegreeDigits, uLength - nDegreeDigits, 9, nNanoMinutes) != CNMEAParserData::ERROR_OK)
+	{
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	nNanoDegrees = nDegrees * c_pnPow10[9] + (nNanoMinutes + 30) / 60;
+	return CNMEAParserData::ERROR_OK;
+}
+
+CNMEAParserData::ERROR_E CNMEAFieldParser::ParseCoordinate(const char * pField, size_t uLength, int nDegreeDigits, double & dDegrees)
+{
+	if (pField == NULL || nDegreeDigits < 1 || uLength <= (size_t)nDegreeDigits)
+	{
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	int nDegrees = 0;
+	for (int i = 0; i < nDegreeDigits; i++)
+	{
+		char c = pField[i];
+		if (c < '0' || c > '9')
+		{
+			return CNMEAParserData::ERROR_FAIL;
+		}
+		nDegrees = nDegrees * 10 + (c - '0');
+	}
+
+	double dMinutes = 0.0;
+	if (pField[nDegreeDigits] == '-' || pField[nDegreeDigits] == '+' ||
+		ParseDouble(pField + nDegreeDigits, uLength - nDegreeDigits, dMinutes) != CNMEAParserData::ERROR_OK)
+	{
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	//
+	// Same operation order as the original atof based conversion
+	//
+	dDegrees = dMinutes / 60.0;
+	dDegrees += (double)nDegrees;
+	return CNMEAParserData::ERROR_OK;
+}
@@ -0,0 +1,101 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include "NMEAParserData.h"
+
+///
+/// \brief Allocation free, locale independent conversions for NMEA numeric fields.
+///
+/// Every function takes a field that is not null terminated (pointer and length, as
+/// returned by CNMEASentenceFields) and leaves the result untouched if the field is
+/// not a well formed number. Nothing is written into the sentence data.
+///
+/// ParseDouble() produces the same bits as atof() in the "C" locale: decimal fields with
+/// up to 15 significant digits are converted with a single exact division (both operands
+/// are representable, so the quotient is correctly rounded like strtod). Longer fields fall
+/// back to strtod on a stack copy.
+///
+namespace CNMEAFieldParser {
+
+	///
+	/// \brief Strict integer. Optional sign followed by at least one digit and nothing else.
+	///
+	/// \param pField Pointer to the field
+	/// \param uLength Number of characters in the field
+	/// \param nValue Returned value
+	/// \return ERROR_OK if successful, ERROR_FAIL if the field is empty, not an integer or out of range
+	///
+	CNMEAParserData::ERROR_E ParseInt(const char *pField, size_t uLength, int &nValue);
+
+	///
+	/// \brief Fixed point decimal, ie: "12.345" with nDecimals = 2 returns 1235.
+	///
+	/// Digits past nDecimals are rounded half away from zero.
+	///
+	/// \param pField Pointer to the field
+	/// \param uLength Number of characters in the field
+	/// \param nDecimals Number of decimals kept in the result (0 - 9)
+	/// \param nValue Returned value scaled by 10^nDecimals
+	/// \return ERROR_OK if successful, ERROR_FAIL if the field is not a decimal number or out of range
+	///
+	CNMEAParserData::ERROR_E ParseFixed(const char *pField, size_t uLength, int nDecimals, int64_t &nValue);
+
+	///
+	/// \brief Decimal number as a double, bit identical to atof() for well formed fields.
+	///
+	/// \param pField Pointer to the field
+	/// \param uLength Number of characters in the field
+	/// \param dValue Returned value
+	/// \return ERROR_OK if successful, ERROR_FAIL if the field is not a decimal number
+	///
+	CNMEAParserData::ERROR_E ParseDouble(const char *pField, size_t uLength, double &dValue);
+
+	///
+	/// \brief NMEA coordinate (d)ddmm.mmmmm in integer nano-degrees
+	///
+	/// \param pField Pointer to the field
+	/// \param uLength Number of characters in the field
+	/// \param nDegreeDigits Number of degree digits, 2 for latitude and 3 for longitude
+	/// \param nNanoDegrees Returned coordinate, rounded to the nearest nano-degree (unsigned, apply the hemisphere separately)
+	/// \return ERROR_OK if successful, ERROR_FAIL if the field is malformed
+	///
+	CNMEAParserData::ERROR_E ParseCoordinate(const char *pField, size_t uLength, int nDegreeDigits, int64_t &nNanoDegrees);
+
+	///
+	/// \brief NMEA coordinate (d)ddmm.mmmmm in decimal degrees
+	///
+	/// The result is bit identical to the historical atof(minutes) / 60.0 + atof(degrees) conversion.
+	///
+	/// \param pField Pointer to the field
+	/// \param uLength Number of characters in the field
+	/// \param nDegreeDigits Number of degree digits, 2 for latitude and 3 for longitude
+	/// \param dDegrees Returned coordinate (unsigned, apply the hemisphere separately)
+	/// \return ERROR_OK if successful, ERROR_FAIL if the field is malformed
+	///
+	CNMEAParserData::ERROR_E ParseCoordinate(const char *pField, size_t uLength, int nDegreeDigits, double &dDegrees);
+};
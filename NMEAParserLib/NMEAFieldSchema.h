@@ -0,0 +1,195 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include "NMEAParserData.h"
+#include "NMEASentenceFields.h"
+#include "NMEAFieldParser.h"
+
+///
+/// \brief Compile time field schemas for NMEA sentence decoders.
+///
+/// A schema lists the fields of a sentence as types: the field index, how the field is
+/// converted and which member of the sentence data structure receives it. Decode() expands
+/// the list into one inlined conversion per field, so there is nothing to interpret at run
+/// time and the generated code is the same as a hand written chain of CNMEASentenceFields
+/// calls.
+///
+///	typedef CNMEAFieldSchema::Fields<
+///		CNMEAFieldSchema::Double<CNMEAParserData::HDT_DATA_T, 0, &CNMEAParserData::HDT_DATA_T::m_dHeading>
+///	> HDT_SCHEMA_T;
+///
+///	CNMEAFieldSchema::Decode<HDT_SCHEMA_T>(Fields, m_SentenceData);
+///
+/// A member is only written when its field is present and well formed, otherwise it keeps
+/// its value (CNMEASchemaSentence clears the data before decoding, hand written decoders
+/// such as CNMEASentenceGGA keep the last received value).
+///
+namespace CNMEAFieldSchema {
+
+	///
+	/// \brief Integer field
+	///
+	template <class DATA, int nField, int DATA::*pMember>
+	struct Int {
+		static void Decode(const CNMEASentenceFields &Fields, DATA &data) {
+			Fields.GetInt(nField, data.*pMember);
+		}
+	};
+
+	///
+	/// \brief Decimal field
+	///
+	template <class DATA, int nField, double DATA::*pMember>
+	struct Double {
+		static void Decode(const CNMEASentenceFields &Fields, DATA &data) {
+			Fields.GetDouble(nField, data.*pMember);
+		}
+	};
+
+	///
+	/// \brief Decimal field converted to another unit, member = field * nNumerator / nDenominator
+	///
+	template <class DATA, int nField, double DATA::*pMember, int nNumerator, int nDenominator>
+	struct Scaled {
+		static void Decode(const CNMEASentenceFields &Fields, DATA &data) {
+			double dValue;
+			if (Fields.GetDouble(nField, dValue) == CNMEAParserData::ERROR_OK) {
+				data.*pMember = dValue * ((double)nNumerator / (double)nDenominator);
+			}
+		}
+	};
+
+	///
+	/// \brief Single character field stored as T, ie: a status or mode enumeration
+	///
+	template <class DATA, int nField, typename T, T DATA::*pMember>
+	struct Char {
+		static void Decode(const CNMEASentenceFields &Fields, DATA &data) {
+			if (Fields.IsValid(nField)) {
+				data.*pMember = (T)Fields.GetChar(nField);
+			}
+		}
+	};
+
+	///
+	/// \brief Single digit field stored as T, ie: GGA GPS quality
+	///
+	template <class DATA, int nField, typename T, T DATA::*pMember>
+	struct Digit {
+		static void Decode(const CNMEASentenceFields &Fields, DATA &data) {
+			char chDigit = Fields.GetChar(nField);
+			if (chDigit >= '0' && chDigit <= '9') {
+				data.*pMember = (T)(chDigit - '0');
+			}
+		}
+	};
+
+	///
+	/// \brief (d)ddmm.mmmmm coordinate in decimal degrees followed by its hemisphere field (N/S or E/W)
+	///
+	/// \tparam nDegreeDigits 2 for latitude, 3 for longitude
+	///
+	template <class DATA, int nField, int nDegreeDigits, double DATA::*pMember>
+	struct Coordinate {
+		static void Decode(const CNMEASentenceFields &Fields, DATA &data) {
+			if (Fields.GetCoordinate(nField, nDegreeDigits, data.*pMember) == CNMEAParserData::ERROR_OK) {
+				char chHemisphere = Fields.GetChar(nField + 1);
+				if (chHemisphere == 'S' || chHemisphere == 'W') {
+					data.*pMember = -(data.*pMember);
+				}
+			}
+		}
+	};
+
+	///
+	/// \brief Two digit value at a character offset within a field, ie: the minutes of hhmmss
+	///
+	template <class DATA, int nField, int nOffset, int DATA::*pMember>
+	struct TwoDigits {
+		static void Decode(const CNMEASentenceFields &Fields, DATA &data) {
+			if (Fields.GetLength(nField) >= (size_t)(nOffset + 2)) {
+				const char *pField = Fields.GetField(nField) + nOffset;
+				if (pField[0] >= '0' && pField[0] <= '9' && pField[1] >= '0' && pField[1] <= '9') {
+					data.*pMember = (pField[0] - '0') * 10 + (pField[1] - '0');
+				}
+			}
+		}
+	};
+
+	///
+	/// \brief Decimal value starting at a character offset within a field, ie: the seconds of hhmmss.ss
+	///
+	template <class DATA, int nField, int nOffset, double DATA::*pMember>
+	struct DoubleAt {
+		static void Decode(const CNMEASentenceFields &Fields, DATA &data) {
+			size_t uLength = Fields.GetLength(nField);
+			if (uLength > (size_t)nOffset) {
+				CNMEAFieldParser::ParseDouble(Fields.GetField(nField) + nOffset, uLength - nOffset, data.*pMember);
+			}
+		}
+	};
+
+	///
+	/// \brief List of fields, decoded in order
+	///
+	template <class... FIELDS>
+	struct Fields;
+
+	template <>
+	struct Fields<> {
+		template <class DATA>
+		static void Decode(const CNMEASentenceFields &, DATA &) {}
+	};
+
+	template <class FIELD, class... FIELDS>
+	struct Fields<FIELD, FIELDS...> {
+		template <class DATA>
+		static void Decode(const CNMEASentenceFields &Fields, DATA &data) {
+			FIELD::Decode(Fields, data);
+			CNMEAFieldSchema::Fields<FIELDS...>::Decode(Fields, data);
+		}
+	};
+
+	///
+	/// \brief UTC time hhmmss.ss into m_nHour, m_nMinute, m_nSecond and m_dSecond (with the fraction)
+	///
+	template <class DATA, int nField>
+	struct Time : Fields<
+		TwoDigits<DATA, nField, 0, &DATA::m_nHour>,
+		TwoDigits<DATA, nField, 2, &DATA::m_nMinute>,
+		TwoDigits<DATA, nField, 4, &DATA::m_nSecond>,
+		DoubleAt<DATA, nField, 4, &DATA::m_dSecond> > {
+	};
+
+	///
+	/// \brief Decodes the sentence fields into data as described by SCHEMA
+	///
+	template <class SCHEMA, class DATA>
+	inline void Decode(const CNMEASentenceFields &Fields, DATA &data) {
+		SCHEMA::Decode(Fields, data);
+	}
+};
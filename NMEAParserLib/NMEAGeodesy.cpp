@@ -0,0 +1,662 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include <math.h>
+#include "NMEAGeodesy.h"
+#include "NMEAScan.h"
+
+#if defined(NMEA_SCAN_AVX2)
+#include <immintrin.h>
+#elif defined(NMEA_SCAN_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace {
+	static const double			c_dPi = 3.14159265358979323846;
+	static const double			c_dRadiansPerDegree = c_dPi / 180.0;
+	static const double			c_dDegreesPerRadian = 180.0 / c_dPi;
+	static const double			c_dWGS84A = 6378137.0;							///< Semi-major axis (meters)
+	static const double			c_dWGS84F = 1.0 / 298.257223563;				///< Flattening
+	static const double			c_dWGS84B = c_dWGS84A * (1.0 - c_dWGS84F);		///< Semi-minor axis (meters)
+	static const double			c_dWGS84E2 = c_dWGS84F * (2.0 - c_dWGS84F);	///< First eccentricity squared
+	static const double			c_dWGS84EP2 = c_dWGS84E2 / (1.0 - c_dWGS84E2);	///< Second eccentricity squared
+	static const double			c_dUTMScale = 0.9996;							///< Central meridian scale factor
+	static const double			c_dUTMFalseEasting = 500000.0;
+	static const double			c_dUTMFalseNorthingSouth = 10000000.0;
+
+	///////////////////////////////////////////////////////////////////////////
+	// Vector types. Every kernel below is written once against this interface
+	// and instantiated for the widest type the build supports plus the scalar
+	// type for the tail of the arrays.
+	///////////////////////////////////////////////////////////////////////////
+
+	struct CVecScalar {
+		double	v;
+		static const size_t c_uWidth = 1;
+		CVecScalar() {}
+		CVecScalar(double d) : v(d) {}
+		static CVecScalar Load(const double *p) { return CVecScalar(*p); }
+		void Store(double *p) const { *p = v; }
+	};
+	inline CVecScalar operator+(CVecScalar a, CVecScalar b) { return a.v + b.v; }
+	inline CVecScalar operator-(CVecScalar a, CVecScalar b) { return a.v - b.v; }
+	inline CVecScalar operator*(CVecScalar a, CVecScalar b) { return a.v * b.v; }
+	inline CVecScalar operator/(CVecScalar a, CVecScalar b) { return a.v / b.v; }
+	inline CVecScalar operator-(CVecScalar a) { return -a.v; }
+	inline CVecScalar Sqrt(CVecScalar a) { return sqrt(a.v); }
+	inline CVecScalar Abs(CVecScalar a) { return fabs(a.v); }
+	inline CVecScalar Min(CVecScalar a, CVecScalar b) { return a.v < b.v ? a.v : b.v; }
+	inline CVecScalar Max(CVecScalar a, CVecScalar b) { return a.v > b.v ? a.v : b.v; }
+	inline CVecScalar Trunc(CVecScalar a) { return (double)(int32_t)a.v; }
+	inline bool CmpLt(CVecScalar a, CVecScalar b) { return a.v < b.v; }
+	inline bool CmpGt(CVecScalar a, CVecScalar b) { return a.v > b.v; }
+	inline bool MaskAnd(bool a, bool b) { return a && b; }
+	inline CVecScalar Select(bool m, CVecScalar a, CVecScalar b) { return m ? a : b; }
+
+#if defined(NMEA_SCAN_AVX2)
+	struct CVecAVX2 {
+		__m256d	v;
+		static const size_t c_uWidth = 4;
+		CVecAVX2() {}
+		CVecAVX2(__m256d x) : v(x) {}
+		CVecAVX2(double d) : v(_mm256_set1_pd(d)) {}
+		static CVecAVX2 Load(const double *p) { return _mm256_loadu_pd(p); }
+		void Store(double *p) const { _mm256_storeu_pd(p, v); }
+	};
+	inline CVecAVX2 operator+(CVecAVX2 a, CVecAVX2 b) { return _mm256_add_pd(a.v, b.v); }
+	inline CVecAVX2 operator-(CVecAVX2 a, CVecAVX2 b) { return _mm256_sub_pd(a.v, b.v); }
+	inline CVecAVX2 operator*(CVecAVX2 a, CVecAVX2 b) { return _mm256_mul_pd(a.v, b.v); }
+	inline CVecAVX2 operator/(CVecAVX2 a, CVecAVX2 b) { return _mm256_div_pd(a.v, b.v); }
+	inline CVecAVX2 operator-(CVecAVX2 a) { return _mm256_xor_pd(a.v, _mm256_set1_pd(-0.0)); }
+	inline CVecAVX2 Sqrt(CVecAVX2 a) { return _mm256_sqrt_pd(a.v); }
+	inline CVecAVX2 Abs(CVecAVX2 a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v); }
+	inline CVecAVX2 Min(CVecAVX2 a, CVecAVX2 b) { return _mm256_min_pd(a.v, b.v); }
+	inline CVecAVX2 Max(CVecAVX2 a, CVecAVX2 b) { return _mm256_max_pd(a.v, b.v); }
+	inline CVecAVX2 Trunc(CVecAVX2 a) { return _mm256_round_pd(a.v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+	inline CVecAVX2 CmpLt(CVecAVX2 a, CVecAVX2 b) { return _mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ); }
+	inline CVecAVX2 CmpGt(CVecAVX2 a, CVecAVX2 b) { return _mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ); }
+	inline CVecAVX2 MaskAnd(CVecAVX2 a, CVecAVX2 b) { return _mm256_and_pd(a.v, b.v); }
+	inline CVecAVX2 Select(CVecAVX2 m, CVecAVX2 a, CVecAVX2 b) { return _mm256_blendv_pd(b.v, a.v, m.v); }
+	typedef CVecAVX2 CVecBest;
+#elif defined(NMEA_SCAN_SSE2)
+	struct CVecSSE2 {
+		__m128d	v;
+		static const size_t c_uWidth = 2;
+		CVecSSE2() {}
+		CVecSSE2(__m128d x) : v(x) {}
+		CVecSSE2(double d) : v(_mm_set1_pd(d)) {}
+		static CVecSSE2 Load(const double *p) { return _mm_loadu_pd(p); }
+		void Store(double *p) const { _mm_storeu_pd(p, v); }
+	};
+	inline CVecSSE2 operator+(CVecSSE2 a, CVecSSE2 b) { return _mm_add_pd(a.v, b.v); }
+	inline CVecSSE2 operator-(CVecSSE2 a, CVecSSE2 b) { return _mm_sub_pd(a.v, b.v); }
+	inline CVecSSE2 operator*(CVecSSE2 a, CVecSSE2 b) { return _mm_mul_pd(a.v, b.v); }
+	inline CVecSSE2 operator/(CVecSSE2 a, CVecSSE2 b) { return _mm_div_pd(a.v, b.v); }
+	inline CVecSSE2 operator-(CVecSSE2 a) { return _mm_xor_pd(a.v, _mm_set1_pd(-0.0)); }
+	inline CVecSSE2 Sqrt(CVecSSE2 a) { return _mm_sqrt_pd(a.v); }
+	inline CVecSSE2 Abs(CVecSSE2 a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a.v); }
+	inline CVecSSE2 Min(CVecSSE2 a, CVecSSE2 b) { return _mm_min_pd(a.v, b.v); }
+	inline CVecSSE2 Max(CVecSSE2 a, CVecSSE2 b) { return _mm_max_pd(a.v, b.v); }
+	inline CVecSSE2 Trunc(CVecSSE2 a) { return _mm_cvtepi32_pd(_mm_cvttpd_epi32(a.v)); }
+	inline CVecSSE2 CmpLt(CVecSSE2 a, CVecSSE2 b) { return _mm_cmplt_pd(a.v, b.v); }
+	inline CVecSSE2 CmpGt(CVecSSE2 a, CVecSSE2 b) { return _mm_cmpgt_pd(a.v, b.v); }
+	inline CVecSSE2 MaskAnd(CVecSSE2 a, CVecSSE2 b) { return _mm_and_pd(a.v, b.v); }
+	inline CVecSSE2 Select(CVecSSE2 m, CVecSSE2 a, CVecSSE2 b) { return _mm_or_pd(_mm_and_pd(m.v, a.v), _mm_andnot_pd(m.v, b.v)); }
+	typedef CVecSSE2 CVecBest;
+#else
+	typedef CVecScalar CVecBest;
+#endif
+
+	///////////////////////////////////////////////////////////////////////////
+	// Elementary functions (Cephes sin/cos and atan, double precision)
+	///////////////////////////////////////////////////////////////////////////
+
+	///
+	/// \brief Sine and cosine of x (radians, |x| < 2^30)
+	///
+	template <typename V>
+	inline void SinCos(V x, V &s, V &c)
+	{
+		static const double c_dDP1 = 7.85398125648498535156E-1;
+		static const double c_dDP2 = 3.77489470793079817668E-8;
+		static const double c_dDP3 = 2.69515142907905952645E-15;
+
+		V ax = Abs(x);
+		V y = Trunc(ax * (4.0 / c_dPi));
+		y = y + (y - Trunc(y * 0.5) * 2.0);					// round odd octants up
+		V z = ((ax - y * c_dDP1) - y * c_dDP2) - y * c_dDP3;
+		V zz = z * z;
+
+		V sinz = ((((( 1.58962301576546568060E-10 * zz
+			- 2.50507477628578072866E-8) * zz
+			+ 2.75573136213857245213E-6) * zz
+			- 1.98412698295895385996E-4) * zz
+			+ 8.33333333332211858878E-3) * zz
+			- 1.66666666666666307295E-1) * zz * z + z;
+		V cosz = (((((-1.13585365213876817300E-11 * zz
+			+ 2.08757008419747316778E-9) * zz
+			- 2.75573141792967388112E-7) * zz
+			+ 2.48015872888517045348E-5) * zz
+			- 1.38888888888730564116E-3) * zz
+			+ 4.16666666666665929218E-2) * zz * zz - zz * 0.5 + 1.0;
+
+		//
+		// Quadrant 0..3 selects and signs the results
+		//
+		V q = y * 0.5 - Trunc(y * 0.125) * 4.0;
+		auto mSwap = CmpGt(q - Trunc(q * 0.5) * 2.0, V(0.5));
+		auto mSinNeg = CmpGt(q, V(1.5));
+		auto mCosNeg = MaskAnd(CmpGt(q, V(0.5)), CmpLt(q, V(2.5)));
+
+		s = Select(mSwap, cosz, sinz);
+		s = Select(mSinNeg, -s, s);
+		s = Select(CmpLt(x, V(0.0)), -s, s);
+		c = Select(mSwap, sinz, cosz);
+		c = Select(mCosNeg, -c, c);
+	}
+
+	///
+	/// \brief Arc tangent of t, 0 <= t <= 1
+	///
+	template <typename V>
+	inline V AtanUnit(V t)
+	{
+		static const double c_dMoreBits = 6.123233995736765886130E-17;
+
+		auto mHigh = CmpGt(t, V(0.66));
+		V x = Select(mHigh, (t - 1.0) / (t + 1.0), t);
+		V z = x * x;
+		V p = ((((-8.750608600031904122785E-1 * z
+			- 1.615753718733365076637E1) * z
+			- 7.500855792314704667340E1) * z
+			- 1.228866684490136173410E2) * z
+			- 6.485021904942025371773E1);
+		V q = (((((z + 2.485846490142306297962E1) * z
+			+ 1.650270098316988542046E2) * z
+			+ 4.328810604912902668951E2) * z
+			+ 4.853903996359136964868E2) * z
+			+ 1.945506571482613964425E2);
+		z = x * (z * p / q) + x;
+		return Select(mHigh, (z + 0.5 * c_dMoreBits) + c_dPi / 4.0, z);
+	}
+
+	///
+	/// \brief Four quadrant arc tangent of y / x, 0 if both are 0
+	///
+	template <typename V>
+	inline V Atan2(V y, V x)
+	{
+		V ax = Abs(x);
+		V ay = Abs(y);
+		V mx = Max(ax, ay);
+		V t = Min(ax, ay) / Select(CmpGt(mx, V(0.0)), mx, V(1.0));
+		V r = AtanUnit(t);
+		r = Select(CmpGt(ay, ax), c_dPi / 2.0 - r, r);
+		r = Select(CmpLt(x, V(0.0)), c_dPi - r, r);
+		return Select(CmpLt(y, V(0.0)), -r, r);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Transformations, one vector of points
+	///////////////////////////////////////////////////////////////////////////
+
+	template <typename V>
+	inline void GeodeticToECEFV(V lat, V lon, V h, V &x, V &y, V &z)
+	{
+		V sLat, cLat, sLon, cLon;
+		SinCos(lat * c_dRadiansPerDegree, sLat, cLat);
+		SinCos(lon * c_dRadiansPerDegree, sLon, cLon);
+		V n = V(c_dWGS84A) / Sqrt(1.0 - c_dWGS84E2 * sLat * sLat);
+		V r = (n + h) * cLat;
+		x = r * cLon;
+		y = r * sLon;
+		z = (n * (1.0 - c_dWGS84E2) + h) * sLat;
+	}
+
+	template <typename V>
+	inline void ECEFToGeodeticV(V x, V y, V z, V &lat, V &lon, V &h)
+	{
+		V p = Sqrt(x * x + y * y);
+
+		//
+		// Bowring: latitude from the parametric latitude guess, then once more from the new latitude
+		//
+		V u = z * c_dWGS84A;
+		V w = p * c_dWGS84B;
+		V sLatN = z;
+		V cLatN = p;
+		for (int i = 0; i < 2; i++)
+		{
+			V rb = Sqrt(u * u + w * w);
+			rb = Select(CmpGt(rb, V(0.0)), rb, V(1.0));
+			V sBeta = u / rb;
+			V cBeta = w / rb;
+			sLatN = z + c_dWGS84EP2 * c_dWGS84B * sBeta * sBeta * sBeta;
+			cLatN = p - c_dWGS84E2 * c_dWGS84A * cBeta * cBeta * cBeta;
+			u = sLatN * (1.0 - c_dWGS84F);
+			w = cLatN;
+		}
+
+		V r = Sqrt(sLatN * sLatN + cLatN * cLatN);
+		r = Select(CmpGt(r, V(0.0)), r, V(1.0));
+		V sLat = sLatN / r;
+		V cLat = cLatN / r;
+		lat = Atan2(sLatN, cLatN) * c_dDegreesPerRadian;
+		lon = Atan2(y, x) * c_dDegreesPerRadian;
+		h = p * cLat + z * sLat - c_dWGS84A * Sqrt(1.0 - c_dWGS84E2 * sLat * sLat);
+	}
+
+	///
+	/// \brief Origin and rotation of a CNMEALocalFrame, copied out for the kernels
+	///
+	struct CFrame {
+		double	pdR[9];
+		double	pdO[3];
+		explicit CFrame(const CNMEAMatrix<3, 3> &rotation, const double *pdOrigin)
+		{
+			for (int i = 0; i < 9; i++)
+			{
+				pdR[i] = rotation(i / 3, i % 3);
+			}
+			for (int i = 0; i < 3; i++)
+			{
+				pdO[i] = pdOrigin[i];
+			}
+		}
+
+		template <typename V>
+		void ToENU(V x, V y, V z, V &e, V &n, V &u) const
+		{
+			V dx = x - pdO[0];
+			V dy = y - pdO[1];
+			V dz = z - pdO[2];
+			e = dx * pdR[0] + dy * pdR[1] + dz * pdR[2];
+			n = dx * pdR[3] + dy * pdR[4] + dz * pdR[5];
+			u = dx * pdR[6] + dy * pdR[7] + dz * pdR[8];
+		}
+
+		template <typename V>
+		void ToECEF(V e, V n, V u, V &x, V &y, V &z) const
+		{
+			x = e * pdR[0] + n * pdR[3] + u * pdR[6] + pdO[0];
+			y = e * pdR[1] + n * pdR[4] + u * pdR[7] + pdO[1];
+			z = e * pdR[2] + n * pdR[5] + u * pdR[8] + pdO[2];
+		}
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// Operations with three input and three output arrays
+	///////////////////////////////////////////////////////////////////////////
+
+	struct COpGeodeticToECEF {
+		template <typename V> void operator()(V a, V b, V c, V &x, V &y, V &z) const { GeodeticToECEFV(a, b, c, x, y, z); }
+	};
+
+	struct COpECEFToGeodetic {
+		template <typename V> void operator()(V a, V b, V c, V &x, V &y, V &z) const { ECEFToGeodeticV(a, b, c, x, y, z); }
+	};
+
+	struct COpECEFToENU {
+		CFrame	frame;
+		explicit COpECEFToENU(const CFrame &f) : frame(f) {}
+		template <typename V> void operator()(V a, V b, V c, V &x, V &y, V &z) const { frame.ToENU(a, b, c, x, y, z); }
+	};
+
+	struct COpENUToECEF {
+		CFrame	frame;
+		explicit COpENUToECEF(const CFrame &f) : frame(f) {}
+		template <typename V> void operator()(V a, V b, V c, V &x, V &y, V &z) const { frame.ToECEF(a, b, c, x, y, z); }
+	};
+
+	struct COpGeodeticToENU {
+		CFrame	frame;
+		explicit COpGeodeticToENU(const CFrame &f) : frame(f) {}
+		template <typename V> void operator()(V a, V b, V c, V &x, V &y, V &z) const
+		{
+			V ex, ey, ez;
+			GeodeticToECEFV(a, b, c, ex, ey, ez);
+			frame.ToENU(ex, ey, ez, x, y, z);
+		}
+	};
+
+	struct COpENUToGeodetic {
+		CFrame	frame;
+		explicit COpENUToGeodetic(const CFrame &f) : frame(f) {}
+		template <typename V> void operator()(V a, V b, V c, V &x, V &y, V &z) const
+		{
+			V ex, ey, ez;
+			frame.ToECEF(a, b, c, ex, ey, ez);
+			ECEFToGeodeticV(ex, ey, ez, x, y, z);
+		}
+	};
+
+	struct COpGeodeticToNED {
+		CFrame	frame;
+		explicit COpGeodeticToNED(const CFrame &f) : frame(f) {}
+		template <typename V> void operator()(V a, V b, V c, V &n, V &e, V &d) const
+		{
+			V ex, ey, ez, u;
+			GeodeticToECEFV(a, b, c, ex, ey, ez);
+			frame.ToENU(ex, ey, ez, e, n, u);
+			d = -u;
+		}
+	};
+
+	struct COpNEDToGeodetic {
+		CFrame	frame;
+		explicit COpNEDToGeodetic(const CFrame &f) : frame(f) {}
+		template <typename V> void operator()(V n, V e, V d, V &x, V &y, V &z) const
+		{
+			V ex, ey, ez;
+			frame.ToECEF(e, n, -d, ex, ey, ez);
+			ECEFToGeodeticV(ex, ey, ez, x, y, z);
+		}
+	};
+
+	struct COpGeodeticToPolar {
+		CFrame	frame;
+		explicit COpGeodeticToPolar(const CFrame &f) : frame(f) {}
+		template <typename V> void operator()(V a, V b, V c, V &range, V &azimuth, V &elevation) const
+		{
+			V ex, ey, ez, e, n, u;
+			GeodeticToECEFV(a, b, c, ex, ey, ez);
+			frame.ToENU(ex, ey, ez, e, n, u);
+			V horizontal = Sqrt(e * e + n * n);
+			range = Sqrt(horizontal * horizontal + u * u);
+			azimuth = Atan2(e, n) * c_dDegreesPerRadian;
+			azimuth = Select(CmpLt(azimuth, V(0.0)), azimuth + 360.0, azimuth);
+			elevation = Atan2(u, horizontal) * c_dDegreesPerRadian;
+		}
+	};
+
+	///
+	/// \brief Applies op to the points uBegin.. in blocks of V::c_uWidth, returns the first point not done
+	///
+	template <typename V, typename OP>
+	size_t RunBlocks(const OP &op, const double *p0, const double *p1, const double *p2, size_t uBegin, size_t uCount, double *q0, double *q1, double *q2)
+	{
+		size_t i = uBegin;
+		for (; i + V::c_uWidth <= uCount; i += V::c_uWidth)
+		{
+			V r0, r1, r2;
+			op(V::Load(&p0[i]), V::Load(&p1[i]), V::Load(&p2[i]), r0, r1, r2);
+			r0.Store(&q0[i]);
+			r1.Store(&q1[i]);
+			r2.Store(&q2[i]);
+		}
+		return i;
+	}
+
+	///
+	/// \brief Applies op to all points: vector blocks, then the scalar tail
+	///
+	template <typename OP>
+	void Run(const OP &op, const double *p0, const double *p1, const double *p2, size_t uCount, double *q0, double *q1, double *q2)
+	{
+		size_t i = RunBlocks<CVecBest>(op, p0, p1, p2, 0, uCount, q0, q1, q2);
+		RunBlocks<CVecScalar>(op, p0, p1, p2, i, uCount, q0, q1, q2);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Transverse Mercator (Krüger series, n^4)
+	///////////////////////////////////////////////////////////////////////////
+
+	struct CKruger {
+		double	dA;																///< Rectifying radius times the scale (meters)
+		double	pdAlpha[4];
+		double	pdBeta[4];
+		double	pdDelta[4];
+		double	dE;																///< First eccentricity
+
+		CKruger()
+		{
+			double n = c_dWGS84F / (2.0 - c_dWGS84F);
+			double n2 = n * n;
+			double n3 = n2 * n;
+			double n4 = n3 * n;
+			dA = c_dUTMScale * c_dWGS84A / (1.0 + n) * (1.0 + n2 / 4.0 + n4 / 64.0);
+			pdAlpha[0] = n / 2.0 - 2.0 * n2 / 3.0 + 5.0 * n3 / 16.0 + 41.0 * n4 / 180.0;
+			pdAlpha[1] = 13.0 * n2 / 48.0 - 3.0 * n3 / 5.0 + 557.0 * n4 / 1440.0;
+			pdAlpha[2] = 61.0 * n3 / 240.0 - 103.0 * n4 / 140.0;
+			pdAlpha[3] = 49561.0 * n4 / 161280.0;
+			pdBeta[0] = n / 2.0 - 2.0 * n2 / 3.0 + 37.0 * n3 / 96.0 - n4 / 360.0;
+			pdBeta[1] = n2 / 48.0 + n3 / 15.0 - 437.0 * n4 / 1440.0;
+			pdBeta[2] = 17.0 * n3 / 480.0 - 37.0 * n4 / 840.0;
+			pdBeta[3] = 4397.0 * n4 / 161280.0;
+			pdDelta[0] = 2.0 * n - 2.0 * n2 / 3.0 - 2.0 * n3 + 116.0 * n4 / 45.0;
+			pdDelta[1] = 7.0 * n2 / 3.0 - 8.0 * n3 / 5.0 - 227.0 * n4 / 45.0;
+			pdDelta[2] = 56.0 * n3 / 15.0 - 136.0 * n4 / 35.0;
+			pdDelta[3] = 4279.0 * n4 / 630.0;
+			dE = sqrt(c_dWGS84E2);
+		}
+	};
+
+	const CKruger &GetKruger(void)
+	{
+		static const CKruger kruger;
+		return kruger;
+	}
+
+	double CentralMeridian(int nZone)
+	{
+		return (double)(nZone * 6 - 183);
+	}
+}
+
+void CNMEAGeodesy::GeodeticToECEF(const double * pdLatitude, const double * pdLongitude, const double * pdAltitude, size_t uCount, double * pdX, double * pdY, double * pdZ)
+{
+	Run(COpGeodeticToECEF(), pdLatitude, pdLongitude, pdAltitude, uCount, pdX, pdY, pdZ);
+}
+
+void CNMEAGeodesy::ECEFToGeodetic(const double * pdX, const double * pdY, const double * pdZ, size_t uCount, double * pdLatitude, double * pdLongitude, double * pdAltitude)
+{
+	Run(COpECEFToGeodetic(), pdX, pdY, pdZ, uCount, pdLatitude, pdLongitude, pdAltitude);
+}
+
+int CNMEAGeodesy::GetUTMZone(double dLatitude, double dLongitude)
+{
+	double dLon = dLongitude - 360.0 * floor((dLongitude + 180.0) / 360.0);
+	int nZone = (int)floor((dLon + 180.0) / 6.0) + 1;
+	if (nZone > 60)
+	{
+		nZone = 60;
+	}
+
+	//
+	// South west Norway and Svalbard
+	//
+	if (dLatitude >= 56.0 && dLatitude < 64.0 && dLon >= 3.0 && dLon < 12.0)
+	{
+		nZone = 32;
+	}
+	else if (dLatitude >= 72.0 && dLatitude < 84.0 && dLon >= 0.0 && dLon < 42.0)
+	{
+		if (dLon < 9.0)
+		{
+			nZone = 31;
+		}
+		else if (dLon < 21.0)
+		{
+			nZone = 33;
+		}
+		else if (dLon < 33.0)
+		{
+			nZone = 35;
+		}
+		else
+		{
+			nZone = 37;
+		}
+	}
+	return nZone;
+}
+
+void CNMEAGeodesy::GeodeticToUTM(const double * pdLatitude, const double * pdLongitude, size_t uCount, int nZone, bool bSouth, double * pdEasting, double * pdNorthing)
+{
+	const CKruger &k = GetKruger();
+	double dLon0 = CentralMeridian(nZone);
+	double dFalseNorthing = bSouth ? c_dUTMFalseNorthingSouth : 0.0;
+
+	for (size_t i = 0; i < uCount; i++)
+	{
+		double dLat = pdLatitude[i] * c_dRadiansPerDegree;
+		double dLon = pdLongitude[i] - dLon0;
+		dLon = (dLon - 360.0 * floor((dLon + 180.0) / 360.0)) * c_dRadiansPerDegree;
+
+		double dSinLat = sin(dLat);
+		double t = sinh(atanh(dSinLat) - k.dE * atanh(k.dE * dSinLat));	// conformal latitude
+		double dXi = atan2(t, cos(dLon));
+		double dEta = atanh(sin(dLon) / sqrt(1.0 + t * t));
+
+		double dX = dEta;
+		double dY = dXi;
+		for (int j = 0; j < 4; j++)
+		{
+			double d2j = 2.0 * (j + 1);
+			dX += k.pdAlpha[j] * cos(d2j * dXi) * sinh(d2j * dEta);
+			dY += k.pdAlpha[j] * sin(d2j * dXi) * cosh(d2j * dEta);
+		}
+		pdEasting[i] = c_dUTMFalseEasting + k.dA * dX;
+		pdNorthing[i] = dFalseNorthing + k.dA * dY;
+	}
+}
+
+void CNMEAGeodesy::UTMToGeodetic(const double * pdEasting, const double * pdNorthing, size_t uCount, int nZone, bool bSouth, double * pdLatitude, double * pdLongitude)
+{
+	const CKruger &k = GetKruger();
+	double dLon0 = CentralMeridian(nZone);
+	double dFalseNorthing = bSouth ? c_dUTMFalseNorthingSouth : 0.0;
+
+	for (size_t i = 0; i < uCount; i++)
+	{
+		double dXi = (pdNorthing[i] - dFalseNorthing) / k.dA;
+		double dEta = (pdEasting[i] - c_dUTMFalseEasting) / k.dA;
+
+		double dXi1 = dXi;
+		double dEta1 = dEta;
+		for (int j = 0; j < 4; j++)
+		{
+			double d2j = 2.0 * (j + 1);
+			dXi1 -= k.pdBeta[j] * sin(d2j * dXi) * cosh(d2j * dEta);
+			dEta1 -= k.pdBeta[j] * cos(d2j * dXi) * sinh(d2j * dEta);
+		}
+
+		double dChi = asin(sin(dXi1) / cosh(dEta1));
+		double dLat = dChi;
+		for (int j = 0; j < 4; j++)
+		{
+			dLat += k.pdDelta[j] * sin(2.0 * (j + 1) * dChi);
+		}
+		pdLatitude[i] = dLat * c_dDegreesPerRadian;
+		pdLongitude[i] = dLon0 + atan2(sinh(dEta1), cos(dXi1)) * c_dDegreesPerRadian;
+	}
+}
+
+const char * CNMEAGeodesy::GetImplementation(void)
+{
+#if defined(NMEA_SCAN_AVX2)
+	return "AVX2";
+#elif defined(NMEA_SCAN_SSE2)
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// CNMEALocalFrame
+///////////////////////////////////////////////////////////////////////////////
+
+CNMEALocalFrame::CNMEALocalFrame() :
+	m_dLatitude(0.0),
+	m_dLongitude(0.0),
+	m_dAltitude(0.0),
+	m_Rotation(CNMEAMatrix<3, 3>::Identity()),
+	m_bValid(false)
+{
+	m_pdOrigin[0] = m_pdOrigin[1] = m_pdOrigin[2] = 0.0;
+}
+
+CNMEALocalFrame::CNMEALocalFrame(double dLatitude, double dLongitude, double dAltitude) :
+	m_bValid(false)
+{
+	SetOrigin(dLatitude, dLongitude, dAltitude);
+}
+
+void CNMEALocalFrame::SetOrigin(double dLatitude, double dLongitude, double dAltitude)
+{
+	if (m_bValid && dLatitude == m_dLatitude && dLongitude == m_dLongitude && dAltitude == m_dAltitude)
+	{
+		return;
+	}
+
+	m_dLatitude = dLatitude;
+	m_dLongitude = dLongitude;
+	m_dAltitude = dAltitude;
+	CNMEAGeodesy::GeodeticToECEF(&dLatitude, &dLongitude, &dAltitude, 1, &m_pdOrigin[0], &m_pdOrigin[1], &m_pdOrigin[2]);
+
+	double dSinLat = sin(dLatitude * c_dRadiansPerDegree);
+	double dCosLat = cos(dLatitude * c_dRadiansPerDegree);
+	double dSinLon = sin(dLongitude * c_dRadiansPerDegree);
+	double dCosLon = cos(dLongitude * c_dRadiansPerDegree);
+	m_Rotation(0, 0) = -dSinLon;			m_Rotation(0, 1) = dCosLon;				m_Rotation(0, 2) = 0.0;
+	m_Rotation(1, 0) = -dSinLat * dCosLon;	m_Rotation(1, 1) = -dSinLat * dSinLon;	m_Rotation(1, 2) = dCosLat;
+	m_Rotation(2, 0) = dCosLat * dCosLon;	m_Rotation(2, 1) = dCosLat * dSinLon;	m_Rotation(2, 2) = dSinLat;
+	m_bValid = true;
+}
+
+void CNMEALocalFrame::ECEFToENU(const double * pdX, const double * pdY, const double * pdZ, size_t uCount, double * pdEast, double * pdNorth, double * pdUp) const
+{
+	Run(COpECEFToENU(CFrame(m_Rotation, m_pdOrigin)), pdX, pdY, pdZ, uCount, pdEast, pdNorth, pdUp);
+}
+
+void CNMEALocalFrame::ENUToECEF(const double * pdEast, const double * pdNorth, const double * pdUp, size_t uCount, double * pdX, double * pdY, double * pdZ) const
+{
+	Run(COpENUToECEF(CFrame(m_Rotation, m_pdOrigin)), pdEast, pdNorth, pdUp, uCount, pdX, pdY, pdZ);
+}
+
+void CNMEALocalFrame::GeodeticToENU(const double * pdLatitude, const double * pdLongitude, const double * pdAltitude, size_t uCount, double * pdEast, double * pdNorth, double * pdUp) const
+{
+	Run(COpGeodeticToENU(CFrame(m_Rotation, m_pdOrigin)), pdLatitude, pdLongitude, pdAltitude, uCount, pdEast, pdNorth, pdUp);
+}
+
+void CNMEALocalFrame::ENUToGeodetic(const double * pdEast, const double * pdNorth, const double * pdUp, size_t uCount, double * pdLatitude, double * pdLongitude, double * pdAltitude) const
+{
+	Run(COpENUToGeodetic(CFrame(m_Rotation, m_pdOrigin)), pdEast, pdNorth, pdUp, uCount, pdLatitude, pdLongitude, pdAltitude);
+}
+
+void CNMEALocalFrame::GeodeticToNED(const double * pdLatitude, const double * pdLongitude, const double * pdAltitude, size_t uCount, double * pdNorth, double * pdEast, double * pdDown) const
+{
+	Run(COpGeodeticToNED(CFrame(m_Rotation, m_pdOrigin)), pdLatitude, pdLongitude, pdAltitude, uCount, pdNorth, pdEast, pdDown);
+}
+
+void CNMEALocalFrame::NEDToGeodetic(const double * pdNorth, const double * pdEast, const double * pdDown, size_t uCount, double * pdLatitude, double * pdLongitude, double * pdAltitude) const
+{
+	Run(COpNEDToGeodetic(CFrame(m_Rotation, m_pdOrigin)), pdNorth, pdEast, pdDown, uCount, pdLatitude, pdLongitude, pdAltitude);
+}
+
+void CNMEALocalFrame::GeodeticToPolar(const double * pdLatitude, const double * pdLongitude, const double * pdAltitude, size_t uCount, double * pdRange, double * pdAzimuth, double * pdElevation) const
+{
+	Run(COpGeodeticToPolar(CFrame(m_Rotation, m_pdOrigin)), pdLatitude, pdLongitude, pdAltitude, uCount, pdRange, pdAzimuth, pdElevation);
+}
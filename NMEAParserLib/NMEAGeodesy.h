@@ -0,0 +1,172 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include "NMEAMatrix.h"
+
+///
+/// \brief Batch WGS84 coordinate conversions on arrays (structure of arrays).
+///
+/// Whole trajectories are converted in one call: every function walks the arrays in
+/// blocks of 4 (AVX2) or 2 (SSE2) points with the same build switches as CNMEAScan
+/// (NMEA_SCAN_NO_SIMD forces the scalar code). Sine, cosine and arc tangent are
+/// evaluated with polynomials in the vector registers instead of one libm call per
+/// point; the results agree with libm to about 1e-15 relative (well below 0.1 mm).
+///
+/// The gain depends on the vector width. On the 100000 point track of the benchmark,
+/// geodetic to ENU at -O2 is about 2.8x faster than libm per point with AVX2, but only
+/// 1.1x to 1.4x with SSE2, where two lanes barely pay for the polynomial evaluation.
+///
+/// Angles are decimal degrees, distances meters, altitudes are ellipsoidal heights.
+/// Input and output arrays may be the same array.
+///
+namespace CNMEAGeodesy {
+
+	///
+	/// \brief Geodetic to earth centered, earth fixed
+	///
+	/// \param pdLatitude Latitudes (Decimal degrees, S < 0 > N)
+	/// \param pdLongitude Longitudes (Decimal degrees, W < 0 > E)
+	/// \param pdAltitude Heights above the ellipsoid (meters)
+	/// \param uCount Number of points
+	/// \param pdX Returned ECEF X (meters)
+	/// \param pdY Returned ECEF Y (meters)
+	/// \param pdZ Returned ECEF Z (meters)
+	///
+	void GeodeticToECEF(const double *pdLatitude, const double *pdLongitude, const double *pdAltitude, size_t uCount, double *pdX, double *pdY, double *pdZ);
+
+	///
+	/// \brief Earth centered, earth fixed to geodetic (Bowring, one refinement; exact to well below 1 mm from the ground to orbit)
+	///
+	void ECEFToGeodetic(const double *pdX, const double *pdY, const double *pdZ, size_t uCount, double *pdLatitude, double *pdLongitude, double *pdAltitude);
+
+	///
+	/// \brief Returns the UTM zone of a position, including the Norway and Svalbard exceptions
+	///
+	int GetUTMZone(double dLatitude, double dLongitude);
+
+	///
+	/// \brief Geodetic to UTM (Krüger series, fourth order) in one zone
+	///
+	/// All points use nZone and bSouth, so a track that crosses a zone border or the equator
+	/// stays continuous. Runs the scalar code: the series needs hyperbolic functions.
+	///
+	/// \param pdLatitude Latitudes (Decimal degrees)
+	/// \param pdLongitude Longitudes (Decimal degrees)
+	/// \param uCount Number of points
+	/// \param nZone UTM zone, 1 to 60, see GetUTMZone()
+	/// \param bSouth true for the southern hemisphere false northing (10000 km)
+	/// \param pdEasting Returned easting (meters)
+	/// \param pdNorthing Returned northing (meters)
+	///
+	void GeodeticToUTM(const double *pdLatitude, const double *pdLongitude, size_t uCount, int nZone, bool bSouth, double *pdEasting, double *pdNorthing);
+
+	///
+	/// \brief UTM to geodetic, the inverse of GeodeticToUTM()
+	///
+	void UTMToGeodetic(const double *pdEasting, const double *pdNorthing, size_t uCount, int nZone, bool bSouth, double *pdLatitude, double *pdLongitude);
+
+	///
+	/// \brief Returns the name of the compiled in implementation ("AVX2", "SSE2" or "scalar")
+	///
+	const char *GetImplementation(void);
+};
+
+///
+/// \class CNMEALocalFrame
+/// \brief Local tangent plane (ENU, NED) and polar coordinates about a home point.
+///
+/// The ECEF position of the origin and the ECEF to ENU rotation are computed once when the
+/// origin is set and reused for every batch; setting the same origin again costs nothing.
+///
+class CNMEALocalFrame
+{
+private:
+	double							m_dLatitude;								///< Origin (Decimal degrees)
+	double							m_dLongitude;								///< Origin (Decimal degrees)
+	double							m_dAltitude;								///< Origin height above the ellipsoid (meters)
+	double							m_pdOrigin[3];								///< Origin ECEF X, Y, Z (meters)
+	CNMEAMatrix<3, 3>				m_Rotation;									///< ECEF to ENU, rows are the east, north and up unit vectors
+	bool							m_bValid;									///< SetOrigin() was called
+
+public:
+	CNMEALocalFrame();
+	CNMEALocalFrame(double dLatitude, double dLongitude, double dAltitude);
+
+	///
+	/// \brief Moves the origin (home point). Does nothing if it did not change.
+	///
+	void SetOrigin(double dLatitude, double dLongitude, double dAltitude);
+
+	bool IsValid(void) const { return m_bValid; }
+	double GetLatitude(void) const { return m_dLatitude; }
+	double GetLongitude(void) const { return m_dLongitude; }
+	double GetAltitude(void) const { return m_dAltitude; }
+	const CNMEAMatrix<3, 3> &GetRotation(void) const { return m_Rotation; }
+
+	///
+	/// \brief ECEF to east, north, up relative to the origin
+	///
+	void ECEFToENU(const double *pdX, const double *pdY, const double *pdZ, size_t uCount, double *pdEast, double *pdNorth, double *pdUp) const;
+
+	///
+	/// \brief East, north, up to ECEF
+	///
+	void ENUToECEF(const double *pdEast, const double *pdNorth, const double *pdUp, size_t uCount, double *pdX, double *pdY, double *pdZ) const;
+
+	///
+	/// \brief Geodetic to east, north, up in one pass (no intermediate ECEF arrays)
+	///
+	void GeodeticToENU(const double *pdLatitude, const double *pdLongitude, const double *pdAltitude, size_t uCount, double *pdEast, double *pdNorth, double *pdUp) const;
+
+	///
+	/// \brief East, north, up to geodetic in one pass
+	///
+	void ENUToGeodetic(const double *pdEast, const double *pdNorth, const double *pdUp, size_t uCount, double *pdLatitude, double *pdLongitude, double *pdAltitude) const;
+
+	///
+	/// \brief Geodetic to north, east, down
+	///
+	void GeodeticToNED(const double *pdLatitude, const double *pdLongitude, const double *pdAltitude, size_t uCount, double *pdNorth, double *pdEast, double *pdDown) const;
+
+	///
+	/// \brief North, east, down to geodetic
+	///
+	void NEDToGeodetic(const double *pdNorth, const double *pdEast, const double *pdDown, size_t uCount, double *pdLatitude, double *pdLongitude, double *pdAltitude) const;
+
+	///
+	/// \brief Geodetic to polar coordinates about the origin
+	///
+	/// \param pdLatitude Latitudes (Decimal degrees)
+	/// \param pdLongitude Longitudes (Decimal degrees)
+	/// \param pdAltitude Heights above the ellipsoid (meters)
+	/// \param uCount Number of points
+	/// \param pdRange Returned slant range (meters)
+	/// \param pdAzimuth Returned azimuth, degrees True 0 to 360
+	/// \param pdElevation Returned elevation above the local horizontal, degrees -90 to 90
+	///
+	void GeodeticToPolar(const double *pdLatitude, const double *pdLongitude, const double *pdAltitude, size_t uCount, double *pdRange, double *pdAzimuth, double *pdElevation) const;
+};
@@ -0,0 +1,151 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include "NMEAHistogram.h"
+#include <string.h>
+
+CNMEAHistogram::CNMEAHistogram()
+{
+	Reset();
+}
+
+void CNMEAHistogram::Reset(void)
+{
+	memset(m_puCounts, 0, sizeof(m_puCounts));
+	m_uCount = 0;
+	m_nMin = 0;
+	m_nMax = 0;
+	m_dSum = 0.0;
+}
+
+int CNMEAHistogram::GetBucket(uint64_t uValue)
+{
+	if (uValue < (uint64_t)c_nSubBuckets)
+	{
+		return (int)uValue;
+	}
+
+	//
+	// Position of the highest set bit picks the power of two, the next c_nSubBucketBits
+	// bits pick the linear bucket within it
+	//
+	int nExponent = 63;
+	while ((uValue >> nExponent) == 0)
+	{
+		nExponent--;
+	}
+	if (nExponent >= c_nMaxValueBits)
+	{
+		return c_nBuckets - 1;
+	}
+	int nSubBucket = (int)(uValue >> (nExponent - c_nSubBucketBits)) & (c_nSubBuckets - 1);
+	return (nExponent - c_nSubBucketBits + 1) * c_nSubBuckets + nSubBucket;
+}
+
+int64_t CNMEAHistogram::GetBucketUpperBound(int nBucket)
+{
+	if (nBucket < c_nSubBuckets)
+	{
+		return nBucket;
+	}
+	int nExponent = nBucket / c_nSubBuckets + c_nSubBucketBits - 1;
+	int64_t nSubBucket = nBucket % c_nSubBuckets;
+	int nShift = nExponent - c_nSubBucketBits;
+	return (((int64_t)c_nSubBuckets + nSubBucket + 1) << nShift) - 1;
+}
+
+void CNMEAHistogram::Record(int64_t nValueNs)
+{
+	if (nValueNs < 0)
+	{
+		nValueNs = 0;
+	}
+	m_puCounts[GetBucket((uint64_t)nValueNs)]++;
+	if (m_uCount == 0 || nValueNs < m_nMin)
+	{
+		m_nMin = nValueNs;
+	}
+	if (m_uCount == 0 || nValueNs > m_nMax)
+	{
+		m_nMax = nValueNs;
+	}
+	m_uCount++;
+	m_dSum += (double)nValueNs;
+}
+
+void CNMEAHistogram::Merge(const CNMEAHistogram & histogram)
+{
+	if (histogram.m_uCount == 0)
+	{
+		return;
+	}
+	for (int i = 0; i < c_nBuckets; i++)
+	{
+		m_puCounts[i] += histogram.m_puCounts[i];
+	}
+	if (m_uCount == 0 || histogram.m_nMin < m_nMin)
+	{
+		m_nMin = histogram.m_nMin;
+	}
+	if (m_uCount == 0 || histogram.m_nMax > m_nMax)
+	{
+		m_nMax = histogram.m_nMax;
+	}
+	m_uCount += histogram.m_uCount;
+	m_dSum += histogram.m_dSum;
+}
+
+int64_t CNMEAHistogram::GetPercentile(double dPercentile) const
+{
+	if (m_uCount == 0)
+	{
+		return 0;
+	}
+	if (dPercentile < 0.0)
+	{
+		dPercentile = 0.0;
+	}
+	if (dPercentile > 100.0)
+	{
+		dPercentile = 100.0;
+	}
+
+	uint64_t uRank = (uint64_t)(dPercentile / 100.0 * (double)m_uCount + 0.5);
+	if (uRank == 0)
+	{
+		uRank = 1;
+	}
+
+	uint64_t uSeen = 0;
+	for (int i = 0; i < c_nBuckets; i++)
+	{
+		uSeen += m_puCounts[i];
+		if (uSeen >= uRank)
+		{
+			int64_t nValue = GetBucketUpperBound(i);
+			return nValue < m_nMax ? (nValue > m_nMin ? nValue : m_nMin) : m_nMax;
+		}
+	}
+	return m_nMax;
+}
@@ -0,0 +1,109 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+
+///
+/// \class CNMEAHistogram
+/// \brief Fixed memory log-linear histogram of nanosecond durations (HDR style).
+///
+/// Values below c_nSubBuckets are counted exactly. Larger values are counted in
+/// c_nSubBuckets linear buckets per power of two, so every bucket is within about 6% of
+/// the values it holds. Values from 1 ns up to about 18 minutes (2^40 ns) are resolved,
+/// larger values are counted in the last bucket. Recording is a few integer operations and
+/// never allocates.
+///
+class CNMEAHistogram
+{
+public:
+	static const int				c_nSubBucketBits = 4;						///< log2 of the buckets per power of two
+	static const int				c_nSubBuckets = 1 << c_nSubBucketBits;		///< Buckets per power of two
+	static const int				c_nMaxValueBits = 40;						///< Values are resolved up to 2^c_nMaxValueBits ns
+	static const int				c_nBuckets = (c_nMaxValueBits - c_nSubBucketBits + 1) * c_nSubBuckets;	///< Number of buckets
+
+private:
+	uint32_t						m_puCounts[c_nBuckets];						///< Bucket counts
+	uint64_t						m_uCount;									///< Number of values recorded
+	int64_t							m_nMin;										///< Smallest value recorded
+	int64_t							m_nMax;										///< Largest value recorded
+	double							m_dSum;										///< Sum of the values recorded
+
+public:
+	CNMEAHistogram();
+
+	///
+	/// \brief Removes all values
+	///
+	void Reset(void);
+
+	///
+	/// \brief Records a duration
+	/// \param nValueNs Duration in nanoseconds, negative values are recorded as 0
+	///
+	void Record(int64_t nValueNs);
+
+	///
+	/// \brief Adds the values of another histogram
+	///
+	void Merge(const CNMEAHistogram &histogram);
+
+	///
+	/// \brief Returns the number of values recorded
+	///
+	uint64_t GetCount(void) const { return m_uCount; }
+
+	///
+	/// \brief Returns the smallest value recorded, 0 if empty
+	///
+	int64_t GetMin(void) const { return m_uCount != 0 ? m_nMin : 0; }
+
+	///
+	/// \brief Returns the largest value recorded, 0 if empty
+	///
+	int64_t GetMax(void) const { return m_uCount != 0 ? m_nMax : 0; }
+
+	///
+	/// \brief Returns the mean of the values recorded, 0 if empty
+	///
+	double GetMean(void) const { return m_uCount != 0 ? m_dSum / (double)m_uCount : 0.0; }
+
+	///
+	/// \brief Returns the value at a percentile (upper bound of its bucket, never above GetMax())
+	/// \param dPercentile Percentile, 0.0 to 100.0
+	///
+	int64_t GetPercentile(double dPercentile) const;
+
+private:
+	///
+	/// \brief Returns the bucket of a value
+	///
+	static int GetBucket(uint64_t uValue);
+
+	///
+	/// \brief Returns the largest value counted in a bucket
+	///
+	static int64_t GetBucketUpperBound(int nBucket);
+};
@@ -0,0 +1,397 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include <math.h>
+#include <string.h>
+#include "NMEAKinematicFilter.h"
+
+namespace {
+	static const double			c_dPi = 3.14159265358979323846;
+	static const double			c_dRadiansPerDegree = c_dPi / 180.0;
+	static const double			c_dWGS84A = 6378137.0;							///< WGS84 semi-major axis (meters)
+	static const double			c_dWGS84E2 = 6.69437999014e-3;					///< WGS84 first eccentricity squared
+	static const double			c_dMetersPerSecondPerKnot = 1852.0 / 3600.0;
+	static const double			c_dSecondsPerDay = 86400.0;
+	static const double			c_dDefaultJerkHorizontal = 1.0;					///< m^2/s^5, a car or a small drone
+	static const double			c_dDefaultJerkVertical = 0.1;					///< m^2/s^5
+	static const double			c_dDefaultUERE = 3.0;							///< meters, autonomous L1 fix
+	static const double			c_dDefaultVelocitySigma = 0.3;					///< m/s
+	static const double			c_dDefaultMaxGap = 10.0;						///< seconds
+	static const double			c_dUnknownDOP = 5.0;							///< DOP used when the receiver sent none
+	static const double			c_dMaxOriginDistance = 10000.0;					///< meters, moves the origin to keep the flat earth error small
+	static const double			c_dInitialVelocityVariance = 100.0;				///< (m/s)^2, velocity not measured
+	static const double			c_dInitialAccelerationVariance = 4.0;			///< (m/s^2)^2
+
+	///
+	/// \brief Meters per degree of latitude and longitude at a position (WGS84)
+	///
+	void MetersPerDegree(double dLatitude, double dAltitude, double &dPerDegreeLat, double &dPerDegreeLon)
+	{
+		double dSinLat = sin(dLatitude * c_dRadiansPerDegree);
+		double dW = sqrt(1.0 - c_dWGS84E2 * dSinLat * dSinLat);
+		double dMeridian = c_dWGS84A * (1.0 - c_dWGS84E2) / (dW * dW * dW);
+		double dPrimeVertical = c_dWGS84A / dW;
+		dPerDegreeLat = (dMeridian + dAltitude) * c_dRadiansPerDegree;
+		dPerDegreeLon = (dPrimeVertical + dAltitude) * cos(dLatitude * c_dRadiansPerDegree) * c_dRadiansPerDegree;
+	}
+
+	///
+	/// \brief Wraps a longitude difference into -180..180 degrees
+	///
+	double WrapLongitude(double dDegrees)
+	{
+		if (dDegrees > 180.0)
+		{
+			dDegrees -= 360.0;
+		}
+		else if (dDegrees < -180.0)
+		{
+			dDegrees += 360.0;
+		}
+		return dDegrees;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// CNMEAKinematicAxis
+///////////////////////////////////////////////////////////////////////////////
+
+CNMEAKinematicAxis::CNMEAKinematicAxis(double dJerkDensity) :
+	m_x(STATE_T::Zero()),
+	m_P(COVARIANCE_T::Zero()),
+	m_dJerkDensity(dJerkDensity),
+	m_bInitialized(false)
+{
+}
+
+void CNMEAKinematicAxis::Initialize(double dPosition, double dPositionVariance, double dVelocity, double dVelocityVariance, double dAccelerationVariance)
+{
+	m_x(STATE_POSITION, 0) = dPosition;
+	m_x(STATE_VELOCITY, 0) = dVelocity;
+	m_x(STATE_ACCELERATION, 0) = 0.0;
+	m_P = COVARIANCE_T::Zero();
+	m_P(STATE_POSITION, STATE_POSITION) = dPositionVariance;
+	m_P(STATE_VELOCITY, STATE_VELOCITY) = dVelocityVariance;
+	m_P(STATE_ACCELERATION, STATE_ACCELERATION) = dAccelerationVariance;
+	m_bInitialized = true;
+}
+
+void CNMEAKinematicAxis::Predict(double dSeconds)
+{
+	double dT = dSeconds;
+	double dT2 = dT * dT;
+	double dT3 = dT2 * dT;
+
+	COVARIANCE_T F = COVARIANCE_T::Identity();
+	F(0, 1) = dT;
+	F(0, 2) = dT2 / 2.0;
+	F(1, 2) = dT;
+
+	//
+	// Discrete white noise jerk
+	//
+	COVARIANCE_T Q;
+	Q(0, 0) = dT3 * dT2 / 20.0;	Q(0, 1) = dT2 * dT2 / 8.0;	Q(0, 2) = dT3 / 6.0;
+	Q(1, 0) = Q(0, 1);			Q(1, 1) = dT3 / 3.0;		Q(1, 2) = dT2 / 2.0;
+	Q(2, 0) = Q(0, 2);			Q(2, 1) = Q(1, 2);			Q(2, 2) = dT;
+
+	m_x = F * m_x;
+	m_P = F * m_P * F.Transpose() + Q * m_dJerkDensity;
+}
+
+void CNMEAKinematicAxis::Update(STATE_E nState, double dMeasurement, double dVariance)
+{
+	double dInnovationVariance = m_P(nState, nState) + dVariance;
+	if (dInnovationVariance <= 0.0)
+	{
+		return;
+	}
+
+	STATE_T K;
+	for (int i = 0; i < 3; i++)
+	{
+		K(i, 0) = m_P(i, nState) / dInnovationVariance;
+	}
+
+	double dInnovation = dMeasurement - m_x(nState, 0);
+	COVARIANCE_T P = m_P;
+	for (int r = 0; r < 3; r++)
+	{
+		m_x(r, 0) += K(r, 0) * dInnovation;
+		for (int c = 0; c < 3; c++)
+		{
+			m_P(r, c) = P(r, c) - K(r, 0) * P(nState, c);
+		}
+	}
+
+	//
+	// Keep the covariance symmetric against rounding
+	//
+	for (int r = 0; r < 3; r++)
+	{
+		for (int c = r + 1; c < 3; c++)
+		{
+			double dMean = (m_P(r, c) + m_P(c, r)) / 2.0;
+			m_P(r, c) = m_P(c, r) = dMean;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// CNMEAKinematicFilter
+///////////////////////////////////////////////////////////////////////////////
+
+CNMEAKinematicFilter::CNMEAKinematicFilter() :
+	m_dOriginLatitude(0.0),
+	m_dOriginLongitude(0.0),
+	m_dMetersPerDegreeLat(0.0),
+	m_dMetersPerDegreeLon(0.0),
+	m_dUERE(c_dDefaultUERE),
+	m_dVelocitySigma(c_dDefaultVelocitySigma),
+	m_dLatency(0.0),
+	m_dMaxGap(c_dDefaultMaxGap)
+{
+	SetProcessNoise(c_dDefaultJerkHorizontal, c_dDefaultJerkVertical);
+	Reset();
+}
+
+CNMEAKinematicFilter::~CNMEAKinematicFilter()
+{
+}
+
+void CNMEAKinematicFilter::Reset(void)
+{
+	for (int i = 0; i < AXIS_COUNT; i++)
+	{
+		m_pAxes[i].Reset();
+	}
+	memset(&m_State, 0, sizeof(m_State));
+}
+
+void CNMEAKinematicFilter::SetProcessNoise(double dHorizontal, double dVertical)
+{
+	m_pAxes[AXIS_EAST].SetJerkDensity(dHorizontal);
+	m_pAxes[AXIS_NORTH].SetJerkDensity(dHorizontal);
+	m_pAxes[AXIS_UP].SetJerkDensity(dVertical);
+}
+
+void CNMEAKinematicFilter::SetMeasurementNoise(double dUERE, double dVelocitySigma)
+{
+	m_dUERE = dUERE;
+	m_dVelocitySigma = dVelocitySigma;
+}
+
+bool CNMEAKinematicFilter::Update(const CNMEAParserData::FIX_RECORD_T & fix)
+{
+	return Update(fix, fix.m_nRxTimeNs - (int64_t)(m_dLatency * 1.0e9));
+}
+
+bool CNMEAKinematicFilter::Update(const CNMEAParserData::FIX_RECORD_T & fix, int64_t nTimeNs)
+{
+	//
+	// Position available?
+	//
+	bool bHasAltitude = (fix.m_uContentMask & CNMEAParserData::FIX_HAS_GGA) != 0;
+	bool bHasPosition;
+	if (bHasAltitude)
+	{
+		bHasPosition = fix.m_nGPSQuality != CNMEAParserData::GQ_FIX_NOT_AVAILABLE;
+	}
+	else
+	{
+		bHasPosition = (fix.m_uContentMask & (CNMEAParserData::FIX_HAS_RMC | CNMEAParserData::FIX_HAS_GLL)) != 0 &&
+			fix.m_nStatus == CNMEAParserData::RMC_STATUS_ACTIVE;
+	}
+	if (bHasPosition == false)
+	{
+		return false;
+	}
+	bool bHasVelocity = (fix.m_uContentMask & (CNMEAParserData::FIX_HAS_RMC | CNMEAParserData::FIX_HAS_VTG)) != 0;
+
+	//
+	// Measurement noise, per axis
+	//
+	double dHorizontalVariance;
+	double dVerticalVariance;
+	if ((fix.m_uContentMask & CNMEAParserData::FIX_HAS_GST) && fix.m_dLatitudeSigma > 0.0 && fix.m_dLongitudeSigma > 0.0)
+	{
+		dHorizontalVariance = (fix.m_dLatitudeSigma * fix.m_dLatitudeSigma + fix.m_dLongitudeSigma * fix.m_dLongitudeSigma) / 2.0;
+		dVerticalVariance = fix.m_dAltitudeSigma > 0.0 ? fix.m_dAltitudeSigma * fix.m_dAltitudeSigma : 4.0 * dHorizontalVariance;
+	}
+	else
+	{
+		double dHDOP = fix.m_dHDOP > 0.0 ? fix.m_dHDOP : c_dUnknownDOP;
+		double dVDOP = fix.m_dVDOP > 0.0 ? fix.m_dVDOP : 1.5 * dHDOP;
+		dHorizontalVariance = dHDOP * m_dUERE * dHDOP * m_dUERE / 2.0;		// HDOP covers both axes
+		dVerticalVariance = dVDOP * m_dUERE * dVDOP * m_dUERE;
+	}
+	double dVelocityVariance = m_dVelocitySigma * m_dVelocitySigma;
+
+	double dSpeed = fix.m_dSpeedKnots * c_dMetersPerSecondPerKnot;
+	double dVelocityEast = dSpeed * sin(fix.m_dTrackAngle * c_dRadiansPerDegree);
+	double dVelocityNorth = dSpeed * cos(fix.m_dTrackAngle * c_dRadiansPerDegree);
+
+	//
+	// Time since the last update from the UTC times, so an hour or a day boundary does not matter
+	//
+	double dTimeOfDay = (double)fix.m_nHour * 3600.0 + (double)fix.m_nMinute * 60.0 + fix.m_dSecond;
+	double dElapsed = dTimeOfDay - m_State.m_dTimeOfDay;
+	if (dElapsed < -c_dSecondsPerDay / 2.0)
+	{
+		dElapsed += c_dSecondsPerDay;
+	}
+
+	bool bStart = m_State.m_bValid == false || dElapsed < 0.0 || dElapsed > m_dMaxGap;
+	if (bStart)
+	{
+		SetOrigin(fix.m_dLatitude, fix.m_dLongitude, bHasAltitude ? fix.m_dAltitudeMSL : 0.0);
+		m_pAxes[AXIS_EAST].Initialize(0.0, dHorizontalVariance,
+			bHasVelocity ? dVelocityEast : 0.0, bHasVelocity ? dVelocityVariance : c_dInitialVelocityVariance, c_dInitialAccelerationVariance);
+		m_pAxes[AXIS_NORTH].Initialize(0.0, dHorizontalVariance,
+			bHasVelocity ? dVelocityNorth : 0.0, bHasVelocity ? dVelocityVariance : c_dInitialVelocityVariance, c_dInitialAccelerationVariance);
+		m_pAxes[AXIS_UP].Initialize(bHasAltitude ? fix.m_dAltitudeMSL : 0.0, bHasAltitude ? dVerticalVariance : 1.0e6,
+			0.0, c_dInitialVelocityVariance, c_dInitialAccelerationVariance);
+	}
+	else
+	{
+		if (dElapsed > 0.0)
+		{
+			for (int i = 0; i < AXIS_COUNT; i++)
+			{
+				m_pAxes[i].Predict(dElapsed);
+			}
+		}
+
+		double dEast = WrapLongitude(fix.m_dLongitude - m_dOriginLongitude) * m_dMetersPerDegreeLon;
+		double dNorth = (fix.m_dLatitude - m_dOriginLatitude) * m_dMetersPerDegreeLat;
+		m_pAxes[AXIS_EAST].Update(CNMEAKinematicAxis::STATE_POSITION, dEast, dHorizontalVariance);
+		m_pAxes[AXIS_NORTH].Update(CNMEAKinematicAxis::STATE_POSITION, dNorth, dHorizontalVariance);
+		if (bHasAltitude)
+		{
+			m_pAxes[AXIS_UP].Update(CNMEAKinematicAxis::STATE_POSITION, fix.m_dAltitudeMSL, dVerticalVariance);
+		}
+		if (bHasVelocity)
+		{
+			m_pAxes[AXIS_EAST].Update(CNMEAKinematicAxis::STATE_VELOCITY, dVelocityEast, dVelocityVariance);
+			m_pAxes[AXIS_NORTH].Update(CNMEAKinematicAxis::STATE_VELOCITY, dVelocityNorth, dVelocityVariance);
+		}
+	}
+
+	m_State.m_bValid = true;
+	m_State.m_uEpoch = fix.m_uEpoch;
+	m_State.m_dTimeOfDay = dTimeOfDay;
+	m_State.m_nTimeNs = nTimeNs;
+	UpdateState();
+
+	//
+	// Keep the local plane small, the origin moves along with a long trip
+	//
+	if (fabs(m_pAxes[AXIS_EAST].GetPosition()) > c_dMaxOriginDistance || fabs(m_pAxes[AXIS_NORTH].GetPosition()) > c_dMaxOriginDistance)
+	{
+		m_pAxes[AXIS_EAST].Shift(-m_pAxes[AXIS_EAST].GetPosition());
+		m_pAxes[AXIS_NORTH].Shift(-m_pAxes[AXIS_NORTH].GetPosition());
+		SetOrigin(m_State.m_dLatitude, m_State.m_dLongitude, m_State.m_dAltitudeMSL);
+	}
+	return true;
+}
+
+void CNMEAKinematicFilter::Extrapolate(const CNMEAParserData::KINEMATIC_STATE_T & state, int64_t nTimeNs, double dMaxSeconds, CNMEAParserData::KINEMATIC_STATE_T & predicted)
+{
+	predicted = state;
+	if (state.m_bValid == false)
+	{
+		return;
+	}
+
+	double dT = (double)(nTimeNs - state.m_nTimeNs) * 1.0e-9;
+	if (dT > dMaxSeconds)
+	{
+		dT = dMaxSeconds;
+	}
+	else if (dT < -dMaxSeconds)
+	{
+		dT = -dMaxSeconds;
+	}
+	double dHalfT2 = dT * dT / 2.0;
+
+	double dPerDegreeLat;
+	double dPerDegreeLon;
+	MetersPerDegree(state.m_dLatitude, state.m_dAltitudeMSL, dPerDegreeLat, dPerDegreeLon);
+
+	double dEast = state.m_dVelocityEast * dT + state.m_dAccelerationEast * dHalfT2;
+	double dNorth = state.m_dVelocityNorth * dT + state.m_dAccelerationNorth * dHalfT2;
+	predicted.m_dLatitude = state.m_dLatitude + dNorth / dPerDegreeLat;
+	predicted.m_dLongitude = state.m_dLongitude + WrapLongitude(dEast / dPerDegreeLon);
+	predicted.m_dAltitudeMSL = state.m_dAltitudeMSL + state.m_dClimbRate * dT + state.m_dAccelerationUp * dHalfT2;
+	predicted.m_dVelocityEast = state.m_dVelocityEast + state.m_dAccelerationEast * dT;
+	predicted.m_dVelocityNorth = state.m_dVelocityNorth + state.m_dAccelerationNorth * dT;
+	predicted.m_dClimbRate = state.m_dClimbRate + state.m_dAccelerationUp * dT;
+	predicted.m_dSpeed = sqrt(predicted.m_dVelocityEast * predicted.m_dVelocityEast + predicted.m_dVelocityNorth * predicted.m_dVelocityNorth);
+	if (predicted.m_dSpeed > 0.0)
+	{
+		predicted.m_dTrackAngle = atan2(predicted.m_dVelocityEast, predicted.m_dVelocityNorth) / c_dRadiansPerDegree;
+		if (predicted.m_dTrackAngle < 0.0)
+		{
+			predicted.m_dTrackAngle += 360.0;
+		}
+	}
+	predicted.m_dTimeOfDay = fmod(state.m_dTimeOfDay + dT + c_dSecondsPerDay, c_dSecondsPerDay);
+	predicted.m_nTimeNs = state.m_nTimeNs + (int64_t)(dT * 1.0e9);
+	predicted.m_dExtrapolation = state.m_dExtrapolation + dT;
+}
+
+void CNMEAKinematicFilter::SetOrigin(double dLatitude, double dLongitude, double dAltitude)
+{
+	m_dOriginLatitude = dLatitude;
+	m_dOriginLongitude = dLongitude;
+	MetersPerDegree(dLatitude, dAltitude, m_dMetersPerDegreeLat, m_dMetersPerDegreeLon);
+}
+
+void CNMEAKinematicFilter::UpdateState(void)
+{
+	const CNMEAKinematicAxis &east = m_pAxes[AXIS_EAST];
+	const CNMEAKinematicAxis &north = m_pAxes[AXIS_NORTH];
+	const CNMEAKinematicAxis &up = m_pAxes[AXIS_UP];
+
+	m_State.m_dExtrapolation = 0.0;
+	m_State.m_dLatitude = m_dOriginLatitude + north.GetPosition() / m_dMetersPerDegreeLat;
+	m_State.m_dLongitude = m_dOriginLongitude + east.GetPosition() / m_dMetersPerDegreeLon;
+	m_State.m_dLongitude = WrapLongitude(m_State.m_dLongitude);
+	m_State.m_dAltitudeMSL = up.GetPosition();
+	m_State.m_dVelocityEast = east.GetVelocity();
+	m_State.m_dVelocityNorth = north.GetVelocity();
+	m_State.m_dClimbRate = up.GetVelocity();
+	m_State.m_dAccelerationEast = east.GetAcceleration();
+	m_State.m_dAccelerationNorth = north.GetAcceleration();
+	m_State.m_dAccelerationUp = up.GetAcceleration();
+	m_State.m_dSpeed = sqrt(m_State.m_dVelocityEast * m_State.m_dVelocityEast + m_State.m_dVelocityNorth * m_State.m_dVelocityNorth);
+	m_State.m_dTrackAngle = atan2(m_State.m_dVelocityEast, m_State.m_dVelocityNorth) / c_dRadiansPerDegree;
+	if (m_State.m_dTrackAngle < 0.0)
+	{
+		m_State.m_dTrackAngle += 360.0;
+	}
+	m_State.m_dHorizontalSigma = sqrt(east.GetVariance(CNMEAKinematicAxis::STATE_POSITION) + north.GetVariance(CNMEAKinematicAxis::STATE_POSITION));
+	m_State.m_dVerticalSigma = sqrt(up.GetVariance(CNMEAKinematicAxis::STATE_POSITION));
+	m_State.m_dClimbRateSigma = sqrt(up.GetVariance(CNMEAKinematicAxis::STATE_VELOCITY));
+}
@@ -0,0 +1,229 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <stdint.h>
+#include "NMEAMatrix.h"
+#include "NMEAParserData.h"
+
+///
+/// \class CNMEAKinematicAxis
+/// \brief Constant acceleration Kalman filter along one axis: position, velocity, acceleration.
+///
+/// The acceleration is driven by white jerk noise of spectral density m_dJerkDensity.
+/// Measurements are scalar (position or velocity), so the update needs no matrix inverse.
+///
+class CNMEAKinematicAxis
+{
+public:
+	typedef CNMEAMatrix<3, 1>		STATE_T;									///< Position, velocity, acceleration
+	typedef CNMEAMatrix<3, 3>		COVARIANCE_T;								///< State covariance
+
+	///
+	/// State vector elements, also the nState argument of Update()
+	///
+	enum STATE_E {
+		STATE_POSITION = 0,
+		STATE_VELOCITY = 1,
+		STATE_ACCELERATION = 2,
+	};
+
+private:
+	STATE_T							m_x;										///< State estimate
+	COVARIANCE_T					m_P;										///< State covariance
+	double							m_dJerkDensity;								///< Process noise, jerk spectral density (units^2/s^5)
+	bool							m_bInitialized;								///< Initialize() was called since the last Reset()
+
+public:
+	explicit CNMEAKinematicAxis(double dJerkDensity = 1.0);
+
+	///
+	/// \brief Forgets the state, the next measurement must go to Initialize()
+	///
+	void Reset(void) { m_bInitialized = false; }
+
+	///
+	/// \brief Sets the process noise. Larger values follow maneuvers faster and smooth less.
+	///
+	void SetJerkDensity(double dJerkDensity) { m_dJerkDensity = dJerkDensity; }
+
+	bool IsInitialized(void) const { return m_bInitialized; }
+
+	///
+	/// \brief Starts the filter at a known position and velocity, acceleration 0
+	///
+	/// \param dPosition Position
+	/// \param dPositionVariance Variance of dPosition
+	/// \param dVelocity Velocity
+	/// \param dVelocityVariance Variance of dVelocity, large if the velocity is not known
+	/// \param dAccelerationVariance Variance of the (0) acceleration
+	///
+	void Initialize(double dPosition, double dPositionVariance, double dVelocity, double dVelocityVariance, double dAccelerationVariance);
+
+	///
+	/// \brief Propagates the state dSeconds ahead
+	///
+	void Predict(double dSeconds);
+
+	///
+	/// \brief Adds a measurement of one state element
+	///
+	/// \param nState STATE_POSITION or STATE_VELOCITY
+	/// \param dMeasurement Measured value
+	/// \param dVariance Measurement variance
+	///
+	void Update(STATE_E nState, double dMeasurement, double dVariance);
+
+	///
+	/// \brief Moves the position by dOffset, ie: when the local origin changes
+	///
+	void Shift(double dOffset) { m_x(STATE_POSITION, 0) += dOffset; }
+
+	double GetPosition(void) const { return m_x(STATE_POSITION, 0); }
+	double GetVelocity(void) const { return m_x(STATE_VELOCITY, 0); }
+	double GetAcceleration(void) const { return m_x(STATE_ACCELERATION, 0); }
+	double GetVariance(STATE_E nState) const { return m_P(nState, nState); }
+};
+
+///
+/// \class CNMEAKinematicFilter
+/// \brief Smooths the fix records into position, velocity and climb rate, and predicts them to display time.
+///
+/// One CNMEAKinematicAxis per local east, north and up axis, fed once per epoch with the
+/// position (GGA, RMC or GLL) and the horizontal velocity (RMC or VTG speed and track) of a
+/// FIX_RECORD_T. Measurement noise comes from the GST error estimates if the receiver sends
+/// them, from HDOP/VDOP times the range error (UERE) otherwise.
+///
+/// Elapsed time is taken from the UTC time of the fixes (midnight wraps are handled), the
+/// monotonic clock is only used to place the state in host time. A fix is measured some
+/// time before its first byte arrives; SetLatency() moves the state back by that much so
+/// that Extrapolate() to the time a frame is shown hides both the receiver latency and the
+/// age of the last 1 Hz update.
+///
+class CNMEAKinematicFilter
+{
+public:
+	///
+	/// Local axes, index of m_pAxes
+	///
+	enum AXIS_E {
+		AXIS_EAST = 0,
+		AXIS_NORTH = 1,
+		AXIS_UP = 2,
+		AXIS_COUNT = 3,
+	};
+
+private:
+	CNMEAKinematicAxis				m_pAxes[AXIS_COUNT];						///< East, north and up filters, in meters from the origin
+	double							m_dOriginLatitude;							///< Local origin (Decimal degrees)
+	double							m_dOriginLongitude;							///< Local origin (Decimal degrees)
+	double							m_dMetersPerDegreeLat;						///< North meters per degree of latitude at the origin
+	double							m_dMetersPerDegreeLon;						///< East meters per degree of longitude at the origin
+	double							m_dUERE;									///< Range error (meters, 1 sigma) multiplied with the DOPs
+	double							m_dVelocitySigma;							///< Speed over ground error (m/s, 1 sigma)
+	double							m_dLatency;									///< Time from measurement to first byte (seconds)
+	double							m_dMaxGap;									///< Longest gap between fixes the state survives (seconds)
+	CNMEAParserData::KINEMATIC_STATE_T	m_State;								///< Filter state after the last update
+
+public:
+	CNMEAKinematicFilter();
+	virtual ~CNMEAKinematicFilter();
+
+	///
+	/// \brief Forgets the state, the next fix starts the filter again
+	///
+	void Reset(void);
+
+	///
+	/// \brief Sets the process noise, jerk spectral density in m^2/s^5
+	///
+	/// \param dHorizontal East and north axes
+	/// \param dVertical Up axis
+	///
+	void SetProcessNoise(double dHorizontal, double dVertical);
+
+	///
+	/// \brief Sets the measurement noise used when the fix has no GST error estimates
+	///
+	/// \param dUERE Range error (meters, 1 sigma), multiplied with HDOP and VDOP
+	/// \param dVelocitySigma Speed over ground error (m/s, 1 sigma)
+	///
+	void SetMeasurementNoise(double dUERE, double dVelocitySigma);
+
+	///
+	/// \brief Sets the time between the fix measurement and its first byte (seconds)
+	///
+	void SetLatency(double dSeconds) { m_dLatency = dSeconds; }
+
+	///
+	/// \brief Sets the longest gap between fixes before the filter starts again (seconds)
+	///
+	void SetMaxGap(double dSeconds) { m_dMaxGap = dSeconds; }
+
+	///
+	/// \brief Adds one epoch
+	///
+	/// \param fix Fix record
+	/// \return true if the record had a position and updated the state
+	///
+	bool Update(const CNMEAParserData::FIX_RECORD_T &fix);
+
+	///
+	/// \brief Adds one epoch measured at a known monotonic clock time, ie: from CNMEAClockCorrelator
+	///
+	/// \param fix Fix record
+	/// \param nTimeNs Monotonic clock time of the measurement in nanoseconds, the latency is not applied
+	/// \return true if the record had a position and updated the state
+	///
+	bool Update(const CNMEAParserData::FIX_RECORD_T &fix, int64_t nTimeNs);
+
+	///
+	/// \brief Returns the state after the last update
+	///
+	const CNMEAParserData::KINEMATIC_STATE_T &GetState(void) const { return m_State; }
+
+	///
+	/// \brief Predicts state to a monotonic clock time, ie: the time the next frame is shown
+	///
+	/// Needs nothing but state, so readers can extrapolate a published copy without
+	/// holding up the filter.
+	///
+	/// \param state State to predict from (GetState())
+	/// \param nTimeNs Monotonic (steady) clock time in nanoseconds, see CNMEAClock::GetTimeNs()
+	/// \param dMaxSeconds Longest prediction, predictions further away stop there
+	/// \param predicted Returned state, m_dExtrapolation set to the time predicted
+	///
+	static void Extrapolate(const CNMEAParserData::KINEMATIC_STATE_T &state, int64_t nTimeNs, double dMaxSeconds, CNMEAParserData::KINEMATIC_STATE_T &predicted);
+
+private:
+	///
+	/// \brief Places the local origin at a position
+	///
+	void SetOrigin(double dLatitude, double dLongitude, double dAltitude);
+
+	///
+	/// \brief Fills m_State from the axes
+	///
+	void UpdateState(void);
+};
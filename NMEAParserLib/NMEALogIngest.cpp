@@ -0,0 +1,289 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include "NMEALogIngest.h"
+#include "NMEAParserT.h"
+#include <string.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+///
+/// \class CNMEAChunkParser
+/// \brief Parses one chunk of a log into its own fix table
+///
+class CNMEAChunkParser : public CNMEAParserT<CNMEAParserPolicy::POSITION_T>
+{
+public:
+	CNMEALogIngest::FIX_TABLE_T		m_Fixes;									///< Fixes found in this chunk
+	uint64_t						m_uSentenceCount;							///< Complete sentences in this chunk
+	uint64_t						m_uErrorCount;								///< Errors in this chunk
+
+	CNMEAChunkParser() :
+		m_uSentenceCount(0),
+		m_uErrorCount(0)
+	{
+	}
+
+	virtual void OnError(CNMEAParserData::ERROR_E nError, char *pCmd)
+	{
+		UNUSED_PARAM(nError);
+		UNUSED_PARAM(pCmd);
+		m_uErrorCount++;
+	}
+
+protected:
+	virtual void ProcessRxBatch(CNMEAParserData::SENTENCE_T *pSentences, uint32_t uCount)
+	{
+		m_uSentenceCount += uCount;
+		CNMEAParserT<CNMEAParserPolicy::POSITION_T>::ProcessRxBatch(pSentences, uCount);
+	}
+
+	virtual void OnSentenceDecoded(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID, const CNMEASentenceBase *pSentence, int64_t nRxTimeNs)
+	{
+		UNUSED_PARAM(nSentenceID);
+		UNUSED_PARAM(nRxTimeNs);
+		const CNMEAParserData::GGA_DATA_T &ggaData = static_cast<const CNMEASentenceGGA *>(pSentence)->GetSentenceData();
+		m_Fixes.vuTalkerID.push_back((uint16_t)nTalkerID);
+		m_Fixes.vnSecondOfDay.push_back(ggaData.m_nHour * 3600 + ggaData.m_nMinute * 60 + ggaData.m_nSecond);
+		m_Fixes.vdLatitude.push_back(ggaData.m_dLatitude);
+		m_Fixes.vdLongitude.push_back(ggaData.m_dLongitude);
+		m_Fixes.vfAltitudeMSL.push_back((float)ggaData.m_dAltitudeMSL);
+		m_Fixes.vfHDOP.push_back((float)ggaData.m_dHDOP);
+		m_Fixes.vuGPSQuality.push_back((uint8_t)ggaData.m_nGPSQuality);
+		m_Fixes.vuSatsInView.push_back((uint8_t)ggaData.m_nSatsInView);
+	}
+};
+
+///
+/// \brief Appends one column of a chunk table to the merged table
+///
+template <typename T>
+static void AppendColumn(std::vector<T> &vDest, const std::vector<T> &vSource)
+{
+	vDest.insert(vDest.end(), vSource.begin(), vSource.end());
+}
+
+CNMEALogIngest::CNMEALogIngest() :
+	m_uSentenceCount(0),
+	m_uErrorCount(0)
+{
+}
+
+void CNMEALogIngest::Clear(void)
+{
+	m_Fixes = FIX_TABLE_T();
+	m_uSentenceCount = 0;
+	m_uErrorCount = 0;
+}
+
+CNMEAParserData::ERROR_E CNMEALogIngest::IngestFile(const char * pszFileName, int nThreads)
+{
+	CNMEAParserData::ERROR_E nErr = CNMEAParserData::ERROR_FAIL;
+
+#if defined(_WIN32)
+	HANDLE hFile = CreateFileA(pszFileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+	{
+		return CNMEAParserData::ERROR_FAIL;
+	}
+	LARGE_INTEGER fileSize;
+	if (GetFileSizeEx(hFile, &fileSize) == 0)
+	{
+		CloseHandle(hFile);
+		return CNMEAParserData::ERROR_FAIL;
+	}
+	if (fileSize.QuadPart == 0)
+	{
+		CloseHandle(hFile);
+		return Ingest(NULL, 0, nThreads);
+	}
+	HANDLE hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (hMapping != NULL)
+	{
+		const char *pData = (const char *)MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+		if (pData != NULL)
+		{
+			nErr = Ingest(pData, (size_t)fileSize.QuadPart, nThreads);
+			UnmapViewOfFile(pData);
+		}
+		CloseHandle(hMapping);
+	}
+	CloseHandle(hFile);
+#else
+	int nFile = open(pszFileName, O_RDONLY);
+	if (nFile < 0)
+	{
+		return CNMEAParserData::ERROR_FAIL;
+	}
+	struct stat fileStat;
+	if (fstat(nFile, &fileStat) != 0)
+	{
+		close(nFile);
+		return CNMEAParserData::ERROR_FAIL;
+	}
+	size_t uLength = (size_t)fileStat.st_size;
+	if (uLength == 0)
+	{
+		close(nFile);
+		return Ingest(NULL, 0, nThreads);
+	}
+	void *pMap = mmap(NULL, uLength, PROT_READ, MAP_PRIVATE, nFile, 0);
+	close(nFile);
+	if (pMap != MAP_FAILED)
+	{
+		//
+		// Every page is read once, front to back
+		//
+		madvise(pMap, uLength, MADV_SEQUENTIAL);
+		nErr = Ingest((const char *)pMap, uLength, nThreads);
+		munmap(pMap, uLength);
+	}
+#endif
+
+	return nErr;
+}
+
+CNMEAParserData::ERROR_E CNMEALogIngest::Ingest(const char * pData, size_t uLength, int nThreads)
+{
+	Clear();
+
+	if (nThreads <= 0)
+	{
+		nThreads = (int)std::thread::hardware_concurrency();
+		if (nThreads <= 0)
+		{
+			nThreads = 1;
+		}
+	}
+
+	//
+	// Split into chunks that start at a '$'. A few chunks per thread keep all threads busy
+	// until the end even when the sentence mix differs along the file.
+	//
+	size_t uChunks = uLength / c_uChunkSize;
+	if (uChunks < (size_t)nThreads * 4)
+	{
+		uChunks = (size_t)nThreads * 4;
+	}
+	size_t uChunkSize = uLength / uChunks + 1;
+
+	std::vector<size_t> vuChunkStart;
+	size_t uOffset = 0;
+	while (uOffset < uLength)
+	{
+		vuChunkStart.push_back(uOffset);
+		size_t uNext = uOffset + uChunkSize;
+		if (uNext >= uLength)
+		{
+			break;
+		}
+		const char *pSOM = (const char *)memchr(pData + uNext, '$', uLength - uNext);
+		uOffset = pSOM != NULL ? (size_t)(pSOM - pData) : uLength;
+	}
+	vuChunkStart.push_back(uLength);
+
+	size_t uChunkCount = vuChunkStart.size() - 1;
+	std::vector<std::unique_ptr<CNMEAChunkParser> > vChunks(uChunkCount);
+	std::atomic<size_t> uNextChunk(0);
+
+	auto worker = [&]() {
+		for (;;)
+		{
+			size_t uChunk = uNextChunk.fetch_add(1);
+			if (uChunk >= uChunkCount)
+			{
+				break;
+			}
+			std::unique_ptr<CNMEAChunkParser> pParser(new CNMEAChunkParser());
+			pParser->ResetData();
+
+			//
+			// The parser only reads the buffer, so the read only mapping can be passed directly
+			//
+			size_t uStart = vuChunkStart[uChunk];
+			pParser->ProcessNMEABufferBatch(const_cast<char *>(pData + uStart), vuChunkStart[uChunk + 1] - uStart);
+			vChunks[uChunk] = std::move(pParser);
+		}
+	};
+
+	if (nThreads > (int)uChunkCount)
+	{
+		nThreads = (int)uChunkCount;
+	}
+	std::vector<std::thread> vThreads;
+	for (int i = 1; i < nThreads; i++)
+	{
+		vThreads.push_back(std::thread(worker));
+	}
+	worker();
+	for (size_t i = 0; i < vThreads.size(); i++)
+	{
+		vThreads[i].join();
+	}
+
+	//
+	// Merge in file order
+	//
+	size_t uFixCount = 0;
+	for (size_t i = 0; i < uChunkCount; i++)
+	{
+		uFixCount += vChunks[i]->m_Fixes.vuTalkerID.size();
+	}
+	m_Fixes.vuTalkerID.reserve(uFixCount);
+	m_Fixes.vnSecondOfDay.reserve(uFixCount);
+	m_Fixes.vdLatitude.reserve(uFixCount);
+	m_Fixes.vdLongitude.reserve(uFixCount);
+	m_Fixes.vfAltitudeMSL.reserve(uFixCount);
+	m_Fixes.vfHDOP.reserve(uFixCount);
+	m_Fixes.vuGPSQuality.reserve(uFixCount);
+	m_Fixes.vuSatsInView.reserve(uFixCount);
+
+	for (size_t i = 0; i < uChunkCount; i++)
+	{
+		const FIX_TABLE_T &chunkFixes = vChunks[i]->m_Fixes;
+		AppendColumn(m_Fixes.vuTalkerID, chunkFixes.vuTalkerID);
+		AppendColumn(m_Fixes.vnSecondOfDay, chunkFixes.vnSecondOfDay);
+		AppendColumn(m_Fixes.vdLatitude, chunkFixes.vdLatitude);
+		AppendColumn(m_Fixes.vdLongitude, chunkFixes.vdLongitude);
+		AppendColumn(m_Fixes.vfAltitudeMSL, chunkFixes.vfAltitudeMSL);
+		AppendColumn(m_Fixes.vfHDOP, chunkFixes.vfHDOP);
+		AppendColumn(m_Fixes.vuGPSQuality, chunkFixes.vuGPSQuality);
+		AppendColumn(m_Fixes.vuSatsInView, chunkFixes.vuSatsInView);
+		m_uSentenceCount += vChunks[i]->m_uSentenceCount;
+		m_uErrorCount += vChunks[i]->m_uErrorCount;
+		vChunks[i].reset();
+	}
+
+	return CNMEAParserData::ERROR_OK;
+}
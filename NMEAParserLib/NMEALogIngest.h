@@ -0,0 +1,114 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+#include "NMEAParserData.h"
+
+///
+/// \class CNMEALogIngest
+/// \brief Parses large recorded NMEA logs on all cores into a columnar fix table.
+///
+/// The log is memory mapped and split into chunks that start at a '$'. Each chunk is
+/// parsed by its own GGA only CNMEAParserT on a pool of worker threads, so no parser state is
+/// shared between threads. The per chunk results are appended to the fix table in file
+/// order once all chunks are done.
+///
+/// One row is added for every GGA sentence (any talker). Derived values that need the
+/// previous sentence (GGA_DATA_T::m_dVertSpeed) restart at every chunk boundary and are
+/// not part of the table.
+///
+class CNMEALogIngest
+{
+public:
+	static const size_t				c_uChunkSize = 4 * 1024 * 1024;				///< Target chunk size (bytes)
+
+	///
+	/// \brief Fix table, one entry per column per GGA sentence
+	///
+	typedef struct _FIX_TABLE_T {
+		std::vector<uint16_t>		vuTalkerID;									///< CNMEAParserData::TALKER_ID_E
+		std::vector<int32_t>		vnSecondOfDay;								///< UTC time of the fix (seconds since midnight)
+		std::vector<double>			vdLatitude;									///< Latitude (Decimal degrees, S < 0 > N)
+		std::vector<double>			vdLongitude;								///< Longitude (Decimal degrees, W < 0 > E)
+		std::vector<float>			vfAltitudeMSL;								///< Altitude (Meters)
+		std::vector<float>			vfHDOP;										///< Horizontal Dilution of Precision
+		std::vector<uint8_t>		vuGPSQuality;								///< CNMEAParserData::GPS_QUALITY_E
+		std::vector<uint8_t>		vuSatsInView;								///< Number of satellites in view
+	} FIX_TABLE_T;
+
+private:
+	FIX_TABLE_T						m_Fixes;									///< Fixes of the last ingest, in file order
+	uint64_t						m_uSentenceCount;							///< Complete sentences (valid checksum) in the last ingest
+	uint64_t						m_uErrorCount;								///< Checksum and framing errors seen by the last ingest
+
+public:
+	CNMEALogIngest();
+
+	///
+	/// \brief Memory maps a log file and parses it
+	///
+	/// \param pszFileName Log file name
+	/// \param nThreads Number of worker threads, 0 for one per core
+	/// \return ERROR_OK if successful, ERROR_FAIL if the file could not be mapped
+	///
+	CNMEAParserData::ERROR_E IngestFile(const char *pszFileName, int nThreads = 0);
+
+	///
+	/// \brief Parses a log that is already in memory
+	///
+	/// \param pData Log data
+	/// \param uLength Number of bytes in pData
+	/// \param nThreads Number of worker threads, 0 for one per core
+	/// \return ERROR_OK if successful
+	///
+	CNMEAParserData::ERROR_E Ingest(const char *pData, size_t uLength, int nThreads = 0);
+
+	///
+	/// \brief Returns the fix table of the last ingest
+	///
+	const FIX_TABLE_T &GetFixes(void) const { return m_Fixes; }
+
+	///
+	/// \brief Returns the number of rows in the fix table
+	///
+	size_t GetFixCount(void) const { return m_Fixes.vuTalkerID.size(); }
+
+	///
+	/// \brief Returns the number of complete sentences (valid checksum) in the last ingest
+	///
+	uint64_t GetSentenceCount(void) const { return m_uSentenceCount; }
+
+	///
+	/// \brief Returns the number of checksum and framing errors seen by the last ingest
+	///
+	uint64_t GetErrorCount(void) const { return m_uErrorCount; }
+
+	///
+	/// \brief Removes all rows from the fix table
+	///
+	void Clear(void);
+};
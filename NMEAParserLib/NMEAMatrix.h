@@ -0,0 +1,142 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+
+///
+/// \class CNMEAMatrix
+/// \brief Fixed size matrix of doubles, dimensions known at compile time.
+///
+/// Storage is a plain array inside the object: no heap, trivially copyable, and the
+/// compiler unrolls the loops for the small sizes used by the filters.
+///
+template <int nRows, int nCols>
+class CNMEAMatrix
+{
+public:
+	double						m_pd[nRows][nCols];								///< Elements, row major
+
+	///
+	/// \brief Returns a matrix with all elements 0
+	///
+	static CNMEAMatrix Zero(void)
+	{
+		CNMEAMatrix m;
+		for (int r = 0; r < nRows; r++)
+		{
+			for (int c = 0; c < nCols; c++)
+			{
+				m.m_pd[r][c] = 0.0;
+			}
+		}
+		return m;
+	}
+
+	///
+	/// \brief Returns the identity matrix
+	///
+	static CNMEAMatrix Identity(void)
+	{
+		CNMEAMatrix m = Zero();
+		for (int i = 0; i < nRows && i < nCols; i++)
+		{
+			m.m_pd[i][i] = 1.0;
+		}
+		return m;
+	}
+
+	double &operator()(int r, int c) { return m_pd[r][c]; }
+	double operator()(int r, int c) const { return m_pd[r][c]; }
+
+	CNMEAMatrix operator+(const CNMEAMatrix &b) const
+	{
+		CNMEAMatrix m;
+		for (int r = 0; r < nRows; r++)
+		{
+			for (int c = 0; c < nCols; c++)
+			{
+				m.m_pd[r][c] = m_pd[r][c] + b.m_pd[r][c];
+			}
+		}
+		return m;
+	}
+
+	CNMEAMatrix operator-(const CNMEAMatrix &b) const
+	{
+		CNMEAMatrix m;
+		for (int r = 0; r < nRows; r++)
+		{
+			for (int c = 0; c < nCols; c++)
+			{
+				m.m_pd[r][c] = m_pd[r][c] - b.m_pd[r][c];
+			}
+		}
+		return m;
+	}
+
+	template <int nOtherCols>
+	CNMEAMatrix<nRows, nOtherCols> operator*(const CNMEAMatrix<nCols, nOtherCols> &b) const
+	{
+		CNMEAMatrix<nRows, nOtherCols> m;
+		for (int r = 0; r < nRows; r++)
+		{
+			for (int c = 0; c < nOtherCols; c++)
+			{
+				double dSum = 0.0;
+				for (int k = 0; k < nCols; k++)
+				{
+					dSum += m_pd[r][k] * b.m_pd[k][c];
+				}
+				m.m_pd[r][c] = dSum;
+			}
+		}
+		return m;
+	}
+
+	CNMEAMatrix operator*(double d) const
+	{
+		CNMEAMatrix m;
+		for (int r = 0; r < nRows; r++)
+		{
+			for (int c = 0; c < nCols; c++)
+			{
+				m.m_pd[r][c] = m_pd[r][c] * d;
+			}
+		}
+		return m;
+	}
+
+	CNMEAMatrix<nCols, nRows> Transpose(void) const
+	{
+		CNMEAMatrix<nCols, nRows> m;
+		for (int r = 0; r < nRows; r++)
+		{
+			for (int c = 0; c < nCols; c++)
+			{
+				m.m_pd[c][r] = m_pd[r][c];
+			}
+		}
+		return m;
+	}
+};
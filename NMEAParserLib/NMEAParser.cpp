@@ -25,14 +25,103 @@
 #include <stdio.h>
 #include <string.h>
 #include "NMEAParser.h"
+#include "NMEATrace.h"
+#include "NMEAClock.h"
+#include "NMEAUBX.h"
+
+///
+/// \brief Packs a talker and sentence ID into a dispatch table key
+///
+static inline uint64_t MakeSentenceKey(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID)
+{
+	return ((uint64_t)(uint16_t)nTalkerID << 24) | ((uint64_t)nSentenceID & 0xFFFFFF);
+}
 
-CNMEAParser::CNMEAParser()
+static const double c_dMaxExtrapolation = 2.0;			///< Longest prediction of ExtrapolateKinematicState() (seconds)
+
+///
+/// \brief Home slot of a key in the dispatch table (Fibonacci hash)
+///
+static inline int SentenceKeySlot(uint64_t uKey, int nSize)
 {
+	return (int)((uKey * 0x9E3779B97F4A7C15ull) >> 40) & (nSize - 1);
+}
+
+///
+/// \brief Copies a sentence snapshot if it is newer than the caller's version
+///
+template <class SENTENCE, class DATA>
+static CNMEAParserData::ERROR_E ReadSentenceSnapshot(const CNMEASentenceBase *pSentence, DATA &sentenseData, uint32_t &uVersion)
+{
+	if (pSentence == NULL)
+	{
+		return CNMEAParserData::ERROR_FAIL;
+	}
+	if (static_cast<const SENTENCE *>(pSentence)->GetSnapshot().ReadIfNewer(sentenseData, uVersion) == false)
+	{
+		return CNMEAParserData::ERROR_NO_CHANGE;
+	}
+	return CNMEAParserData::ERROR_OK;
+}
+
+///
+/// \brief Copies the data of a schema sentence, or its defaults if the pair was not received yet
+///
+template <class SENTENCE>
+static CNMEAParserData::ERROR_E GetSchemaSentenceData(const CNMEASentenceBase *pSentence, typename SENTENCE::DATA_T &sentenseData)
+{
+	if (pSentence == NULL)
+	{
+		memset(&sentenseData, 0, sizeof(sentenseData));
+		return CNMEAParserData::ERROR_FAIL;
+	}
+	sentenseData = static_cast<const SENTENCE *>(pSentence)->GetSentenceData();
+	return CNMEAParserData::ERROR_OK;
+}
+
+CNMEAParser::CNMEAParser() :
+	m_nSlotCount(0),
+	m_uNextSubscriptionID(1),
+	m_uSequence(0),
+	m_nGSVTalkerID(CNMEAParserData::TID_ANY),
+	m_uGSVSkyView(0),
+	m_nGSVNextSentence(0),
+	m_bUBXSatellites(false)
+{
+	m_UBX.m_pParser = this;
+	m_pTable.store(NewSentenceTable(c_nInitialSentenceSlots), std::memory_order_release);
+	m_Epochs.SetCallback([this](const CNMEAEpochAssembler::FIX_PTR_T &pFix) {
+		//
+		// Time stamp the filter with the correlated clock once there is one, it does not
+		// carry the serial and scheduling jitter of the receive time
+		//
+		m_Clock.AddFix(*pFix);
+		int64_t nFixTimeNs;
+		bool bUpdated = m_Clock.GetLastFixHostTime(nFixTimeNs) ? m_Kinematics.Update(*pFix, nFixTimeNs) : m_Kinematics.Update(*pFix);
+		if (bUpdated)
+		{
+			m_KinematicSnapshot.Publish(m_Kinematics.GetState());
+		}
+		for (size_t i = 0; i < m_FixSubscriptions.size(); i++)
+		{
+			m_FixSubscriptions[i].callback(pFix);
+		}
+	});
 	ResetData();
 }
 
 CNMEAParser::~CNMEAParser()
 {
+	SENTENCE_TABLE_T *pTable = m_pTable.load(std::memory_order_relaxed);
+	for (int i = 0; i < pTable->nSize; i++)
+	{
+		delete pTable->pSlots[i].pSentence.load(std::memory_order_relaxed);
+	}
+	for (size_t i = 0; i < m_Tables.size(); i++)
+	{
+		delete[] m_Tables[i]->pSlots;
+		delete m_Tables[i];
+	}
 }
 
 void CNMEAParser::ResetData(void)
@@ -42,23 +131,25 @@ void CNMEAParser::ResetData(void)
 	//
 	DataAccessSemaphoreLock();
 
-	m_GPGGA.ResetData();
-	m_GPGSV.ResetData();
-	m_GPGSA.ResetData();
-    m_GNGSA.ResetData();
-	m_GNGGA.ResetData();
-	m_GNRMC.ResetData();
-	m_GLGSV.ResetData();
-	m_GLGSA.ResetData();
-	m_QZGSV.ResetData();
-	m_QZGSA.ResetData();
-	m_BDGSV.ResetData();
-	m_BDGSA.ResetData();
-	m_GPRMC.ResetData();
-	m_GAGGA.ResetData();
-	m_GAGSV.ResetData();
-	m_GAGSA.ResetData();
-	m_GARMC.ResetData();
+	SENTENCE_TABLE_T *pTable = m_pTable.load(std::memory_order_relaxed);
+	for (int i = 0; i < pTable->nSize; i++)
+	{
+		CNMEASentenceBase *pSentence = pTable->pSlots[i].pSentence.load(std::memory_order_relaxed);
+		if (pSentence != NULL)
+		{
+			pSentence->ResetData();
+		}
+	}
+	m_Satellites.Reset();
+	m_nGSVNextSentence = 0;
+	m_Epochs.Reset();
+	m_Clock.Reset();
+	m_Kinematics.Reset();
+	m_KinematicSnapshot.Publish(m_Kinematics.GetState());
+	memset(&m_UBXGSA, 0, sizeof(m_UBXGSA));
+	m_UBXGSA.nAutoMode = CNMEAParserData::ASAM_AUTO;
+	m_UBXGSA.nMode = CNMEAParserData::ASM_FIX_NOT_AVAILABLE;
+	m_bUBXSatellites = false;
 
 	//
 	// Unlock access to data
@@ -66,253 +157,698 @@ void CNMEAParser::ResetData(void)
 	DataAccessSemaphoreUnlock();
 }
 
-CNMEAParserData::ERROR_E CNMEAParser::GetGPGGA(CNMEAParserData::GGA_DATA_T & sentenseData)
+CNMEASentenceBase * CNMEAParser::CreateSentence(CNMEAParserData::SENTENCE_ID_E nSentenceID)
+{
+	switch (nSentenceID)
+	{
+	case CNMEAParserData::SID_GGA: return new CNMEASentenceGGA();
+	case CNMEAParserData::SID_GSA: return new CNMEASentenceGSA();
+	case CNMEAParserData::SID_GSV: return new CNMEASentenceGSV();
+	case CNMEAParserData::SID_RMC: return new CNMEASentenceRMC();
+	case CNMEAParserData::SID_VTG: return new CNMEASentenceVTG();
+	case CNMEAParserData::SID_ZDA: return new CNMEASentenceZDA();
+	case CNMEAParserData::SID_GST: return new CNMEASentenceGST();
+	case CNMEAParserData::SID_GLL: return new CNMEASentenceGLL();
+	case CNMEAParserData::SID_HDT: return new CNMEASentenceHDT();
+	default: return NULL;
+	}
+}
+
+CNMEASentenceBase * CNMEAParser::LookupSentence(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID) const
+{
+	uint64_t uKey = MakeSentenceKey(nTalkerID, nSentenceID);
+
+	//
+	// Probe linearly from the home slot. The table never holds more than 3/4 of its
+	// slots so a lookup touches a handful of entries no matter how many talkers are active.
+	//
+	const SENTENCE_TABLE_T *pTable = m_pTable.load(std::memory_order_acquire);
+	int nSlot = SentenceKeySlot(uKey, pTable->nSize);
+	for (int i = 0; i < pTable->nSize; i++)
+	{
+		uint64_t uSlotKey = pTable->pSlots[nSlot].uKey.load(std::memory_order_acquire);
+		if (uSlotKey == uKey)
+		{
+			return pTable->pSlots[nSlot].pSentence.load(std::memory_order_acquire);
+		}
+		if (uSlotKey == 0)
+		{
+			break;
+		}
+		nSlot = (nSlot + 1) & (pTable->nSize - 1);
+	}
+	return NULL;
+}
+
+CNMEASentenceBase * CNMEAParser::FindSentence(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID, bool bCreate)
 {
+	CNMEASentenceBase *pSentence = LookupSentence(nTalkerID, nSentenceID);
+	if (pSentence != NULL || bCreate == false)
+	{
+		return pSentence;
+	}
+
+	pSentence = CreateSentence(nSentenceID);
+	if (pSentence == NULL)
+	{
+		return NULL;
+	}
+
+	SENTENCE_TABLE_T *pTable = m_pTable.load(std::memory_order_relaxed);
+	if (m_nSlotCount + 1 > (pTable->nSize * 3) / 4)
+	{
+		GrowSentenceTable();
+		pTable = m_pTable.load(std::memory_order_relaxed);
+	}
+
+	//
+	// Claim the first free slot from the home slot. Publish the sentence before the key
+	// so a concurrent LookupSentence() never sees a key without its sentence.
+	//
+	uint64_t uKey = MakeSentenceKey(nTalkerID, nSentenceID);
+	int nSlot = SentenceKeySlot(uKey, pTable->nSize);
+	while (pTable->pSlots[nSlot].uKey.load(std::memory_order_relaxed) != 0)
+	{
+		nSlot = (nSlot + 1) & (pTable->nSize - 1);
+	}
+	pTable->pSlots[nSlot].pSentence.store(pSentence, std::memory_order_release);
+	pTable->pSlots[nSlot].uKey.store(uKey, std::memory_order_release);
+	m_nSlotCount++;
+	return pSentence;
+}
+
+CNMEAParser::SENTENCE_TABLE_T * CNMEAParser::NewSentenceTable(int nSize)
+{
+	SENTENCE_TABLE_T *pTable = new SENTENCE_TABLE_T;
+	pTable->nSize = nSize;
+	pTable->pSlots = new SENTENCE_SLOT_T[nSize];
+	for (int i = 0; i < nSize; i++)
+	{
+		pTable->pSlots[i].uKey.store(0, std::memory_order_relaxed);
+		pTable->pSlots[i].pSentence.store(NULL, std::memory_order_relaxed);
+	}
+	m_Tables.push_back(pTable);
+	return pTable;
+}
+
+void CNMEAParser::GrowSentenceTable(void)
+{
+	//
+	// Fill the new table completely before publishing it. Lookups still running on the
+	// old table find everything that was in it; the old table is not released.
+	//
+	const SENTENCE_TABLE_T *pOld = m_pTable.load(std::memory_order_relaxed);
+	SENTENCE_TABLE_T *pNew = NewSentenceTable(pOld->nSize * 2);
+	for (int i = 0; i < pOld->nSize; i++)
+	{
+		uint64_t uKey = pOld->pSlots[i].uKey.load(std::memory_order_relaxed);
+		if (uKey == 0)
+		{
+			continue;
+		}
+		int nSlot = SentenceKeySlot(uKey, pNew->nSize);
+		while (pNew->pSlots[nSlot].uKey.load(std::memory_order_relaxed) != 0)
+		{
+			nSlot = (nSlot + 1) & (pNew->nSize - 1);
+		}
+		pNew->pSlots[nSlot].pSentence.store(pOld->pSlots[i].pSentence.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		pNew->pSlots[nSlot].uKey.store(uKey, std::memory_order_relaxed);
+	}
+	m_pTable.store(pNew, std::memory_order_release);
+}
+
+CNMEAParserData::ERROR_E CNMEAParser::GetGGA(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::GGA_DATA_T & sentenseData)
+{
+	CNMEAParserData::ERROR_E nErr = CNMEAParserData::ERROR_FAIL;
 	DataAccessSemaphoreLock();
-	sentenseData = m_GPGGA.GetSentenceData();
+	CNMEASentenceGGA *pSentence = static_cast<CNMEASentenceGGA *>(FindSentence(nTalkerID, CNMEAParserData::SID_GGA));
+	if (pSentence != NULL)
+	{
+		sentenseData = pSentence->GetSentenceData();
+		nErr = CNMEAParserData::ERROR_OK;
+	}
+	else
+	{
+		sentenseData = CNMEASentenceGGA().GetSentenceData();
+	}
 	DataAccessSemaphoreUnlock();
-	return CNMEAParserData::ERROR_OK;
+	return nErr;
 }
 
-CNMEAParserData::ERROR_E CNMEAParser::GetGNGGA(CNMEAParserData::GGA_DATA_T & sentenseData)
+CNMEAParserData::ERROR_E CNMEAParser::GetGSV(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::GSV_DATA_T & sentenseData)
 {
+	CNMEAParserData::ERROR_E nErr = CNMEAParserData::ERROR_FAIL;
 	DataAccessSemaphoreLock();
-	sentenseData = m_GNGGA.GetSentenceData();
+	CNMEASentenceGSV *pSentence = static_cast<CNMEASentenceGSV *>(FindSentence(nTalkerID, CNMEAParserData::SID_GSV));
+	if (pSentence != NULL)
+	{
+		sentenseData = pSentence->GetSentenceData();
+		nErr = CNMEAParserData::ERROR_OK;
+	}
+	else
+	{
+		sentenseData = CNMEASentenceGSV().GetSentenceData();
+	}
 	DataAccessSemaphoreUnlock();
-	return CNMEAParserData::ERROR_OK;
+	return nErr;
 }
 
-CNMEAParserData::ERROR_E CNMEAParser::GetGPGSV(CNMEAParserData::GSV_DATA_T & sentenseData)
+CNMEAParserData::ERROR_E CNMEAParser::GetGSA(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::GSA_DATA_T & sentenseData)
 {
+	CNMEAParserData::ERROR_E nErr = CNMEAParserData::ERROR_FAIL;
 	DataAccessSemaphoreLock();
-	sentenseData = m_GPGSV.GetSentenceData();
+	CNMEASentenceGSA *pSentence = static_cast<CNMEASentenceGSA *>(FindSentence(nTalkerID, CNMEAParserData::SID_GSA));
+	if (pSentence != NULL)
+	{
+		sentenseData = pSentence->GetSentenceData();
+		nErr = CNMEAParserData::ERROR_OK;
+	}
+	else
+	{
+		sentenseData = CNMEASentenceGSA().GetSentenceData();
+	}
 	DataAccessSemaphoreUnlock();
-	return CNMEAParserData::ERROR_OK;
+	return nErr;
 }
 
-CNMEAParserData::ERROR_E CNMEAParser::GetGPGSA(CNMEAParserData::GSA_DATA_T & sentenseData)
+CNMEAParserData::ERROR_E CNMEAParser::GetRMC(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::RMC_DATA_T & sentenseData)
 {
+	CNMEAParserData::ERROR_E nErr = CNMEAParserData::ERROR_FAIL;
 	DataAccessSemaphoreLock();
-	sentenseData = m_GPGSA.GetSentenceData();
+	CNMEASentenceRMC *pSentence = static_cast<CNMEASentenceRMC *>(FindSentence(nTalkerID, CNMEAParserData::SID_RMC));
+	if (pSentence != NULL)
+	{
+		sentenseData = pSentence->GetSentenceData();
+		nErr = CNMEAParserData::ERROR_OK;
+	}
+	else
+	{
+		sentenseData = CNMEASentenceRMC().GetSentenceData();
+	}
 	DataAccessSemaphoreUnlock();
-	return CNMEAParserData::ERROR_OK;
+	return nErr;
 }
 
-CNMEAParserData::ERROR_E CNMEAParser::GetGPRMC(CNMEAParserData::RMC_DATA_T & sentenseData)
+CNMEAParserData::ERROR_E CNMEAParser::GetVTG(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::VTG_DATA_T & sentenseData)
 {
 	DataAccessSemaphoreLock();
-	sentenseData = m_GPRMC.GetSentenceData();
+	CNMEAParserData::ERROR_E nErr = GetSchemaSentenceData<CNMEASentenceVTG>(FindSentence(nTalkerID, CNMEAParserData::SID_VTG), sentenseData);
 	DataAccessSemaphoreUnlock();
-	return CNMEAParserData::ERROR_OK;
+	return nErr;
 }
 
-CNMEAParserData::ERROR_E CNMEAParser::GetGNRMC(CNMEAParserData::RMC_DATA_T & sentenseData)
+CNMEAParserData::ERROR_E CNMEAParser::GetZDA(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::ZDA_DATA_T & sentenseData)
 {
 	DataAccessSemaphoreLock();
-	sentenseData = m_GNRMC.GetSentenceData();
+	CNMEAParserData::ERROR_E nErr = GetSchemaSentenceData<CNMEASentenceZDA>(FindSentence(nTalkerID, CNMEAParserData::SID_ZDA), sentenseData);
 	DataAccessSemaphoreUnlock();
-	return CNMEAParserData::ERROR_OK;
+	return nErr;
 }
 
-CNMEAParserData::ERROR_E CNMEAParser::GetGNGSA(CNMEAParserData::GSA_DATA_T & sentenseData)
+CNMEAParserData::ERROR_E CNMEAParser::GetGST(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::GST_DATA_T & sentenseData)
 {
-    DataAccessSemaphoreLock();
-    sentenseData = m_GNGSA.GetSentenceData();
-    DataAccessSemaphoreUnlock();
-    return CNMEAParserData::ERROR_OK;
+	DataAccessSemaphoreLock();
+	CNMEAParserData::ERROR_E nErr = GetSchemaSentenceData<CNMEASentenceGST>(FindSentence(nTalkerID, CNMEAParserData::SID_GST), sentenseData);
+	DataAccessSemaphoreUnlock();
+	return nErr;
 }
 
-CNMEAParserData::ERROR_E CNMEAParser::GetGLGSV(CNMEAParserData::GSV_DATA_T & sentenseData)
+CNMEAParserData::ERROR_E CNMEAParser::GetGLL(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::GLL_DATA_T & sentenseData)
 {
 	DataAccessSemaphoreLock();
-	sentenseData = m_GLGSV.GetSentenceData();
+	CNMEAParserData::ERROR_E nErr = GetSchemaSentenceData<CNMEASentenceGLL>(FindSentence(nTalkerID, CNMEAParserData::SID_GLL), sentenseData);
 	DataAccessSemaphoreUnlock();
-	return CNMEAParserData::ERROR_OK;
+	return nErr;
 }
 
-CNMEAParserData::ERROR_E CNMEAParser::GetGLGSA(CNMEAParserData::GSA_DATA_T & sentenseData)
+CNMEAParserData::ERROR_E CNMEAParser::GetHDT(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::HDT_DATA_T & sentenseData)
 {
 	DataAccessSemaphoreLock();
-	sentenseData = m_GLGSA.GetSentenceData();
+	CNMEAParserData::ERROR_E nErr = GetSchemaSentenceData<CNMEASentenceHDT>(FindSentence(nTalkerID, CNMEAParserData::SID_HDT), sentenseData);
 	DataAccessSemaphoreUnlock();
-	return CNMEAParserData::ERROR_OK;
+	return nErr;
+}
+
+CNMEAParserData::ERROR_E CNMEAParser::ReadGGA(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::GGA_DATA_T & sentenseData, uint32_t & uVersion) const
+{
+	return ReadSentenceSnapshot<CNMEASentenceGGA>(LookupSentence(nTalkerID, CNMEAParserData::SID_GGA), sentenseData, uVersion);
 }
 
-CNMEAParserData::ERROR_E CNMEAParser::GetQZGSV(CNMEAParserData::GSV_DATA_T & sentenseData)
+CNMEAParserData::ERROR_E CNMEAParser::ReadGSV(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::GSV_DATA_T & sentenseData, uint32_t & uVersion) const
 {
+	return ReadSentenceSnapshot<CNMEASentenceGSV>(LookupSentence(nTalkerID, CNMEAParserData::SID_GSV), sentenseData, uVersion);
+}
+
+CNMEAParserData::ERROR_E CNMEAParser::ReadGSA(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::GSA_DATA_T & sentenseData, uint32_t & uVersion) const
+{
+	return ReadSentenceSnapshot<CNMEASentenceGSA>(LookupSentence(nTalkerID, CNMEAParserData::SID_GSA), sentenseData, uVersion);
+}
+
+CNMEAParserData::ERROR_E CNMEAParser::ReadRMC(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::RMC_DATA_T & sentenseData, uint32_t & uVersion) const
+{
+	return ReadSentenceSnapshot<CNMEASentenceRMC>(LookupSentence(nTalkerID, CNMEAParserData::SID_RMC), sentenseData, uVersion);
+}
+
+uint32_t CNMEAParser::SubscribeGGA(CNMEAParserData::TALKER_ID_E nTalkerID, const GGA_CALLBACK_T & callback)
+{
+	GGA_CALLBACK_T typedCallback = callback;
+	return AddSubscription(nTalkerID, CNMEAParserData::SID_GGA, [typedCallback](const CNMEAParserData::SENTENCE_INFO_T &info, const CNMEASentenceBase *pSentence) {
+		typedCallback(info, static_cast<const CNMEASentenceGGA *>(pSentence)->GetSentenceData());
+	});
+}
+
+uint32_t CNMEAParser::SubscribeGSV(CNMEAParserData::TALKER_ID_E nTalkerID, const GSV_CALLBACK_T & callback)
+{
+	GSV_CALLBACK_T typedCallback = callback;
+	return AddSubscription(nTalkerID, CNMEAParserData::SID_GSV, [typedCallback](const CNMEAParserData::SENTENCE_INFO_T &info, const CNMEASentenceBase *pSentence) {
+		typedCallback(info, static_cast<const CNMEASentenceGSV *>(pSentence)->GetSentenceData());
+	});
+}
+
+uint32_t CNMEAParser::SubscribeGSA(CNMEAParserData::TALKER_ID_E nTalkerID, const GSA_CALLBACK_T & callback)
+{
+	GSA_CALLBACK_T typedCallback = callback;
+	return AddSubscription(nTalkerID, CNMEAParserData::SID_GSA, [typedCallback](const CNMEAParserData::SENTENCE_INFO_T &info, const CNMEASentenceBase *pSentence) {
+		typedCallback(info, static_cast<const CNMEASentenceGSA *>(pSentence)->GetSentenceData());
+	});
+}
+
+uint32_t CNMEAParser::SubscribeRMC(CNMEAParserData::TALKER_ID_E nTalkerID, const RMC_CALLBACK_T & callback)
+{
+	RMC_CALLBACK_T typedCallback = callback;
+	return AddSubscription(nTalkerID, CNMEAParserData::SID_RMC, [typedCallback](const CNMEAParserData::SENTENCE_INFO_T &info, const CNMEASentenceBase *pSentence) {
+		typedCallback(info, static_cast<const CNMEASentenceRMC *>(pSentence)->GetSentenceData());
+	});
+}
+
+uint32_t CNMEAParser::SubscribeFix(const CNMEAEpochAssembler::FIX_CALLBACK_T & callback)
+{
+	FIX_SUBSCRIPTION_T subscription;
+	subscription.callback = callback;
+
 	DataAccessSemaphoreLock();
-	sentenseData = m_QZGSV.GetSentenceData();
+	subscription.uID = m_uNextSubscriptionID++;
+	m_FixSubscriptions.push_back(subscription);
 	DataAccessSemaphoreUnlock();
-	return CNMEAParserData::ERROR_OK;
+
+	return subscription.uID;
 }
 
-CNMEAParserData::ERROR_E CNMEAParser::GetQZGSA(CNMEAParserData::GSA_DATA_T & sentenseData)
+uint32_t CNMEAParser::SubscribeRaw(const RAW_CALLBACK_T & callback)
 {
+	RAW_SUBSCRIPTION_T subscription;
+	subscription.callback = callback;
+
 	DataAccessSemaphoreLock();
-	sentenseData = m_QZGSA.GetSentenceData();
+	subscription.uID = m_uNextSubscriptionID++;
+	m_RawSubscriptions.push_back(subscription);
 	DataAccessSemaphoreUnlock();
-	return CNMEAParserData::ERROR_OK;
+
+	return subscription.uID;
 }
 
-CNMEAParserData::ERROR_E CNMEAParser::GetBDGSV(CNMEAParserData::GSV_DATA_T & sentenseData)
+CNMEAEpochAssembler::FIX_PTR_T CNMEAParser::GetLastFix(void)
 {
 	DataAccessSemaphoreLock();
-	sentenseData = m_BDGSV.GetSentenceData();
+	CNMEAEpochAssembler::FIX_PTR_T pFix = m_Epochs.GetLastFix();
 	DataAccessSemaphoreUnlock();
-	return CNMEAParserData::ERROR_OK;
+	return pFix;
 }
 
-CNMEAParserData::ERROR_E CNMEAParser::GetBDGSA(CNMEAParserData::GSA_DATA_T & sentenseData)
+void CNMEAParser::FlushFix(void)
 {
 	DataAccessSemaphoreLock();
-	sentenseData = m_BDGSA.GetSentenceData();
+	m_Epochs.Flush();
 	DataAccessSemaphoreUnlock();
-	return CNMEAParserData::ERROR_OK;
 }
 
-CNMEAParserData::ERROR_E CNMEAParser::GetGAGGA(CNMEAParserData::GGA_DATA_T & sentenseData)
+void CNMEAParser::GetKinematicState(CNMEAParserData::KINEMATIC_STATE_T & state) const
+{
+	uint32_t uVersion;
+	m_KinematicSnapshot.Read(state, uVersion);
+}
+
+void CNMEAParser::ExtrapolateKinematicState(int64_t nTimeNs, CNMEAParserData::KINEMATIC_STATE_T & state) const
+{
+	CNMEAParserData::KINEMATIC_STATE_T last;
+	GetKinematicState(last);
+	CNMEAKinematicFilter::Extrapolate(last, nTimeNs, c_dMaxExtrapolation, state);
+}
+
+void CNMEAParser::GetClockFit(CNMEAParserData::CLOCK_FIT_T & fit) const
+{
+	uint32_t uVersion;
+	m_Clock.GetSnapshot().Read(fit, uVersion);
+}
+
+bool CNMEAParser::UTCToHostNs(double dUTC, int64_t & nHostNs) const
 {
+	CNMEAParserData::CLOCK_FIT_T fit;
+	GetClockFit(fit);
+	return CNMEAClockCorrelator::UTCToHost(fit, dUTC, nHostNs);
+}
+
+bool CNMEAParser::HostNsToUTC(int64_t nHostNs, double & dUTC) const
+{
+	CNMEAParserData::CLOCK_FIT_T fit;
+	GetClockFit(fit);
+	return CNMEAClockCorrelator::HostToUTC(fit, nHostNs, dUTC);
+}
+
+CNMEAParserData::ERROR_E CNMEAParser::Unsubscribe(uint32_t uID)
+{
+	CNMEAParserData::ERROR_E nErr = CNMEAParserData::ERROR_FAIL;
 	DataAccessSemaphoreLock();
-	sentenseData = m_GAGGA.GetSentenceData();
+	for (size_t i = 0; i < m_Subscriptions.size(); i++)
+	{
+		if (m_Subscriptions[i].uID == uID)
+		{
+			m_Subscriptions.erase(m_Subscriptions.begin() + i);
+			nErr = CNMEAParserData::ERROR_OK;
+			break;
+		}
+	}
+	for (size_t i = 0; i < m_FixSubscriptions.size(); i++)
+	{
+		if (m_FixSubscriptions[i].uID == uID)
+		{
+			m_FixSubscriptions.erase(m_FixSubscriptions.begin() + i);
+			nErr = CNMEAParserData::ERROR_OK;
+			break;
+		}
+	}
+	for (size_t i = 0; i < m_RawSubscriptions.size(); i++)
+	{
+		if (m_RawSubscriptions[i].uID == uID)
+		{
+			m_RawSubscriptions.erase(m_RawSubscriptions.begin() + i);
+			nErr = CNMEAParserData::ERROR_OK;
+			break;
+		}
+	}
 	DataAccessSemaphoreUnlock();
-	return CNMEAParserData::ERROR_OK;
+	return nErr;
 }
 
-CNMEAParserData::ERROR_E CNMEAParser::GetGAGSV(CNMEAParserData::GSV_DATA_T & sentenseData)
+uint32_t CNMEAParser::AddSubscription(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID, const SENTENCE_CALLBACK_T & callback)
 {
+	SUBSCRIPTION_T subscription;
+	subscription.nTalkerID = nTalkerID;
+	subscription.nSentenceID = nSentenceID;
+	subscription.callback = callback;
+
 	DataAccessSemaphoreLock();
-	sentenseData = m_GAGSV.GetSentenceData();
+	subscription.uID = m_uNextSubscriptionID++;
+	m_Subscriptions.push_back(subscription);
 	DataAccessSemaphoreUnlock();
-	return CNMEAParserData::ERROR_OK;
+
+	return subscription.uID;
 }
 
+void CNMEAParser::NotifySubscribers(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID, const CNMEASentenceBase * pSentence)
+{
+	CNMEAParserData::SENTENCE_INFO_T info;
+	info.nTalkerID = nTalkerID;
+	info.nSentenceID = nSentenceID;
+	info.uSequence = m_uSequence;
+	info.nRxTimeNs = pSentence->GetRxTimeNs();
+
+	for (size_t i = 0; i < m_Subscriptions.size(); i++)
+	{
+		const SUBSCRIPTION_T &subscription = m_Subscriptions[i];
+		if (subscription.nSentenceID != nSentenceID ||
+			(subscription.nTalkerID != CNMEAParserData::TID_ANY && subscription.nTalkerID != nTalkerID))
+		{
+			continue;
+		}
+
+		subscription.callback(info, pSentence);
+	}
+}
 
-CNMEAParserData::ERROR_E CNMEAParser::GetGAGSA(CNMEAParserData::GSA_DATA_T & sentenseData)
+CNMEAParserData::ERROR_E CNMEAParser::GetTimingStatistics(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID, CNMEAHistogram & interArrival, CNMEAHistogram & latency)
 {
+	CNMEAParserData::ERROR_E nErr = CNMEAParserData::ERROR_FAIL;
+
 	DataAccessSemaphoreLock();
-	sentenseData = m_GAGSA.GetSentenceData();
+	const CNMEASentenceBase *pSentence = LookupSentence(nTalkerID, nSentenceID);
+	if (pSentence != NULL)
+	{
+		interArrival = pSentence->GetInterArrivalHistogram();
+		latency = pSentence->GetLatencyHistogram();
+		nErr = CNMEAParserData::ERROR_OK;
+	}
 	DataAccessSemaphoreUnlock();
-	return CNMEAParserData::ERROR_OK;
+
+	return nErr;
 }
 
-CNMEAParserData::ERROR_E CNMEAParser::GetGARMC(CNMEAParserData::RMC_DATA_T & sentenseData)
+void CNMEAParser::ResetTimingStatistics(void)
 {
 	DataAccessSemaphoreLock();
-	sentenseData = m_GARMC.GetSentenceData();
+	SENTENCE_TABLE_T *pTable = m_pTable.load(std::memory_order_relaxed);
+	for (int i = 0; i < pTable->nSize; i++)
+	{
+		CNMEASentenceBase *pSentence = pTable->pSlots[i].pSentence.load(std::memory_order_relaxed);
+		if (pSentence != NULL)
+		{
+			pSentence->ResetTiming();
+		}
+	}
 	DataAccessSemaphoreUnlock();
-	return CNMEAParserData::ERROR_OK;
+}
+
+int CNMEAParser::GetChangedSatellites(uint32_t uSinceSerial, CNMEAParserData::SATELLITE_T * pSatellites, int nMaxSatellites, uint32_t & uSerial)
+{
+	DataAccessSemaphoreLock();
+	int nCount = m_Satellites.GetChanged(uSinceSerial, pSatellites, nMaxSatellites, uSerial);
+	DataAccessSemaphoreUnlock();
+	return nCount;
+}
+
+void CNMEAParser::UpdateSatelliteDatabase(CNMEAParserData::TALKER_ID_E nTalkerID, const CNMEASentenceGSV * pGSV)
+{
+	const CNMEAParserData::GSV_DATA_T &gsvData = pGSV->GetSentenceData();
+	if (gsvData.nSentenceNumber == 1)
+	{
+		m_Satellites.BeginSkyView(nTalkerID);
+		m_nGSVTalkerID = nTalkerID;
+		m_uGSVSkyView = m_Satellites.GetSkyView();
+	}
+	else if (m_nGSVNextSentence == 0 || gsvData.nSentenceNumber != m_nGSVNextSentence || nTalkerID != m_nGSVTalkerID || m_Satellites.GetSkyView() != m_uGSVSkyView)
+	{
+		//
+		// The start of this group was lost, or another group (talker or UBX NAV-SAT) began
+		// since. Its satellites would be merged into a sky view of another constellation.
+		//
+		m_nGSVNextSentence = 0;
+		return;
+	}
+	m_nGSVNextSentence = gsvData.nSentenceNumber + 1;
+
+	int nCount = 0;
+	const CNMEAParserData::SAT_INFO_T *pSatInfo = pGSV->GetSentenceSatellites(nCount);
+	if (nCount > 0)
+	{
+		int64_t nTimeNs = pGSV->GetRxTimeNs();
+		for (int i = 0; i < nCount; i++)
+		{
+			CNMEAParserData::CONSTELLATION_E nConstellation = CNMEASatelliteDatabase::GetConstellation(nTalkerID, pSatInfo[i].nPRN);
+			m_Satellites.UpdateSatellite(nConstellation, pSatInfo[i].nPRN, (int)pSatInfo[i].dElevation, (int)pSatInfo[i].dAzimuth, pSatInfo[i].nSNR, nTimeNs);
+		}
+	}
+
+	if (gsvData.nSentenceNumber == gsvData.nTotalNumberOfSentences)
+	{
+		m_Satellites.EndSkyView();
+		m_nGSVNextSentence = 0;
+	}
 }
 
 CNMEAParserData::ERROR_E CNMEAParser::ProcessRxCommand(char * pCmd, char * pData)
 {
+	DataAccessSemaphoreLock();
+	CNMEAParserData::ERROR_E nErr = DecodeSentence(pCmd, pData, GetRxTimeNs());
+	DataAccessSemaphoreUnlock();
+
+	return nErr;
+}
+
+void CNMEAParser::ProcessRxBatch(CNMEAParserData::SENTENCE_T * pSentences, uint32_t uCount)
+{
+	//
+	// One lock for the whole read instead of one per sentence
+	//
+	DataAccessSemaphoreLock();
+	for (uint32_t i = 0; i < uCount; i++)
+	{
+		DecodeSentence(pSentences[i].pCmd, pSentences[i].pData, pSentences[i].nRxTimeNs);
+	}
+	DataAccessSemaphoreUnlock();
+}
+
+CNMEAParserData::ERROR_E CNMEAParser::DecodeSentence(char * pCmd, char * pData, int64_t nRxTimeNs)
+{
+	if (m_RawSubscriptions.empty() == false)
+	{
+		CNMEAParserData::SENTENCE_T sentence;
+		sentence.pCmd = pCmd;
+		sentence.pData = pData;
+		sentence.nRxTimeNs = nRxTimeNs;
+		for (size_t i = 0; i < m_RawSubscriptions.size(); i++)
+		{
+			m_RawSubscriptions[i].callback(sentence);
+		}
+	}
 
 	//
-	// Grab the talker ID
+	// Only standard --XXX addresses are dispatched
 	//
-	uint16_t u16TalkerID = (uint16_t)((uint8_t)pCmd[0]) << 8;
-	u16TalkerID |= (uint16_t)((uint8_t)pCmd[1]);
+	CNMEAParserData::TALKER_ID_E nTalkerID;
+	CNMEAParserData::SENTENCE_ID_E nSentenceID;
+	if (ParseAddress(pCmd, nTalkerID, nSentenceID) == false)
+	{
+		return CNMEAParserData::ERROR_OK;
+	}
+
+	CNMEASentenceBase *pSentence = FindSentence(nTalkerID, nSentenceID, true);
+	if (pSentence == NULL)
+	{
+		NMEA_TRACE_SENTENCE(CNMEATrace::TRACE_UNSUPPORTED, nTalkerID, nSentenceID, CNMEAParserData::ERROR_OK);
+		return CNMEAParserData::ERROR_OK;
+	}
+
+	CNMEAParserData::ERROR_E nErr = pSentence->ProcessSentence(pCmd, pData);
 
 	//
-	// Get the sentence ID, --XXX where XXX is the sentence ID
+	// Sentences handed straight to ProcessRxCommand() were not framed here and have no
+	// start of message time, time them at decode.
 	//
-	char *lpszSentenceID = &pCmd[2];
-
-	printf("Cmd: %s, TalkerID:%c%c, Sentence ID: %s\n", pCmd, (u16TalkerID >> 8) & 0xFF, (u16TalkerID) & 0xFF, lpszSentenceID);
-
-
-	//-----------------------------------------------------------------------------
-	if (strcmp(pCmd, "GPGGA") == 0) {
-		DataAccessSemaphoreLock();
-		m_GPGGA.ProcessSentence(pCmd, pData);
-		m_GPGSA.FlagReceivedGGA();
-		DataAccessSemaphoreUnlock();
-	}
-	else if (strcmp(pCmd, "GNGGA") == 0) {
-		DataAccessSemaphoreLock();
-		m_GNGGA.ProcessSentence(pCmd, pData);
-		m_GNGSA.FlagReceivedGGA();
-		DataAccessSemaphoreUnlock();
-	}
-	else if (strcmp(pCmd, "GPGSV") == 0) {
-		DataAccessSemaphoreLock();
-		m_GPGSV.ProcessSentence(pCmd, pData);
-		DataAccessSemaphoreUnlock();
-	}
-	else if (strcmp(pCmd, "GPGSA") == 0) {
-		DataAccessSemaphoreLock();
-		m_GPGSA.ProcessSentence(pCmd, pData);
-		DataAccessSemaphoreUnlock();
-	}
-	else if (strcmp(pCmd, "GPRMC") == 0) {
-		DataAccessSemaphoreLock();
-		m_GPRMC.ProcessSentence(pCmd, pData);
-		DataAccessSemaphoreUnlock();
-	}
-	else if (strcmp(pCmd, "GNRMC") == 0) {
-		DataAccessSemaphoreLock();
-		m_GNRMC.ProcessSentence(pCmd, pData);
-		DataAccessSemaphoreUnlock();
-	}
-	else if (strcmp(pCmd, "GAGGA") == 0) {
-		DataAccessSemaphoreLock();
-		m_GAGGA.ProcessSentence(pCmd, pData);
-		m_GAGSA.FlagReceivedGGA();
-		DataAccessSemaphoreUnlock();
-	}
-	else if (strcmp(pCmd, "GAGSV") == 0) {
-		DataAccessSemaphoreLock();
-		m_GAGSV.ProcessSentence(pCmd, pData);
-		DataAccessSemaphoreUnlock();
-	}
-	else if (strcmp(pCmd, "GAGSA") == 0) {
-		DataAccessSemaphoreLock();
-		m_GAGSA.ProcessSentence(pCmd, pData);
-		DataAccessSemaphoreUnlock();
-	}
-	else if (strcmp(pCmd, "GARMC") == 0) {
-		DataAccessSemaphoreLock();
-		m_GARMC.ProcessSentence(pCmd, pData);
-		DataAccessSemaphoreUnlock();
-	}
-	else if (strcmp(pCmd, "GNGSA") == 0) {
-        DataAccessSemaphoreLock();
-        m_GNGSA.ProcessSentence(pCmd, pData);
-        DataAccessSemaphoreUnlock();
-    }
-    else if (strcmp(pCmd, "GLGSV") == 0) {
-		DataAccessSemaphoreLock();
-		m_GLGSV.ProcessSentence(pCmd, pData);
-		DataAccessSemaphoreUnlock();
-	}
-    else if (strcmp(pCmd, "GLGSA") == 0) {
-		DataAccessSemaphoreLock();
-		m_GLGSA.ProcessSentence(pCmd, pData);
-		DataAccessSemaphoreUnlock();
-	}
-
-	else if (strcmp(pCmd, "QZGSV") == 0) {
-		DataAccessSemaphoreLock();
-		m_QZGSV.ProcessSentence(pCmd, pData);
-		DataAccessSemaphoreUnlock();
-	}
-	else if (strcmp(pCmd, "QZGSA") == 0) {
-		DataAccessSemaphoreLock();
-		m_QZGSA.ProcessSentence(pCmd, pData);
-		DataAccessSemaphoreUnlock();
-	}
-
-	else if (strcmp(pCmd, "BDGSV") == 0) {
-		DataAccessSemaphoreLock();
-		m_BDGSV.ProcessSentence(pCmd, pData);
-		DataAccessSemaphoreUnlock();
-	}
-	else if (strcmp(pCmd, "BDGSA") == 0) {
-		DataAccessSemaphoreLock();
-		m_BDGSA.ProcessSentence(pCmd, pData);
-		DataAccessSemaphoreUnlock();
+	int64_t nDecodedNs = CNMEAClock::GetTimeNs();
+	pSentence->RecordTiming(nRxTimeNs != 0 ? nRxTimeNs : nDecodedNs, nDecodedNs);
+	NMEA_TRACE_SENTENCE(CNMEATrace::TRACE_SENTENCE, nTalkerID, nSentenceID, nErr);
+	if (nSentenceID == CNMEAParserData::SID_GSV)
+	{
+		UpdateSatelliteDatabase(nTalkerID, static_cast<const CNMEASentenceGSV *>(pSentence));
+		m_Epochs.SetSatelliteSerial(m_Satellites.GetSerial());
+	}
+	if (nErr == CNMEAParserData::ERROR_OK)
+	{
+		PublishSentence(nTalkerID, nSentenceID, pSentence);
 	}
 
+	//
+	// A GGA starts a new position update, let the same talker's GSA know about it
+	//
+	if (nSentenceID == CNMEAParserData::SID_GGA)
+	{
+		CNMEASentenceGSA *pGSA = static_cast<CNMEASentenceGSA *>(FindSentence(nTalkerID, CNMEAParserData::SID_GSA));
+		if (pGSA != NULL)
+		{
+			pGSA->FlagReceivedGGA();
+		}
+	}
 
-	return CNMEAParserData::ERROR_OK;
+	return nErr;
 }
 
+void CNMEAParser::PublishSentence(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID, CNMEASentenceBase * pSentence)
+{
+	m_uSequence++;
+	if (m_Subscriptions.empty() == false)
+	{
+		NotifySubscribers(nTalkerID, nSentenceID, pSentence);
+	}
+	m_Epochs.AddSentence(nTalkerID, nSentenceID, pSentence, pSentence->GetRxTimeNs());
+}
+
+void CNMEAParser::EnableUBX(bool bEnable)
+{
+	m_UBX.Reset();
+	SetUBXPacket(bEnable ? &m_UBX : NULL);
+}
+
+void CNMEAParser::DecodeUBXMessage(uint8_t uClass, uint8_t uID, const uint8_t * pPayload, uint16_t uLength, int64_t nRxTimeNs)
+{
+	if (uClass != CNMEAUBX::c_uClassNAV)
+	{
+		return;
+	}
+
+	//
+	// Lock access to data
+	//
+	DataAccessSemaphoreLock();
+
+	bool bPublishGSA = false;
+	switch (uID)
+	{
+	case CNMEAUBX::c_uIdNavPVT:
+		{
+			CNMEASentenceGGA *pGGA = static_cast<CNMEASentenceGGA *>(FindSentence(CNMEAParserData::TID_UBX, CNMEAParserData::SID_GGA, true));
+			CNMEASentenceRMC *pRMC = static_cast<CNMEASentenceRMC *>(FindSentence(CNMEAParserData::TID_UBX, CNMEAParserData::SID_RMC, true));
+			CNMEASentenceVTG *pVTG = static_cast<CNMEASentenceVTG *>(FindSentence(CNMEAParserData::TID_UBX, CNMEAParserData::SID_VTG, true));
+			if (pGGA == NULL || pRMC == NULL || pVTG == NULL)
+			{
+				break;
+			}
+
+			CNMEAParserData::GGA_DATA_T ggaData = pGGA->GetSentenceData();
+			CNMEAParserData::RMC_DATA_T rmcData;
+			CNMEAParserData::VTG_DATA_T vtgData;
+			if (CNMEAUBX::DecodeNavPVT(pPayload, uLength, ggaData, rmcData, vtgData, m_UBXGSA.nMode) != CNMEAParserData::ERROR_OK)
+			{
+				NMEA_TRACE_SENTENCE(CNMEATrace::TRACE_SENTENCE, CNMEAParserData::TID_UBX, CNMEAParserData::SID_GGA, CNMEAParserData::ERROR_FAIL);
+				break;
+			}
+			ggaData.m_dHDOP = m_UBXGSA.dHDOP;
+
+			int64_t nDecodedNs = CNMEAClock::GetTimeNs();
+			pGGA->SetSentenceData(ggaData);
+			pGGA->RecordTiming(nRxTimeNs, nDecodedNs);
+			PublishSentence(CNMEAParserData::TID_UBX, CNMEAParserData::SID_GGA, pGGA);
+			pRMC->SetSentenceData(rmcData);
+			pRMC->RecordTiming(nRxTimeNs, nDecodedNs);
+			PublishSentence(CNMEAParserData::TID_UBX, CNMEAParserData::SID_RMC, pRMC);
+			pVTG->SetSentenceData(vtgData);
+			pVTG->RecordTiming(nRxTimeNs, nDecodedNs);
+			PublishSentence(CNMEAParserData::TID_UBX, CNMEAParserData::SID_VTG, pVTG);
+		}
+		break;
+
+	case CNMEAUBX::c_uIdNavDOP:
+		bPublishGSA = CNMEAUBX::DecodeNavDOP(pPayload, uLength, m_UBXGSA) == CNMEAParserData::ERROR_OK && m_bUBXSatellites == false;
+		break;
+
+	case CNMEAUBX::c_uIdNavSAT:
+		if (CNMEAUBX::DecodeNavSAT(pPayload, uLength, m_Satellites, nRxTimeNs, m_UBXGSA) == CNMEAParserData::ERROR_OK)
+		{
+			m_Epochs.SetSatelliteSerial(m_Satellites.GetSerial());
+			m_bUBXSatellites = true;
+			bPublishGSA = true;
+		}
+		break;
+
+	default:
+		break;
+	}
+
+	//
+	// One GSA per epoch: from NAV-SAT if the receiver sends it, NAV-DOP otherwise
+	//
+	if (bPublishGSA)
+	{
+		CNMEASentenceGSA *pGSA = static_cast<CNMEASentenceGSA *>(FindSentence(CNMEAParserData::TID_UBX, CNMEAParserData::SID_GSA, true));
+		if (pGSA != NULL)
+		{
+			pGSA->SetSentenceData(m_UBXGSA);
+			pGSA->RecordTiming(nRxTimeNs, CNMEAClock::GetTimeNs());
+			PublishSentence(CNMEAParserData::TID_UBX, CNMEAParserData::SID_GSA, pGSA);
+		}
+	}
+
+	//
+	// Unlock access to data
+	//
+	DataAccessSemaphoreUnlock();
+}
@@ -26,7 +26,9 @@
 #pragma once
 #include <cstddef>
 #include <stdint.h>
-#include <map>
+#include <atomic>
+#include <functional>
+#include <vector>
 
 #include "NMEAParserData.h"
 #include "NMEAParserPacket.h"
@@ -34,6 +36,17 @@
 #include "NMEASentenceGSV.h"
 #include "NMEASentenceGSA.h"
 #include "NMEASentenceRMC.h"
+#include "NMEASentenceVTG.h"
+#include "NMEASentenceZDA.h"
+#include "NMEASentenceGST.h"
+#include "NMEASentenceGLL.h"
+#include "NMEASentenceHDT.h"
+#include "NMEASatelliteDatabase.h"
+#include "NMEAEpochAssembler.h"
+#include "NMEAKinematicFilter.h"
+#include "NMEAClockCorrelator.h"
+#include "NMEASnapshot.h"
+#include "NMEAUBXPacket.h"
 
 ///
 /// \class CNMEAParser
@@ -41,36 +54,96 @@
 ///
 class CNMEAParser : public CNMEAParserPacket {
 
+public:
+	static const int	c_nInitialSentenceSlots = 64;							///< Initial size of the (talker, sentence) dispatch table, doubled when 3/4 full. Must be a power of two.
+
 private:
+	///
+	/// \brief Dispatch table entry. A sentence object is created the first time its (talker, sentence) pair is received.
+	///
+	/// Slots are only ever added, by the parser thread: the sentence pointer is stored
+	/// before the key is released, so other threads can look pairs up without a lock.
+	///
+	typedef struct _SENTENCE_SLOT_T {
+		std::atomic<uint64_t>			uKey;									///< Packed talker and sentence ID, 0 if the slot is empty
+		std::atomic<CNMEASentenceBase *>	pSentence;							///< Sentence object that owns the data for this pair
+	} SENTENCE_SLOT_T;
+
+	///
+	/// \brief One generation of the dispatch table
+	///
+	/// A table that gets too full is copied into one twice its size, which is then published.
+	/// The old generation stays allocated until the parser is destroyed, so a lookup that
+	/// started on it from another thread stays safe.
+	///
+	typedef struct _SENTENCE_TABLE_T {
+		int					nSize;												///< Number of slots, a power of two
+		SENTENCE_SLOT_T *	pSlots;												///< Open addressed (talker, sentence) slots
+	} SENTENCE_TABLE_T;
 
-	// GPS
-	CNMEASentenceGGA	m_GPGGA;												///< GPGGA Specific sentence data
-	CNMEASentenceGSV	m_GPGSV;												///< GPGSV Satellite message (GPS)
-	CNMEASentenceGSA	m_GPGSA;												///< GPGSA GNSS DOP and active satellites
-	CNMEASentenceRMC	m_GPRMC;												///< GPRMC Recommended minimum data for GPS
+	std::atomic<SENTENCE_TABLE_T *>	m_pTable;									///< Current dispatch table
+	std::vector<SENTENCE_TABLE_T *>	m_Tables;									///< All table generations, released by the destructor
+	int					m_nSlotCount;											///< Number of slots in use
 
-	// Galileo
-	CNMEASentenceGGA	m_GAGGA;												///< GAGGA Specific sentence data
-	CNMEASentenceGSV	m_GAGSV;												///< GAGSV Satellite message (GPS)
-	CNMEASentenceGSA	m_GAGSA;												///< GAGSA GNSS DOP and active satellites
-	CNMEASentenceRMC	m_GARMC;												///< GARMC Recommended minimum data for GPS
+	typedef std::function<void(const CNMEAParserData::SENTENCE_INFO_T &, const CNMEASentenceBase *)> SENTENCE_CALLBACK_T;
 
-	// GNSS
-	CNMEASentenceGGA	m_GNGGA;												///< GAGGA Specific sentence data
-	CNMEASentenceGSA	m_GNGSA;												///< GNGSA GNSS DOP and active satellites (usually GPS and GLONASS but can be GLONASS only)
-	CNMEASentenceRMC	m_GNRMC;												///< GNRMC Recommended minimum data for GPS
+	///
+	/// \brief Subscription entry. The typed callback is wrapped so all sentence types share one list.
+	///
+	typedef struct _SUBSCRIPTION_T {
+		uint32_t							uID;								///< ID returned to the subscriber
+		CNMEAParserData::TALKER_ID_E		nTalkerID;							///< Talker filter, TID_ANY for all talkers
+		CNMEAParserData::SENTENCE_ID_E		nSentenceID;						///< Sentence the callback is interested in
+		SENTENCE_CALLBACK_T					callback;							///< Wrapped callback
+	} SUBSCRIPTION_T;
+
+	typedef std::function<void(const CNMEAParserData::SENTENCE_T &)> RAW_CALLBACK_T;
+
+	///
+	/// \brief Raw sentence subscription entry
+	///
+	typedef struct _RAW_SUBSCRIPTION_T {
+		uint32_t							uID;								///< ID returned to the subscriber
+		RAW_CALLBACK_T						callback;							///< Callback
+	} RAW_SUBSCRIPTION_T;
+
+	///
+	/// \brief Fix record subscription entry
+	///
+	typedef struct _FIX_SUBSCRIPTION_T {
+		uint32_t							uID;								///< ID returned to the subscriber
+		CNMEAEpochAssembler::FIX_CALLBACK_T	callback;							///< Callback
+	} FIX_SUBSCRIPTION_T;
 
-	// GLONASS
-	CNMEASentenceGSV	m_GLGSV;												///< GLGSV Satellite message (GLONASS)
-    CNMEASentenceGSA	m_GLGSA;												///< GLGSA GNSS DOP and active satellites
+	std::vector<SUBSCRIPTION_T>	m_Subscriptions;								///< Active subscriptions
+	std::vector<FIX_SUBSCRIPTION_T>	m_FixSubscriptions;						///< Active fix record subscriptions
+	std::vector<RAW_SUBSCRIPTION_T>	m_RawSubscriptions;						///< Active raw sentence subscriptions
+	uint32_t			m_uNextSubscriptionID;									///< Next ID handed out by Subscribe*()
+	uint32_t			m_uSequence;											///< Number of sentences decoded so far
+	CNMEASatelliteDatabase	m_Satellites;										///< Satellites of all talkers, fed by GSV
+	CNMEAParserData::TALKER_ID_E	m_nGSVTalkerID;								///< Talker of the GSV group being fed into m_Satellites
+	uint32_t			m_uGSVSkyView;											///< m_Satellites sky view started by that group
+	int					m_nGSVNextSentence;										///< Next sentence number expected in that group, 0 if none is open
+	CNMEAEpochAssembler	m_Epochs;												///< Merges the sentences of each epoch into a fix record
+	CNMEAClockCorrelator	m_Clock;											///< Maps fix UTC to the host clock, fed by m_Epochs
+	CNMEAKinematicFilter	m_Kinematics;										///< Smooths the fix records, fed by m_Epochs
+	CNMEASnapshot<CNMEAParserData::KINEMATIC_STATE_T>	m_KinematicSnapshot;	///< Last m_Kinematics state, readable from other threads
 
-	// GeiDou
-	CNMEASentenceGSV	m_QZGSV;												///< QZGSV Satellite message (BeiDou)
-	CNMEASentenceGSA	m_QZGSA;												///< QZGSA GNSS DOP and active satellites
+	///
+	/// \brief Hands the UBX frames found in the stream to the parser
+	///
+	class CUBXFramer : public CNMEAUBXPacket {
+	public:
+		CNMEAParser *	m_pParser;												///< Parser that decodes the messages
+		CUBXFramer() : m_pParser(NULL) {}
+		virtual void OnUBXError(CNMEAParserData::ERROR_E nError, uint8_t uClass, uint8_t uID) { UNUSED_PARAM(uClass); UNUSED_PARAM(uID); m_pParser->OnError(nError, NULL); }
+	protected:
+		virtual void ProcessUBXMessage(uint8_t uClass, uint8_t uID, const uint8_t *pPayload, uint16_t uLength, int64_t nRxTimeNs) { m_pParser->DecodeUBXMessage(uClass, uID, pPayload, uLength, nRxTimeNs); }
+	};
 
-	// QZSS
-	CNMEASentenceGSV	m_BDGSV;												///< BDGSV Satellite message (QZSS)
-	CNMEASentenceGSA	m_BDGSA;												///< BDGSA GNSS DOP and active satellites
+	CUBXFramer			m_UBX;													///< UBX framer, used when EnableUBX() is on
+	CNMEAParserData::GSA_DATA_T	m_UBXGSA;										///< GSA data collected from NAV-PVT, NAV-DOP and NAV-SAT
+	bool				m_bUBXSatellites;										///< NAV-SAT was received, it publishes the UBX GSA instead of NAV-DOP
 
 public:
 	CNMEAParser();
@@ -82,123 +155,289 @@ public:
 	void ResetData(void);
 
 	///
-	/// \brief Places a copy of the GPGGA data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGGA object to place the data into.
-	/// \return Returns ERROR_OK if successful.
+	/// \brief Decodes u-blox UBX messages mixed into the NMEA stream
+	///
+	/// NAV-PVT, NAV-DOP and NAV-SAT are decoded into the GGA, RMC, VTG and GSA objects of the
+	/// pseudo talker TID_UBX and into the satellite database. They are passed to subscriptions
+	/// and merged into fix records like the NMEA sentences, ie: GetGGA(TID_UBX, ...) or
+	/// SubscribeGGA(TID_UBX, ...). Other UBX messages are skipped.
+	///
+	/// \param bEnable true to take UBX frames out of the stream, false for NMEA only (the default)
+	///
+	void EnableUBX(bool bEnable);
+
+	///
+	/// \brief Places a copy of the --GGA data for the given talker into sentenseData
+	/// \param nTalkerID Talker ID, ie: TID_GP, TID_GN, etc...
+	/// \param sentenseData reference to a GGA_DATA_T structure to place the data into.
+	/// \return Returns ERROR_OK if successful, ERROR_FAIL (and default data) if this talker has not sent the sentence yet.
+	///
+	CNMEAParserData::ERROR_E GetGGA(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::GGA_DATA_T & sentenseData);
+
+	///
+	/// \brief Places a copy of the --GSV data for the given talker into sentenseData
+	/// \param nTalkerID Talker ID, ie: TID_GP, TID_GL, etc...
+	/// \param sentenseData reference to a GSV_DATA_T structure to place the data into.
+	/// \return Returns ERROR_OK if successful, ERROR_FAIL (and default data) if this talker has not sent the sentence yet.
+	///
+	CNMEAParserData::ERROR_E GetGSV(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::GSV_DATA_T & sentenseData);
+
+	///
+	/// \brief Places a copy of the --GSA data for the given talker into sentenseData
+	/// \param nTalkerID Talker ID, ie: TID_GP, TID_GN, etc...
+	/// \param sentenseData reference to a GSA_DATA_T structure to place the data into.
+	/// \return Returns ERROR_OK if successful, ERROR_FAIL (and default data) if this talker has not sent the sentence yet.
+	///
+	CNMEAParserData::ERROR_E GetGSA(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::GSA_DATA_T & sentenseData);
+
+	///
+	/// \brief Places a copy of the --RMC data for the given talker into sentenseData
+	/// \param nTalkerID Talker ID, ie: TID_GP, TID_GN, etc...
+	/// \param sentenseData reference to a RMC_DATA_T structure to place the data into.
+	/// \return Returns ERROR_OK if successful, ERROR_FAIL (and default data) if this talker has not sent the sentence yet.
+	///
+	CNMEAParserData::ERROR_E GetRMC(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::RMC_DATA_T & sentenseData);
+
+	///
+	/// \brief Places a copy of the --VTG data for the given talker into sentenseData
+	/// \param nTalkerID Talker ID, ie: TID_GP, TID_GN, etc...
+	/// \param sentenseData reference to a VTG_DATA_T structure to place the data into.
+	/// \return Returns ERROR_OK if successful, ERROR_FAIL (and cleared data) if this talker has not sent the sentence yet.
+	///
+	CNMEAParserData::ERROR_E GetVTG(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::VTG_DATA_T & sentenseData);
+
+	///
+	/// \brief Places a copy of the --ZDA data for the given talker into sentenseData. See GetVTG().
+	///
+	CNMEAParserData::ERROR_E GetZDA(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::ZDA_DATA_T & sentenseData);
+
+	///
+	/// \brief Places a copy of the --GST data for the given talker into sentenseData. See GetVTG().
+	///
+	CNMEAParserData::ERROR_E GetGST(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::GST_DATA_T & sentenseData);
+
+	///
+	/// \brief Places a copy of the --GLL data for the given talker into sentenseData. See GetVTG().
+	///
+	CNMEAParserData::ERROR_E GetGLL(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::GLL_DATA_T & sentenseData);
+
+	///
+	/// \brief Places a copy of the --HDT data for the given talker (ie: TID_HE, TID_GP) into sentenseData. See GetVTG().
+	///
+	CNMEAParserData::ERROR_E GetHDT(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::HDT_DATA_T & sentenseData);
+
+	///
+	/// \brief Lock free read of the latest published --GGA data for the given talker
+	///
+	/// Does not use DataAccessSemaphoreLock(); safe to call from any thread while the parser
+	/// thread is decoding. Nothing is copied if the caller already has the latest version.
+	///
+	/// \param nTalkerID Talker ID, ie: TID_GP, TID_GN, etc...
+	/// \param sentenseData reference to a GGA_DATA_T structure to place the data into.
+	/// \param uVersion Version the caller has (start with 0). Updated when new data is copied.
+	/// \return ERROR_OK if new data was copied, ERROR_NO_CHANGE if uVersion is current, ERROR_FAIL if the talker has not sent the sentence yet.
+	///
+	CNMEAParserData::ERROR_E ReadGGA(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::GGA_DATA_T & sentenseData, uint32_t & uVersion) const;
+
+	///
+	/// \brief Lock free read of the latest complete --GSV data (all sentences of a group) for the given talker. See ReadGGA().
+	///
+	CNMEAParserData::ERROR_E ReadGSV(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::GSV_DATA_T & sentenseData, uint32_t & uVersion) const;
+
+	///
+	/// \brief Lock free read of the latest published --GSA data for the given talker. See ReadGGA().
+	///
+	CNMEAParserData::ERROR_E ReadGSA(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::GSA_DATA_T & sentenseData, uint32_t & uVersion) const;
+
+	///
+	/// \brief Lock free read of the latest published --RMC data for the given talker. See ReadGGA().
+	///
+	CNMEAParserData::ERROR_E ReadRMC(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::RMC_DATA_T & sentenseData, uint32_t & uVersion) const;
+
+	///
+	/// \brief Copies the satellites (all constellations) that changed since a given serial
+	///
+	/// See CNMEASatelliteDatabase::GetChanged(). Start with uSinceSerial 0 to get every satellite.
+	///
+	/// \param uSinceSerial Serial the caller already has
+	/// \param pSatellites Array to receive the changed satellites
+	/// \param nMaxSatellites Size of pSatellites, CNMEASatelliteDatabase::c_nMaxSatellites to always get every change
+	/// \param uSerial Returned serial to pass as uSinceSerial next time
+	/// \return Number of satellites copied
+	///
+	int GetChangedSatellites(uint32_t uSinceSerial, CNMEAParserData::SATELLITE_T *pSatellites, int nMaxSatellites, uint32_t & uSerial);
+
+	///
+	/// \brief Copies the timing histograms of a (talker, sentence) pair
+	///
+	/// Times are in nanoseconds of the monotonic clock, taken when the '$' of a sentence
+	/// arrives. Inter-arrival is the time between consecutive sentences of the pair, latency
+	/// the time from '$' until the sentence was decoded.
+	///
+	/// \param nTalkerID Talker ID
+	/// \param nSentenceID Sentence ID
+	/// \param interArrival Returned inter-arrival histogram
+	/// \param latency Returned latency histogram
+	/// \return ERROR_OK if the sentence has been received, ERROR_FAIL otherwise
 	///
-	CNMEAParserData::ERROR_E GetGPGGA(CNMEAParserData::GGA_DATA_T & sentenseData);
+	CNMEAParserData::ERROR_E GetTimingStatistics(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID, CNMEAHistogram &interArrival, CNMEAHistogram &latency);
 
 	///
-	/// \brief Places a copy of the GNGGA data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGGA object to place the data into.
-	/// \return Returns ERROR_OK if successful.
+	/// \brief Clears the timing histograms of every sentence
 	///
-	CNMEAParserData::ERROR_E GetGNGGA(CNMEAParserData::GGA_DATA_T & sentenseData);
+	void ResetTimingStatistics(void);
 
 	///
-	/// \brief Places a copy of the GPGSV data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSV object to place the data into.
-	/// \return Returns ERROR_OK if successful.
+	/// \brief Returns the satellite database
 	///
-	CNMEAParserData::ERROR_E GetGPGSV(CNMEAParserData::GSV_DATA_T & sentenseData);
+	/// Use it from subscription callbacks, or between DataAccessSemaphoreLock() and
+	/// DataAccessSemaphoreUnlock() when the parser runs on another thread.
+	///
+	const CNMEASatelliteDatabase &GetSatelliteDatabase(void) const { return m_Satellites; }
+
+	typedef std::function<void(const CNMEAParserData::SENTENCE_INFO_T &, const CNMEAParserData::GGA_DATA_T &)> GGA_CALLBACK_T;
+	typedef std::function<void(const CNMEAParserData::SENTENCE_INFO_T &, const CNMEAParserData::GSV_DATA_T &)> GSV_CALLBACK_T;
+	typedef std::function<void(const CNMEAParserData::SENTENCE_INFO_T &, const CNMEAParserData::GSA_DATA_T &)> GSA_CALLBACK_T;
+	typedef std::function<void(const CNMEAParserData::SENTENCE_INFO_T &, const CNMEAParserData::RMC_DATA_T &)> RMC_CALLBACK_T;
 
 	///
-	/// \brief Places a copy of the GPGSA data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
-	/// \return Returns ERROR_OK if successful.
+	/// \brief Calls callback once for every --GGA sentence decoded from the given talker
+	///
+	/// Callbacks run on the thread that calls ProcessNMEABuffer(), right after the sentence was
+	/// decoded and while the data lock is held. Use the data passed in rather than GetGGA(), and
+	/// do not call Subscribe*() or Unsubscribe() from a callback.
+	///
+	/// \param nTalkerID Talker ID, ie: TID_GP, or TID_ANY for all talkers
+	/// \param callback Function to call with the sentence information and decoded data
+	/// \return Subscription ID to pass to Unsubscribe()
 	///
-	CNMEAParserData::ERROR_E GetGPGSA(CNMEAParserData::GSA_DATA_T & sentenseData);
+	uint32_t SubscribeGGA(CNMEAParserData::TALKER_ID_E nTalkerID, const GGA_CALLBACK_T &callback);
 
 	///
-	/// \brief Places a copy of the GPRMC data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
-	/// \return Returns ERROR_OK if successful.
+	/// \brief Calls callback once for every --GSV sentence decoded from the given talker. See SubscribeGGA().
 	///
-	CNMEAParserData::ERROR_E GetGPRMC(CNMEAParserData::RMC_DATA_T & sentenseData);
+	/// The callback sees every sentence of a group; the sky view is complete when
+	/// nSentenceNumber equals nTotalNumberOfSentences.
+	///
+	uint32_t SubscribeGSV(CNMEAParserData::TALKER_ID_E nTalkerID, const GSV_CALLBACK_T &callback);
+
+	///
+	/// \brief Calls callback once for every --GSA sentence decoded from the given talker. See SubscribeGGA().
+	///
+	uint32_t SubscribeGSA(CNMEAParserData::TALKER_ID_E nTalkerID, const GSA_CALLBACK_T &callback);
 
 	///
-	/// \brief Places a copy of the GNRMC data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
-	/// \return Returns ERROR_OK if successful.
+	/// \brief Calls callback once for every --RMC sentence decoded from the given talker. See SubscribeGGA().
+	///
+	uint32_t SubscribeRMC(CNMEAParserData::TALKER_ID_E nTalkerID, const RMC_CALLBACK_T &callback);
+
+	///
+	/// \brief Calls callback once per navigation epoch with the merged fix record
+	///
+	/// The record holds every GGA, RMC, GSA, GSV, VTG, ZDA, GST, GLL and HDT sentence with the
+	/// same UTC time, see CNMEAEpochAssembler. It is called from the thread that feeds the
+	/// parser, after the sentence callbacks, with the same rules as SubscribeGGA(). The record
+	/// is immutable; keep the pointer to hold on to it.
 	///
-	CNMEAParserData::ERROR_E GetGNRMC(CNMEAParserData::RMC_DATA_T & sentenseData);
+	/// \param callback Function to call with every completed record
+	/// \return Subscription ID to pass to Unsubscribe()
+	///
+	uint32_t SubscribeFix(const CNMEAEpochAssembler::FIX_CALLBACK_T &callback);
 
 	///
-    /// \brief Places a copy of the GNGSA data into sentenseData
-    /// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
-    /// \return Returns ERROR_OK if successful.
-    ///
-    CNMEAParserData::ERROR_E GetGNGSA(CNMEAParserData::GSA_DATA_T & sentenseData);
+	/// \brief Calls callback for every sentence that passed the checksum, before it is decoded
+	///
+	/// Unsupported and proprietary sentences are included. pCmd and pData are only valid for
+	/// the duration of the call. Same rules as SubscribeGGA().
+	///
+	/// \param callback Function to call with the sentence address, data and receive time
+	/// \return Subscription ID to pass to Unsubscribe()
+	///
+	uint32_t SubscribeRaw(const RAW_CALLBACK_T &callback);
 
-    ///
-	/// \brief Places a copy of the GLGSV data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSV object to place the data into.
-	/// \return Returns ERROR_OK if successful.
 	///
-	CNMEAParserData::ERROR_E GetGLGSV(CNMEAParserData::GSV_DATA_T & sentenseData);
+	/// \brief Returns the last completed fix record, empty if no epoch was completed yet
+	///
+	CNMEAEpochAssembler::FIX_PTR_T GetLastFix(void);
 
 	///
-	/// \brief Places a copy of the GLGSA data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
-	/// \return Returns ERROR_OK if successful.
+	/// \brief Completes the epoch that is being assembled, ie: at the end of a log
 	///
-	CNMEAParserData::ERROR_E GetGLGSA(CNMEAParserData::GSA_DATA_T & sentenseData);
+	void FlushFix(void);
 
 	///
-	/// \brief Places a copy of the QZGSV data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSV object to place the data into.
-	/// \return Returns ERROR_OK if successful.
+	/// \brief Returns the smoothed position, velocity and climb rate after the last fix. Safe to call from any thread.
 	///
-	CNMEAParserData::ERROR_E GetQZGSV(CNMEAParserData::GSV_DATA_T & sentenseData);
+	void GetKinematicState(CNMEAParserData::KINEMATIC_STATE_T &state) const;
 
 	///
-	/// \brief Places a copy of the QZGSA data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
-	/// \return Returns ERROR_OK if successful.
+	/// \brief Predicts the smoothed state to a monotonic clock time, ie: the time the next frame is shown. Safe to call from any thread.
 	///
-	CNMEAParserData::ERROR_E GetQZGSA(CNMEAParserData::GSA_DATA_T & sentenseData);
+	/// \param nTimeNs Monotonic (steady) clock time in nanoseconds, see CNMEAClock::GetTimeNs()
+	/// \param state Returned state. Predictions stop 2 seconds after the last fix.
+	///
+	void ExtrapolateKinematicState(int64_t nTimeNs, CNMEAParserData::KINEMATIC_STATE_T &state) const;
 
 	///
-	/// \brief Places a copy of the BDGSV data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSV object to place the data into.
-	/// \return Returns ERROR_OK if successful.
+	/// \brief Returns the filter behind GetKinematicState(), to change its noise and latency settings before data is processed
 	///
-	CNMEAParserData::ERROR_E GetBDGSV(CNMEAParserData::GSV_DATA_T & sentenseData);
+	CNMEAKinematicFilter &GetKinematicFilter(void) { return m_Kinematics; }
 
 	///
-	/// \brief Places a copy of the QZGSA data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
-	/// \return Returns ERROR_OK if successful.
+	/// \brief Returns the fit between GNSS UTC and the host monotonic clock. Safe to call from any thread.
 	///
-	CNMEAParserData::ERROR_E GetBDGSA(CNMEAParserData::GSA_DATA_T & sentenseData);
+	void GetClockFit(CNMEAParserData::CLOCK_FIT_T &fit) const;
 
 	///
-	/// \brief Places a copy of the GAGGA data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGGA object to place the data into.
-	/// \return Returns ERROR_OK if successful.
+	/// \brief Converts a GNSS UTC time to the host monotonic clock. Safe to call from any thread.
+	///
+	/// \param dUTC UTC, seconds since 1970 (seconds since the first day seen before the receiver reported a date)
+	/// \param nHostNs Returned host time in nanoseconds, see CNMEAClock::GetTimeNs()
+	/// \return false if there is no fit yet
 	///
-	CNMEAParserData::ERROR_E GetGAGGA(CNMEAParserData::GGA_DATA_T & sentenseData);
+	bool UTCToHostNs(double dUTC, int64_t &nHostNs) const;
 
 	///
-	/// \brief Places a copy of the GAGSV data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSV object to place the data into.
-	/// \return Returns ERROR_OK if successful.
+	/// \brief Converts a host monotonic clock time to GNSS UTC. Safe to call from any thread.
 	///
-	CNMEAParserData::ERROR_E GetGAGSV(CNMEAParserData::GSV_DATA_T & sentenseData);
+	/// \param nHostNs Host time in nanoseconds, see CNMEAClock::GetTimeNs()
+	/// \param dUTC Returned UTC (seconds, see UTCToHostNs())
+	/// \return false if there is no fit yet
+	///
+	bool HostNsToUTC(int64_t nHostNs, double &dUTC) const;
 
 	///
-	/// \brief Places a copy of the GAGSA data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
-	/// \return Returns ERROR_OK if successful.
+	/// \brief Returns the correlator behind GetClockFit(), to change its latency and outlier settings before data is processed
 	///
-	CNMEAParserData::ERROR_E GetGAGSA(CNMEAParserData::GSA_DATA_T & sentenseData);
+	CNMEAClockCorrelator &GetClockCorrelator(void) { return m_Clock; }
 
 	///
-	/// \brief Places a copy of the GARMC data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
-	/// \return Returns ERROR_OK if successful.
+	/// \brief Removes a subscription
+	/// \param uID ID returned by one of the Subscribe*() methods
+	/// \return ERROR_OK if the subscription was removed, ERROR_FAIL if uID is unknown
 	///
-	CNMEAParserData::ERROR_E GetGARMC(CNMEAParserData::RMC_DATA_T & sentenseData);
+	CNMEAParserData::ERROR_E Unsubscribe(uint32_t uID);
+
+	//
+	// Talker specific accessors kept for existing callers
+	//
+	CNMEAParserData::ERROR_E GetGPGGA(CNMEAParserData::GGA_DATA_T & sentenseData) { return GetGGA(CNMEAParserData::TID_GP, sentenseData); }
+	CNMEAParserData::ERROR_E GetGNGGA(CNMEAParserData::GGA_DATA_T & sentenseData) { return GetGGA(CNMEAParserData::TID_GN, sentenseData); }
+	CNMEAParserData::ERROR_E GetGAGGA(CNMEAParserData::GGA_DATA_T & sentenseData) { return GetGGA(CNMEAParserData::TID_GA, sentenseData); }
+	CNMEAParserData::ERROR_E GetGPGSV(CNMEAParserData::GSV_DATA_T & sentenseData) { return GetGSV(CNMEAParserData::TID_GP, sentenseData); }
+	CNMEAParserData::ERROR_E GetGLGSV(CNMEAParserData::GSV_DATA_T & sentenseData) { return GetGSV(CNMEAParserData::TID_GL, sentenseData); }
+	CNMEAParserData::ERROR_E GetGAGSV(CNMEAParserData::GSV_DATA_T & sentenseData) { return GetGSV(CNMEAParserData::TID_GA, sentenseData); }
+	CNMEAParserData::ERROR_E GetQZGSV(CNMEAParserData::GSV_DATA_T & sentenseData) { return GetGSV(CNMEAParserData::TID_QZ, sentenseData); }
+	CNMEAParserData::ERROR_E GetBDGSV(CNMEAParserData::GSV_DATA_T & sentenseData) { return GetGSV(CNMEAParserData::TID_BD, sentenseData); }
+	CNMEAParserData::ERROR_E GetGPGSA(CNMEAParserData::GSA_DATA_T & sentenseData) { return GetGSA(CNMEAParserData::TID_GP, sentenseData); }
+	CNMEAParserData::ERROR_E GetGNGSA(CNMEAParserData::GSA_DATA_T & sentenseData) { return GetGSA(CNMEAParserData::TID_GN, sentenseData); }
+	CNMEAParserData::ERROR_E GetGLGSA(CNMEAParserData::GSA_DATA_T & sentenseData) { return GetGSA(CNMEAParserData::TID_GL, sentenseData); }
+	CNMEAParserData::ERROR_E GetGAGSA(CNMEAParserData::GSA_DATA_T & sentenseData) { return GetGSA(CNMEAParserData::TID_GA, sentenseData); }
+	CNMEAParserData::ERROR_E GetQZGSA(CNMEAParserData::GSA_DATA_T & sentenseData) { return GetGSA(CNMEAParserData::TID_QZ, sentenseData); }
+	CNMEAParserData::ERROR_E GetBDGSA(CNMEAParserData::GSA_DATA_T & sentenseData) { return GetGSA(CNMEAParserData::TID_BD, sentenseData); }
+	CNMEAParserData::ERROR_E GetGPRMC(CNMEAParserData::RMC_DATA_T & sentenseData) { return GetRMC(CNMEAParserData::TID_GP, sentenseData); }
+	CNMEAParserData::ERROR_E GetGNRMC(CNMEAParserData::RMC_DATA_T & sentenseData) { return GetRMC(CNMEAParserData::TID_GN, sentenseData); }
+	CNMEAParserData::ERROR_E GetGARMC(CNMEAParserData::RMC_DATA_T & sentenseData) { return GetRMC(CNMEAParserData::TID_GA, sentenseData); }
 
 protected:
 	///
@@ -210,6 +449,17 @@ protected:
 	///
 	virtual CNMEAParserData::ERROR_E ProcessRxCommand(char *pCmd, char *pData);
 
+	///
+	/// \brief This method is redefined from CNMEAParserPacket::ProcessRxBatch()
+	///
+	/// Decodes the whole batch under a single data lock. Note: ProcessRxCommand() is not
+	/// called for batched sentences, redefine this method as well if you capture sentences there.
+	///
+	/// \param pSentences Complete sentences, in receive order
+	/// \param uCount Number of sentences
+	///
+	virtual void ProcessRxBatch(CNMEAParserData::SENTENCE_T *pSentences, uint32_t uCount);
+
 	///
 	/// \brief This method will invoke a semaphore lock (mutex) for data access.
 	///
@@ -224,4 +474,73 @@ protected:
 	///
 	virtual void DataAccessSemaphoreUnlock(void) {}
 
+	///
+	/// \brief Creates the sentence object that decodes the given sentence ID.
+	///
+	/// Called once for every new (talker, sentence) pair. Redefine this method to add
+	/// sentence types; call the parent class for the ones it already supports.
+	///
+	/// \param nSentenceID Packed sentence ID, ie: SID_GGA
+	/// \return New sentence object (owned by the parser) or NULL if the sentence is not supported
+	///
+	virtual CNMEASentenceBase *CreateSentence(CNMEAParserData::SENTENCE_ID_E nSentenceID);
+
+	///
+	/// \brief Returns the sentence object for a (talker, sentence) pair
+	///
+	/// \param nTalkerID Talker ID
+	/// \param nSentenceID Sentence ID
+	/// \param bCreate Create the sentence object if it does not exist yet
+	/// \return The sentence object or NULL if it does not exist and could not be created
+	///
+	CNMEASentenceBase *FindSentence(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID, bool bCreate = false);
+
+	///
+	/// \brief Returns the sentence object for a (talker, sentence) pair or NULL. Safe to call from any thread.
+	///
+	CNMEASentenceBase *LookupSentence(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID) const;
+
+private:
+	///
+	/// \brief Allocates an empty dispatch table of nSize slots and keeps it in m_Tables
+	///
+	SENTENCE_TABLE_T *NewSentenceTable(int nSize);
+
+	///
+	/// \brief Copies the dispatch table into one twice the size and publishes it
+	///
+	void GrowSentenceTable(void);
+
+	///
+	/// \brief Decodes a sentence into its (talker, sentence) object. The caller holds the data lock.
+	///
+	CNMEAParserData::ERROR_E DecodeSentence(char *pCmd, char *pData, int64_t nRxTimeNs);
+
+	///
+	/// \brief Decodes a UBX message into the TID_UBX sentence objects. Takes the data lock.
+	///
+	void DecodeUBXMessage(uint8_t uClass, uint8_t uID, const uint8_t *pPayload, uint16_t uLength, int64_t nRxTimeNs);
+
+	///
+	/// \brief Counts a decoded sentence and passes it to the subscriptions and the epoch assembler
+	///
+	void PublishSentence(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID, CNMEASentenceBase *pSentence);
+
+	///
+	/// \brief Feeds the satellites of a GSV sentence into the satellite database
+	///
+	void UpdateSatelliteDatabase(CNMEAParserData::TALKER_ID_E nTalkerID, const CNMEASentenceGSV *pGSV);
+
+	///
+	/// \brief Adds a subscription under the data lock and returns its ID
+	///
+	uint32_t AddSubscription(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID, const SENTENCE_CALLBACK_T &callback);
+
+	///
+	/// \brief Calls the subscriptions that match a sentence that was just decoded
+	///
+	void NotifySubscribers(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID, const CNMEASentenceBase *pSentence);
+
+	CNMEAParser(const CNMEAParser &);											///< Not copyable, the parser owns its sentence objects
+	CNMEAParser &operator=(const CNMEAParser &);
 };
@@ -49,6 +49,7 @@ namespace CNMEAParserData {
 		ERROR_CHECKSUM = 3,														///< Error, packet checksum mismatch
 		ERROR_RX_BUFFER_OVERFLOW,												///< Error, receive packet buffer overflow
 		ERROR_CMD_BUFFER_OVERFLOW,												///< Error, receive command buffer overflow
+		ERROR_NO_CHANGE,														///< No new data since the version the caller already has
 	};
 
 	//
@@ -59,11 +60,13 @@ namespace CNMEAParserData {
 	static const int			c_nMaxConstellation = 64;						///< This is a max number if satellites for a constellation. NOTE: This does not reflect the actual constellation count for a given GPS/GNSS system
 	static const int			c_nMaxGSASats = 12;								///< Maximum number of satellites in the GSA message
 	static const int			c_nInvlidPRN = 0;								///< Invalid or non existing PRN
+	static const uint32_t		c_uMaxBatchSentences = 16;						///< Maximum number of sentences delivered in one CNMEAParserPacket::ProcessRxBatch() call
 
 	///
 	/// All known talker IDs
 	///
 	enum TALKER_ID_E {
+		TID_ANY = 0,															///< Not a talker, matches any talker in CNMEAParser subscriptions
 		TID_AB = (uint16_t)'A' << 8 | (uint16_t)'B',							///< AB Independent AIS Base Station
 		TID_AD = (uint16_t)'A' << 8 | (uint16_t)'D',							///< AD Dependent AIS Base Station
 		TID_AG = (uint16_t)'A' << 8 | (uint16_t)'G',							///< AG Autopilot - General
@@ -134,8 +137,44 @@ namespace CNMEAParserData {
 		TID_ZC = (uint16_t)'Z' << 8 | (uint16_t)'C',							///< ZC Timekeeper - Chronometer
 		TID_ZQ = (uint16_t)'Z' << 8 | (uint16_t)'Q',							///< ZQ Timekeeper - Quartz
 		TID_ZV = (uint16_t)'Z' << 8 | (uint16_t)'V',							///< ZV Timekeeper - Radio Update, WWV or WWVH
+		TID_UBX = (uint16_t)'U' << 8 | (uint16_t)'B',							///< Not a talker, data decoded from u-blox UBX messages (see CNMEAParser::EnableUBX())
 	};
 
+	///
+	/// Supported sentence IDs. The three sentence characters are packed the same way as
+	/// TALKER_ID_E so a (talker, sentence) pair can be looked up without string compares.
+	///
+	enum SENTENCE_ID_E {
+		SID_GGA = (uint32_t)'G' << 16 | (uint32_t)'G' << 8 | (uint32_t)'A',	///< GGA Global positioning system fix data
+		SID_GSA = (uint32_t)'G' << 16 | (uint32_t)'S' << 8 | (uint32_t)'A',	///< GSA GNSS DOP and active satellites
+		SID_GSV = (uint32_t)'G' << 16 | (uint32_t)'S' << 8 | (uint32_t)'V',	///< GSV GNSS satellites in view
+		SID_RMC = (uint32_t)'R' << 16 | (uint32_t)'M' << 8 | (uint32_t)'C',	///< RMC Recommended minimum specific GNSS data
+		SID_VTG = (uint32_t)'V' << 16 | (uint32_t)'T' << 8 | (uint32_t)'G',	///< VTG Course over ground and ground speed
+		SID_ZDA = (uint32_t)'Z' << 16 | (uint32_t)'D' << 8 | (uint32_t)'A',	///< ZDA Time and date
+		SID_GST = (uint32_t)'G' << 16 | (uint32_t)'S' << 8 | (uint32_t)'T',	///< GST GNSS pseudorange error statistics
+		SID_GLL = (uint32_t)'G' << 16 | (uint32_t)'L' << 8 | (uint32_t)'L',	///< GLL Geographic position, latitude / longitude
+		SID_HDT = (uint32_t)'H' << 16 | (uint32_t)'D' << 8 | (uint32_t)'T',	///< HDT Heading, true
+	};
+
+	///
+	/// \brief A complete sentence as delivered to CNMEAParserPacket::ProcessRxBatch()
+	///
+	typedef struct _SENTENCE_T {
+		char *			pCmd;													///< NMEA command (address), ie: GPGGA
+		char *			pData;													///< Comma separated data that belongs to the command
+		int64_t			nRxTimeNs;												///< Start of message ('$') time, monotonic (steady) clock in nanoseconds
+	} SENTENCE_T;
+
+	///
+	/// \brief Describes a decoded sentence, passed to CNMEAParser subscription callbacks
+	///
+	typedef struct _SENTENCE_INFO_T {
+		TALKER_ID_E		nTalkerID;												///< Talker that sent the sentence, ie: TID_GP
+		SENTENCE_ID_E	nSentenceID;											///< Sentence ID, ie: SID_GGA
+		uint32_t		uSequence;												///< Parser wide count of decoded sentences, starting at 1
+		int64_t			nRxTimeNs;												///< Start of message ('$') time, monotonic (steady) clock in nanoseconds
+	} SENTENCE_INFO_T;
+
 	///
 	/// GPS Quality that's used in the GGA sentence
 	///
@@ -176,6 +215,7 @@ namespace CNMEAParserData {
 		int				m_nHour;												///< hour
 		int				m_nMinute;												///< Minute
 		int				m_nSecond;												///< Second
+		double			m_dSecond;												///< Second, including the fraction
 		double			m_dLatitude;											///< Latitude (Decimal degrees, S < 0 > N)
 		double			m_dLongitude;											///< Longitude (Decimal degrees, W < 0 > E)
 		double			m_dAltitudeMSL;											///< Altitude (Meters)
@@ -198,6 +238,45 @@ namespace CNMEAParserData {
 		CNMEAParserData::SAT_INFO_T			SatInfo[c_nMaxConstellation];		///< Satellite data
 	} GSV_DATA_T;
 
+	///
+	/// GNSS constellations tracked by CNMEASatelliteDatabase
+	///
+	enum CONSTELLATION_E {
+		CONST_GPS = 0,															///< GPS (USA)
+		CONST_SBAS,																///< SBAS (WAAS, EGNOS, MSAS, ...)
+		CONST_GLONASS,															///< GLONASS (Russia)
+		CONST_GALILEO,															///< Galileo (Europe)
+		CONST_BEIDOU,															///< BeiDou (China)
+		CONST_QZSS,																///< QZSS (Japan)
+		CONST_COUNT,															///< Number of constellations
+	};
+
+	///
+	/// Bits of SATELLITE_T::uChangeMask
+	///
+	enum SAT_CHANGE_E {
+		SAT_CHANGED_ADDED = 0x01,												///< Satellite was added to the database
+		SAT_CHANGED_ELEVATION = 0x02,											///< Elevation changed
+		SAT_CHANGED_AZIMUTH = 0x04,												///< Azimuth changed
+		SAT_CHANGED_SNR = 0x08,													///< Signal to noise ratio changed
+		SAT_CHANGED_IN_VIEW = 0x10,												///< Satellite came into view or left the view
+	};
+
+	///
+	/// \brief A single satellite as copied out of CNMEASatelliteDatabase
+	///
+	typedef struct _SATELLITE_T {
+		uint8_t			uConstellation;											///< CONSTELLATION_E
+		uint8_t			uSNR;													///< Signal to noise ratio (dB-Hz), 0 if not tracked
+		int8_t			nElevation;												///< Elevation (degrees, -90 to 90)
+		uint8_t			uChangeMask;											///< SAT_CHANGE_E bits of the most recent change
+		uint16_t		uPRN;													///< PRN as reported in the GSV sentence
+		uint16_t		uAzimuth;												///< Azimuth (degrees, 0 to 359)
+		bool			bInView;												///< Satellite was listed in the last complete sky view
+		uint32_t		uChangeSerial;											///< Database serial of the most recent change
+		int64_t			nLastSeenNs;											///< Last time the satellite was reported, monotonic (steady) clock in nanoseconds
+	} SATELLITE_T;
+
 	///
 	/// GNSS DOP and active satellites
 	///
@@ -227,7 +306,7 @@ namespace CNMEAParserData {
 		int				m_nHour;												///< hour
 		int				m_nMinute;												///< Minute
 		int				m_nSecond;												///< Second
-		double			m_dSecond;												///< Fractional second
+		double			m_dSecond;												///< Second, including the fraction
 		double			m_dLatitude;											///< Latitude (Decimal degrees, S < 0 > N)
 		double			m_dLongitude;											///< Longitude (Decimal degrees, W < 0 > E)
 		double			m_dAltitudeMSL;											///< Altitude (Meters)
@@ -240,4 +319,205 @@ namespace CNMEAParserData {
 	    double			m_dMagneticVariation;									///< Magnetic Variation
 
 	} RMC_DATA_T;
+
+	///
+	/// FAA mode indicator (NMEA 2.3 and later), last field of VTG, GLL, RMC, ...
+	///
+	enum FAA_MODE_E {
+		FAA_MODE_NONE = 0,														///< Field not present (NMEA before 2.3)
+		FAA_MODE_AUTONOMOUS = 'A',												///< Autonomous
+		FAA_MODE_DIFFERENTIAL = 'D',											///< Differential
+		FAA_MODE_ESTIMATED = 'E',												///< Estimated (dead reckoning)
+		FAA_MODE_FLOAT_RTK = 'F',												///< Float RTK
+		FAA_MODE_MANUAL = 'M',													///< Manual input
+		FAA_MODE_NOT_VALID = 'N',												///< Data not valid
+		FAA_MODE_PRECISE = 'P',													///< Precise
+		FAA_MODE_RTK = 'R',														///< Real time kinematic
+		FAA_MODE_SIMULATOR = 'S',												///< Simulator
+	};
+
+	///
+	/// VTG Course over ground and ground speed
+	///
+	typedef struct _VTG_DATA_T {
+		double			m_dTrackTrue;											///< Course over ground (degrees True)
+		double			m_dTrackMagnetic;										///< Course over ground (degrees Magnetic)
+		double			m_dSpeedKnots;											///< Speed over ground (knots)
+		double			m_dSpeedKmh;											///< Speed over ground (km/h)
+		double			m_dSpeedMetersPerSecond;								///< Speed over ground (m/s), derived from the knots field
+		FAA_MODE_E		m_nMode;												///< Mode indicator
+	} VTG_DATA_T;
+
+	///
+	/// ZDA Time and date
+	///
+	typedef struct _ZDA_DATA_T {
+		int				m_nHour;												///< hour (UTC)
+		int				m_nMinute;												///< Minute
+		int				m_nSecond;												///< Second
+		double			m_dSecond;												///< Second, including the fraction
+		int				m_nDay;													///< Day
+		int				m_nMonth;												///< Month
+		int				m_nYear;												///< Year (four digits)
+		int				m_nLocalZoneHours;										///< Local zone hours (-13 to 13)
+		int				m_nLocalZoneMinutes;									///< Local zone minutes
+	} ZDA_DATA_T;
+
+	///
+	/// GST GNSS pseudorange error statistics
+	///
+	typedef struct _GST_DATA_T {
+		int				m_nHour;												///< hour (UTC)
+		int				m_nMinute;												///< Minute
+		int				m_nSecond;												///< Second
+		double			m_dSecond;												///< Second, including the fraction
+		double			m_dRangeRMS;											///< RMS of the pseudorange residuals (meters)
+		double			m_dSemiMajor;											///< Standard deviation of the semi-major axis of the error ellipse (meters)
+		double			m_dSemiMinor;											///< Standard deviation of the semi-minor axis of the error ellipse (meters)
+		double			m_dOrientation;											///< Orientation of the semi-major axis (degrees True)
+		double			m_dLatitudeSigma;										///< Standard deviation of latitude error (meters)
+		double			m_dLongitudeSigma;										///< Standard deviation of longitude error (meters)
+		double			m_dAltitudeSigma;										///< Standard deviation of altitude error (meters)
+	} GST_DATA_T;
+
+	///
+	/// GLL Geographic position, latitude / longitude
+	///
+	typedef struct _GLL_DATA_T {
+		double			m_dLatitude;											///< Latitude (Decimal degrees, S < 0 > N)
+		double			m_dLongitude;											///< Longitude (Decimal degrees, W < 0 > E)
+		int				m_nHour;												///< hour (UTC)
+		int				m_nMinute;												///< Minute
+		int				m_nSecond;												///< Second
+		double			m_dSecond;												///< Second, including the fraction
+		RMC_STATUS_E	m_nStatus;												///< Status, A = valid, V = not valid
+		FAA_MODE_E		m_nMode;												///< Mode indicator
+	} GLL_DATA_T;
+
+	///
+	/// HDT Heading, true
+	///
+	typedef struct _HDT_DATA_T {
+		double			m_dHeading;												///< Heading (degrees True)
+	} HDT_DATA_T;
+
+	static const int			c_nMaxFixActiveSats = 64;						///< Maximum number of active (used) satellites in FIX_RECORD_T
+
+	///
+	/// Bits of FIX_RECORD_T::m_uContentMask, one per sentence type merged into the epoch
+	///
+	enum FIX_CONTENT_E {
+		FIX_HAS_GGA = 0x0001,													///< GGA position, quality and altitude
+		FIX_HAS_RMC = 0x0002,													///< RMC status, speed, track and date
+		FIX_HAS_GSA = 0x0004,													///< GSA fix mode, DOPs and active satellites
+		FIX_HAS_GSV = 0x0008,													///< GSV satellites in view
+		FIX_HAS_VTG = 0x0010,													///< VTG speed and track
+		FIX_HAS_ZDA = 0x0020,													///< ZDA date
+		FIX_HAS_GST = 0x0040,													///< GST error estimates
+		FIX_HAS_GLL = 0x0080,													///< GLL position
+		FIX_HAS_HDT = 0x0100,													///< HDT heading
+		FIX_HAS_DATE = 0x1000,													///< m_nYear, m_nMonth and m_nDay are valid
+	};
+
+	///
+	/// \brief One navigation epoch, all sentences that carry the same UTC time merged together.
+	///
+	/// Built by CNMEAEpochAssembler. Fields of sentence types that are not in m_uContentMask are 0.
+	///
+	typedef struct _FIX_RECORD_T {
+		uint32_t		m_uEpoch;												///< Epoch number, incremented for every record
+		uint32_t		m_uContentMask;											///< FIX_CONTENT_E bits
+		uint32_t		m_uSentenceCount;										///< Number of sentences merged into this record
+		TALKER_ID_E		m_nTalkerID;											///< Talker of the position (GGA, RMC or GLL, in that order)
+		int64_t			m_nRxTimeNs;											///< Start of message time of the first sentence of the epoch, monotonic (steady) clock in nanoseconds
+		int64_t			m_nCompleteNs;											///< Time the epoch was completed, monotonic (steady) clock in nanoseconds
+		int				m_nYear;												///< Year (four digits), from RMC or ZDA
+		int				m_nMonth;												///< Month
+		int				m_nDay;													///< Day
+		int				m_nHour;												///< hour (UTC)
+		int				m_nMinute;												///< Minute
+		int				m_nSecond;												///< Second
+		double			m_dSecond;												///< Second, including the fraction
+		double			m_dLatitude;											///< Latitude (Decimal degrees, S < 0 > N)
+		double			m_dLongitude;											///< Longitude (Decimal degrees, W < 0 > E)
+		double			m_dAltitudeMSL;											///< Altitude (Meters)
+		double			m_dGeoidalSep;											///< Geoidal separation (meters)
+		GPS_QUALITY_E	m_nGPSQuality;											///< GGA quality
+		RMC_STATUS_E	m_nStatus;												///< RMC (or GLL) status
+		ACTIVE_SAT_MODE_E	m_nFixMode;											///< GSA 2D/3D mode
+		double			m_dSpeedKnots;											///< Speed over ground in knots, VTG if present, RMC otherwise
+		double			m_dTrackAngle;											///< Track angle in degrees True, VTG if present, RMC otherwise
+		double			m_dMagneticVariation;									///< Magnetic variation (degrees, W < 0 > E)
+		double			m_dHeading;												///< HDT heading (degrees True)
+		double			m_dHDOP;												///< Horizontal dilution of precision, GGA if present, GSA otherwise
+		double			m_dPDOP;												///< Position dilution of precision
+		double			m_dVDOP;												///< Vertical dilution of precision
+		double			m_dLatitudeSigma;										///< GST standard deviation of latitude error (meters)
+		double			m_dLongitudeSigma;										///< GST standard deviation of longitude error (meters)
+		double			m_dAltitudeSigma;										///< GST standard deviation of altitude error (meters)
+		double			m_dDifferentialAge;										///< Age of differential data (seconds)
+		int				m_nDifferentialID;										///< Differential reference station ID
+		int				m_nSatsUsed;											///< Satellites used, from GGA
+		int				m_nSatsInView;											///< Satellites in view, summed over the GSV talkers
+		int				m_nActiveSats;											///< Number of entries in m_pnActivePRN
+		int				m_pnActivePRN[c_nMaxFixActiveSats];						///< PRNs used in the fix, all GSA sentences of the epoch
+		uint32_t		m_uSatelliteSerial;										///< CNMEASatelliteDatabase serial after this epoch, see CNMEAParser::GetChangedSatellites()
+	} FIX_RECORD_T;
+
+	///
+	/// \brief Smoothed position, velocity and acceleration, see CNMEAKinematicFilter
+	///
+	typedef struct _KINEMATIC_STATE_T {
+		bool			m_bValid;												///< false until the first fix with a position
+		uint32_t		m_uEpoch;												///< FIX_RECORD_T::m_uEpoch of the last update
+		double			m_dTimeOfDay;											///< UTC time the state is valid for (seconds since midnight)
+		int64_t			m_nTimeNs;												///< Monotonic (steady) clock time the state is valid for, in nanoseconds
+		double			m_dExtrapolation;										///< Seconds predicted past the last measurement, 0 for the filter state itself
+		double			m_dLatitude;											///< Latitude (Decimal degrees, S < 0 > N)
+		double			m_dLongitude;											///< Longitude (Decimal degrees, W < 0 > E)
+		double			m_dAltitudeMSL;											///< Altitude (Meters)
+		double			m_dVelocityEast;										///< Velocity east (m/s)
+		double			m_dVelocityNorth;										///< Velocity north (m/s)
+		double			m_dClimbRate;											///< Velocity up (m/s)
+		double			m_dAccelerationEast;									///< Acceleration east (m/s^2)
+		double			m_dAccelerationNorth;									///< Acceleration north (m/s^2)
+		double			m_dAccelerationUp;										///< Acceleration up (m/s^2)
+		double			m_dSpeed;												///< Horizontal speed (m/s)
+		double			m_dTrackAngle;											///< Track angle in degrees True, from the filtered velocity
+		double			m_dHorizontalSigma;										///< Horizontal position standard deviation (meters)
+		double			m_dVerticalSigma;										///< Altitude standard deviation (meters)
+		double			m_dClimbRateSigma;										///< Climb rate standard deviation (m/s)
+	} KINEMATIC_STATE_T;
+
+	///
+	/// \brief Relation between GNSS UTC and the host monotonic clock, see CNMEAClockCorrelator
+	///
+	/// host_ns = m_nHostRefNs + (utc - m_dUTCRef) * m_dRate * 1e9
+	///
+	typedef struct _CLOCK_FIT_T {
+		bool			m_bValid;												///< Enough samples for a fit
+		bool			m_bDateKnown;											///< UTC values are seconds since 1970-01-01, otherwise since the midnight before the first fix
+		uint32_t		m_uSamples;												///< Samples in the fit window
+		uint32_t		m_uResets;												///< Number of times the fit was started again (time jumps)
+		double			m_dUTCRef;												///< Reference UTC time (seconds)
+		int64_t			m_nHostRefNs;											///< Host monotonic clock at m_dUTCRef (nanoseconds)
+		double			m_dRate;												///< Host seconds per UTC second (1 + host clock drift)
+		double			m_dResidual;											///< Median absolute residual of the samples (seconds)
+	} CLOCK_FIT_T;
+
+	///
+	/// \brief Per message type statistics of CNMEARTCM3Forwarder
+	///
+	typedef struct _RTCM3_STATS_T {
+		uint16_t		m_uMessageType;											///< RTCM 3 message type, ie: 1077
+		uint32_t		m_uReceived;											///< Frames received with a valid CRC
+		uint32_t		m_uForwarded;											///< Frames written to the link
+		uint32_t		m_uLate;												///< Frames dropped because they were older than the maximum age
+		uint32_t		m_uWriteErrors;											///< Frames the link did not accept
+		uint64_t		m_uForwardedBytes;										///< Bytes written to the link
+		int64_t			m_nFirstRxNs;											///< Receive time of the first frame, monotonic (steady) clock in nanoseconds
+		int64_t			m_nLastRxNs;											///< Receive time of the last frame
+		int64_t			m_nMaxGapNs;											///< Longest time between two frames of this type
+		double			m_dRateHz;												///< Average receive rate (frames per second)
+	} RTCM3_STATS_T;
 };
@@ -23,13 +23,24 @@
 *
 */
 #include <stdio.h>
+#include <string.h>
 #include "NMEAParser.h"
+#include "NMEAScan.h"
+#include "NMEATrace.h"
+#include "NMEAClock.h"
+#include "NMEAUBXPacket.h"
 
 CNMEAParserPacket::CNMEAParserPacket() :
 	m_nState(PARSE_STATE_SOM),
 	m_u8Checksum(0),
 	m_u8ReceivedChecksum(0),
-	m_nIndex(0)
+	m_nIndex(0),
+	m_pCommand(NULL),
+	m_pData(NULL),
+	m_nRxTimeNs(0),
+	m_pUBX(NULL),
+	m_bBatchMode(false),
+	m_uBatchCount(0)
 {
 	Reset();
 }
@@ -40,7 +51,17 @@ CNMEAParserPacket::~CNMEAParserPacket()
 
 CNMEAParserData::ERROR_E CNMEAParserPacket::ProcessNMEABuffer(char * pData, size_t nBufferSize)
 {
-	for (size_t i = 0; i < nBufferSize; i++) {
+	size_t i = 0;
+
+	//
+	// Finish a UBX frame that was split by the end of the last buffer
+	//
+	if (m_pUBX != NULL && m_pUBX->IsInFrame())
+	{
+		i = m_pUBX->ConsumeUBX(pData, nBufferSize);
+	}
+
+	for (; i < nBufferSize; i++) {
 		char cData = pData[i];
 		switch (m_nState)
 		{
@@ -48,19 +69,43 @@ CNMEAParserData::ERROR_E CNMEAParserPacket::ProcessNMEABuffer(char * pData, size
 			// Search for start of message '$'
 		case PARSE_STATE_SOM:
 			//
-			// Data byte Start of Message?
+			// Skip everything up to the next start of message in one scan
 			//
-			if (cData == '$')
+			if (m_pUBX == NULL)
 			{
-				//
-				// Time tag this message
-				//
-				TimeTag();
-
-				m_u8Checksum = 0;			// reset checksum
-				m_nIndex = 0;				// reset index
-				m_nState = PARSE_STATE_CMD;
+				i += CNMEAScan::FindChar(&pData[i], nBufferSize - i, '$');
 			}
+			else
+			{
+				i += CNMEAScan::FindEitherChar(&pData[i], nBufferSize - i, '$', (char)CNMEAUBXPacket::c_uSync1);
+				if (i < nBufferSize && pData[i] != '$')
+				{
+					//
+					// UBX frame. Keep the receive order in batch mode.
+					//
+					if (m_uBatchCount != 0)
+					{
+						FlushBatch();
+						SelectSlot(0);
+					}
+					i += m_pUBX->ConsumeUBX(&pData[i], nBufferSize - i) - 1;
+					break;
+				}
+			}
+			if (i >= nBufferSize)
+			{
+				break;
+			}
+
+			//
+			// Time tag this message
+			//
+			m_nRxTimeNs = CNMEAClock::GetTimeNs();
+			TimeTag();
+
+			m_u8Checksum = 0;			// reset checksum
+			m_nIndex = 0;				// reset index
+			m_nState = PARSE_STATE_CMD;
 			break;
 
 			///////////////////////////////////////////////////////////////////////
@@ -74,6 +119,7 @@ CNMEAParserData::ERROR_E CNMEAParserPacket::ProcessNMEABuffer(char * pData, size
 				// Check for command overflow
 				if (m_nIndex >= CNMEAParserData::c_uMaxCmdLen)
 				{
+					NMEA_TRACE_ERROR(m_pCommand, CNMEAParserData::ERROR_CMD_BUFFER_OVERFLOW);
 					OnError(CNMEAParserData::ERROR_CMD_BUFFER_OVERFLOW, m_pCommand);
 					m_nState = PARSE_STATE_SOM;
 				}
@@ -90,34 +136,40 @@ CNMEAParserData::ERROR_E CNMEAParserPacket::ProcessNMEABuffer(char * pData, size
 			///////////////////////////////////////////////////////////////////////
 			// Store data and check for end of sentence or checksum flag
 		case PARSE_STATE_DATA:
-			if (cData == '*') // checksum flag?
-			{
-				m_pData[m_nIndex] = '\0';
-				m_nState = PARSE_STATE_CHECKSUM_1;
-			}
-			else // no checksum flag, store data
 			{
 				//
-				// Check for end of sentence with no checksum
+				// Store and checksum everything up to the checksum flag or end of sentence in one block
 				//
-				if (cData == '\r')
+				size_t uSpan = CNMEAScan::FindDataEnd(&pData[i], nBufferSize - i);
+				size_t uRoom = CNMEAParserData::c_uMaxDataLen - m_nIndex;
+				if (uSpan >= uRoom) // Check for buffer overflow
 				{
-					m_pData[m_nIndex] = '\0';
-					ProcessRxCommand(m_pCommand, m_pData);
+					NMEA_TRACE_ERROR(m_pCommand, CNMEAParserData::ERROR_RX_BUFFER_OVERFLOW);
+					OnError(CNMEAParserData::ERROR_RX_BUFFER_OVERFLOW, m_pCommand);
 					m_nState = PARSE_STATE_SOM;
-					return CNMEAParserData::ERROR_OK;
+					i += uRoom - 1;		// resume right after the last byte that fit
+					break;
 				}
 
-				//
-				// Store data and calculate checksum
-				//
-				m_u8Checksum ^= cData;
-				m_pData[m_nIndex] = cData;
-				// Increment and check next position in buffer
-				if (++m_nIndex >= CNMEAParserData::c_uMaxDataLen) // Check for buffer overflow
+				memcpy(&m_pData[m_nIndex], &pData[i], uSpan);
+				m_u8Checksum ^= CNMEAScan::XorReduce(&pData[i], uSpan);
+				m_nIndex += (uint16_t)uSpan;
+				i += uSpan;
+				if (i >= nBufferSize)
 				{
-					OnError(CNMEAParserData::ERROR_RX_BUFFER_OVERFLOW, m_pCommand);
+					break;				// sentence continues in the next buffer
+				}
+
+				if (pData[i] == '*') // checksum flag?
+				{
+					m_pData[m_nIndex] = '\0';
+					m_nState = PARSE_STATE_CHECKSUM_1;
+				}
+				else // end of sentence with no checksum
+				{
+					m_pData[m_nIndex] = '\0';
 					m_nState = PARSE_STATE_SOM;
+					OnSentence();
 				}
 			}
 			break;
@@ -148,16 +200,16 @@ CNMEAParserData::ERROR_E CNMEAParserPacket::ProcessNMEABuffer(char * pData, size
 				m_u8ReceivedChecksum |= (cData - 'A' + 10);
 			}
 
+			m_nState = PARSE_STATE_SOM;
 			if (m_u8Checksum == m_u8ReceivedChecksum)
 			{
-				ProcessRxCommand(m_pCommand, m_pData);
+				OnSentence();
 			}
 			// Checksum error
 			else {
+				NMEA_TRACE_ERROR(m_pCommand, CNMEAParserData::ERROR_CHECKSUM);
 				OnError(CNMEAParserData::ERROR_CHECKSUM, m_pCommand);
 			}
-
-			m_nState = PARSE_STATE_SOM;
 			break;
 
 			///////////////////////////////////////////////////////////////////////
@@ -167,9 +219,212 @@ CNMEAParserData::ERROR_E CNMEAParserPacket::ProcessNMEABuffer(char * pData, size
 	return CNMEAParserData::ERROR_OK;
 }
 
+static uint8_t HexNibble(char cData)
+{
+	if ((cData - '0') <= 9)
+	{
+		return (uint8_t)(cData - '0');
+	}
+	return (uint8_t)(cData - 'A' + 10);
+}
+
+CNMEAParserData::ERROR_E CNMEAParserPacket::ProcessNMEASentence(char * pSentence, size_t nLength, int64_t nRxTimeNs)
+{
+	//
+	// Drop the line terminator, its first byte is where the data of a sentence without
+	// checksum gets terminated
+	//
+	bool bTerminated = false;
+	while (nLength != 0 && (pSentence[nLength - 1] == '\n' || pSentence[nLength - 1] == '\r'))
+	{
+		nLength--;
+		bTerminated = true;
+	}
+	if (nLength == 0 || pSentence[0] != '$')
+	{
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	//
+	// Address up to the first ',' or the checksum flag
+	//
+	char *pCmd = &pSentence[1];
+	size_t uRemain = nLength - 1;
+	size_t uCmdLen = CNMEAScan::FindEitherChar(pCmd, uRemain, ',', '*');
+	if (uCmdLen >= CNMEAParserData::c_uMaxCmdLen)
+	{
+		NMEA_TRACE_ERROR(NULL, CNMEAParserData::ERROR_CMD_BUFFER_OVERFLOW);
+		OnError(CNMEAParserData::ERROR_CMD_BUFFER_OVERFLOW, NULL);
+		return CNMEAParserData::ERROR_CMD_BUFFER_OVERFLOW;
+	}
+	if (uCmdLen >= uRemain)
+	{
+		return CNMEAParserData::ERROR_FAIL;
+	}
+	uint8_t u8Checksum = CNMEAScan::XorReduce(pCmd, uCmdLen);
+	char *pData = &pCmd[uCmdLen];
+	if (*pData == ',')
+	{
+		u8Checksum ^= ',';
+		pData++;
+	}
+	uRemain -= (size_t)(pData - pCmd);
+
+	//
+	// Data up to the checksum flag or the end of the sentence
+	//
+	size_t uSpan = CNMEAScan::FindDataEnd(pData, uRemain);
+	if (uSpan >= CNMEAParserData::c_uMaxDataLen)
+	{
+		pCmd[uCmdLen] = '\0';
+		NMEA_TRACE_ERROR(pCmd, CNMEAParserData::ERROR_RX_BUFFER_OVERFLOW);
+		OnError(CNMEAParserData::ERROR_RX_BUFFER_OVERFLOW, pCmd);
+		return CNMEAParserData::ERROR_RX_BUFFER_OVERFLOW;
+	}
+	u8Checksum ^= CNMEAScan::XorReduce(pData, uSpan);
+
+	if (uSpan < uRemain && pData[uSpan] == '*')
+	{
+		if (uSpan + 2 >= uRemain)
+		{
+			return CNMEAParserData::ERROR_FAIL;
+		}
+		uint8_t u8ReceivedChecksum = (uint8_t)((HexNibble(pData[uSpan + 1]) << 4) | HexNibble(pData[uSpan + 2]));
+		pCmd[uCmdLen] = '\0';
+		pData[uSpan] = '\0';
+		if (u8Checksum != u8ReceivedChecksum)
+		{
+			NMEA_TRACE_ERROR(pCmd, CNMEAParserData::ERROR_CHECKSUM);
+			OnError(CNMEAParserData::ERROR_CHECKSUM, pCmd);
+			return CNMEAParserData::ERROR_CHECKSUM;
+		}
+	}
+	else if (uSpan < uRemain || bTerminated)
+	{
+		pCmd[uCmdLen] = '\0';
+		pData[uSpan] = '\0';			// the '\r' or the dropped terminator
+	}
+	else
+	{
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	//
+	// Deliver with this sentence's time, then give a sentence that ProcessNMEABuffer()
+	// has in progress its own time back
+	//
+	int64_t nSavedRxTimeNs = m_nRxTimeNs;
+	m_nRxTimeNs = nRxTimeNs;
+	if (m_nState == PARSE_STATE_SOM)
+	{
+		TimeTag();
+	}
+	CNMEAParserData::ERROR_E nErr = ProcessRxCommand(pCmd, pData);
+	m_nRxTimeNs = nSavedRxTimeNs;
+	return nErr;
+}
+
+CNMEAParserData::ERROR_E CNMEAParserPacket::ProcessNMEABufferBatch(char * pData, size_t nBufferSize)
+{
+	m_bBatchMode = true;
+	CNMEAParserData::ERROR_E nErr = ProcessNMEABuffer(pData, nBufferSize);
+	m_bBatchMode = false;
+
+	//
+	// Deliver what this read completed. A partially received sentence lives in the slot
+	// after the last complete one; move it to the first slot so it can be finished by
+	// the next call.
+	//
+	uint32_t uPartialSlot = m_uBatchCount;
+	FlushBatch();
+	if (uPartialSlot != 0 && m_nState != PARSE_STATE_SOM)
+	{
+		memcpy(m_pSlots[0], m_pSlots[uPartialSlot], sizeof(m_pSlots[0]));
+	}
+	SelectSlot(0);
+
+	return nErr;
+}
+
+void CNMEAParserPacket::ProcessRxBatch(CNMEAParserData::SENTENCE_T * pSentences, uint32_t uCount)
+{
+	for (uint32_t i = 0; i < uCount; i++)
+	{
+		ProcessRxCommand(pSentences[i].pCmd, pSentences[i].pData);
+	}
+}
+
+bool CNMEAParserPacket::ParseAddress(const char * pCmd, CNMEAParserData::TALKER_ID_E & nTalkerID, CNMEAParserData::SENTENCE_ID_E & nSentenceID)
+{
+	if (pCmd[0] == '\0' || pCmd[1] == '\0' || pCmd[2] == '\0' || pCmd[3] == '\0' || pCmd[4] == '\0' || pCmd[5] != '\0')
+	{
+		return false;
+	}
+
+	//
+	// Grab the talker ID
+	//
+	uint16_t u16TalkerID = (uint16_t)((uint8_t)pCmd[0]) << 8;
+	u16TalkerID |= (uint16_t)((uint8_t)pCmd[1]);
+
+	//
+	// Get the sentence ID, --XXX where XXX is the sentence ID
+	//
+	const char *lpszSentenceID = &pCmd[2];
+	uint32_t u32SentenceID = (uint32_t)((uint8_t)lpszSentenceID[0]) << 16;
+	u32SentenceID |= (uint32_t)((uint8_t)lpszSentenceID[1]) << 8;
+	u32SentenceID |= (uint32_t)((uint8_t)lpszSentenceID[2]);
+
+	nTalkerID = (CNMEAParserData::TALKER_ID_E)u16TalkerID;
+	nSentenceID = (CNMEAParserData::SENTENCE_ID_E)u32SentenceID;
+	return true;
+}
+
+void CNMEAParserPacket::SelectSlot(uint32_t uSlot)
+{
+	m_pCommand = &m_pSlots[uSlot][0];
+	m_pData = &m_pSlots[uSlot][CNMEAParserData::c_uMaxCmdLen];
+}
+
+void CNMEAParserPacket::OnSentence(void)
+{
+	if (m_bBatchMode == false)
+	{
+		ProcessRxCommand(m_pCommand, m_pData);
+		return;
+	}
+
+	//
+	// Queue the sentence and continue in the next slot
+	//
+	m_Batch[m_uBatchCount].pCmd = m_pCommand;
+	m_Batch[m_uBatchCount].pData = m_pData;
+	m_Batch[m_uBatchCount].nRxTimeNs = m_nRxTimeNs;
+	if (++m_uBatchCount >= CNMEAParserData::c_uMaxBatchSentences)
+	{
+		FlushBatch();
+	}
+	SelectSlot(m_uBatchCount);
+}
+
+void CNMEAParserPacket::FlushBatch(void)
+{
+	if (m_uBatchCount != 0)
+	{
+		ProcessRxBatch(m_Batch, m_uBatchCount);
+		m_uBatchCount = 0;
+	}
+}
+
 void CNMEAParserPacket::Reset(void) {
 	m_nState = PARSE_STATE_SOM;
 	m_u8Checksum = m_u8ReceivedChecksum = 0;
 	m_nIndex = 0;
+	m_uBatchCount = 0;
+	SelectSlot(0);
+	if (m_pUBX != NULL)
+	{
+		m_pUBX->Reset();
+	}
 }
 
@@ -28,6 +28,8 @@
 #include <stdint.h>
 #include "NMEAParserData.h"
 
+class CNMEAUBXPacket;
+
 ///
 /// \class CNMEAParserPacket
 /// \brief This class will parse NMEA data packet and call its virtual processor methods.
@@ -81,8 +83,15 @@ private:
 	uint8_t							m_u8Checksum;								///< Calculated NMEA sentence checksum
 	uint8_t							m_u8ReceivedChecksum;						///< Received NMEA sentence checksum (if exists)
 	uint16_t						m_nIndex;									///< Index used for command and data
-	char							m_pCommand[CNMEAParserData::c_uMaxCmdLen];	///< NMEA command
-	char							m_pData[CNMEAParserData::c_uMaxDataLen];	///< NMEA data
+	char *							m_pCommand;									///< NMEA command (points into the current sentence slot)
+	char *							m_pData;									///< NMEA data (points into the current sentence slot)
+	int64_t							m_nRxTimeNs;								///< Start of message time of the current sentence (see GetRxTimeNs())
+	CNMEAUBXPacket *				m_pUBX;										///< Takes UBX frames out of the stream, NULL for NMEA only (see SetUBXPacket())
+
+	bool							m_bBatchMode;								///< Collecting sentences for ProcessRxBatch()
+	uint32_t						m_uBatchCount;								///< Complete sentences waiting in m_Batch
+	CNMEAParserData::SENTENCE_T		m_Batch[CNMEAParserData::c_uMaxBatchSentences];	///< Complete sentences of the current batch
+	char							m_pSlots[CNMEAParserData::c_uMaxBatchSentences][CNMEAParserData::c_uMaxCmdLen + CNMEAParserData::c_uMaxDataLen];	///< Command and data storage, one slot per sentence
 
 public:
 	CNMEAParserPacket();
@@ -99,6 +108,36 @@ public:
 	///
 	CNMEAParserData::ERROR_E ProcessNMEABuffer(char *pData, size_t nBufferSize);
 
+	///
+	/// \brief Parses pData for NMEA data and delivers the complete sentences in batches.
+	///
+	/// The whole buffer is consumed. Every sentence completed by this call is passed to a
+	/// single ProcessRxBatch() call (more than one if the buffer holds more than
+	/// c_uMaxBatchSentences sentences). A sentence that is still incomplete at the end of
+	/// the buffer is kept and finished by the next call.
+	///
+	/// \param pData Pointer to buffer to parse
+	/// \param nBufferSize Number of bytes in pData to process.
+	/// \return CNMEAParserData::ERROR_E, if successful, ERROR_OK is returned.
+	///
+	CNMEAParserData::ERROR_E ProcessNMEABufferBatch(char *pData, size_t nBufferSize);
+
+	///
+	/// \brief Decodes one complete sentence in place
+	///
+	/// For callers that already delimit the sentences, ie: a stream demultiplexer. The
+	/// sentence is not searched for or copied: the address and data are terminated inside
+	/// pSentence and handed to ProcessRxCommand(), where GetRxTimeNs() returns nRxTimeNs.
+	/// Does not touch the state or time of a sentence that ProcessNMEABuffer() has in
+	/// progress; TimeTag() is only called when there is none.
+	///
+	/// \param pSentence Sentence from the '$' on, with or without its line terminator. Modified.
+	/// \param nLength Number of bytes in pSentence
+	/// \param nRxTimeNs When the sentence was received, ie: when the read that delivered it completed (see CNMEAClock::GetTimeNs())
+	/// \return ERROR_OK if the sentence was decoded, ERROR_FAIL if it is incomplete (a sentence without checksum needs its terminator), otherwise the error also passed to OnError().
+	///
+	CNMEAParserData::ERROR_E ProcessNMEASentence(char *pSentence, size_t nLength, int64_t nRxTimeNs);
+
 	///
 	/// \brief Reset the parser.
 	///
@@ -127,12 +166,73 @@ protected:
 	///
 	virtual CNMEAParserData::ERROR_E ProcessRxCommand(char *pCmd, char *pData) = 0;
 
+	///
+	/// \brief Called by ProcessNMEABufferBatch() with the sentences completed by one read.
+	///
+	/// The default implementation calls ProcessRxCommand() for every sentence. Redefine
+	/// this method to handle the whole batch at once. The sentences are only valid for the
+	/// duration of the call.
+	///
+	/// \param pSentences Complete sentences, in receive order
+	/// \param uCount Number of sentences
+	///
+	virtual void ProcessRxBatch(CNMEAParserData::SENTENCE_T *pSentences, uint32_t uCount);
+
 	///
 	/// \brief This method is called when receiving the start of message of the NMEA packet.
 	///
 	/// If you need to time tag your NMEA sentences, redefine this method to allow 
 	/// you to capture when the SOM was received. You can then use the ProcessRxCommand()
 	/// method to capture the NMEA command that this time-tag belongs to.
+	/// The parser already records a monotonic time stamp at this point, see GetRxTimeNs().
 	///
 	virtual void TimeTag(void) {}
+
+	///
+	/// \brief Returns when the start of message ('$') of the sentence being received arrived
+	///
+	/// Valid in ProcessRxCommand() for the sentence it is called with. Batched sentences
+	/// carry their own time in SENTENCE_T::nRxTimeNs.
+	///
+	/// \return Monotonic (steady) clock in nanoseconds, see CNMEAClock::GetTimeNs()
+	///
+	int64_t GetRxTimeNs(void) const { return m_nRxTimeNs; }
+
+	///
+	/// \brief Demultiplexes UBX frames out of the NMEA stream
+	///
+	/// While set, the start of message search also stops at the UBX sync character and hands
+	/// the frame to pUBX. A frame split across buffers is finished at the start of the next one.
+	/// In batch mode the sentences received before a UBX frame are delivered before it, so the
+	/// receive order is kept.
+	///
+	/// \param pUBX UBX framer, NULL (the default) for a pure NMEA stream
+	///
+	void SetUBXPacket(CNMEAUBXPacket *pUBX) { m_pUBX = pUBX; }
+
+	///
+	/// \brief Splits a standard --XXX address into its talker and sentence ID
+	///
+	/// \param pCmd NMEA address, ie: "GPGGA"
+	/// \param nTalkerID Returned talker ID
+	/// \param nSentenceID Returned sentence ID
+	/// \return false for proprietary (P...) and malformed addresses, which have a different length
+	///
+	static bool ParseAddress(const char *pCmd, CNMEAParserData::TALKER_ID_E &nTalkerID, CNMEAParserData::SENTENCE_ID_E &nSentenceID);
+
+private:
+	///
+	/// \brief Points m_pCommand and m_pData at sentence slot uSlot
+	///
+	void SelectSlot(uint32_t uSlot);
+
+	///
+	/// \brief Hands a complete sentence to ProcessRxCommand() or queues it for the batch
+	///
+	void OnSentence(void);
+
+	///
+	/// \brief Delivers the queued sentences to ProcessRxBatch()
+	///
+	void FlushBatch(void);
 };
@@ -0,0 +1,169 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <type_traits>
+#include "NMEAParserData.h"
+#include "NMEASentenceBase.h"
+#include "NMEASentenceGGA.h"
+#include "NMEASentenceGSV.h"
+#include "NMEASentenceGSA.h"
+#include "NMEASentenceRMC.h"
+
+///
+/// \brief Compile time selection of the (talker, sentence) pairs a CNMEAParserT supports
+///
+/// A policy is a list of Sentence<> entries:
+///
+///		typedef CNMEAParserPolicy::Sentences<
+///			CNMEAParserPolicy::Sentence<CNMEAParserData::TID_GP, CNMEAParserData::SID_GGA, CNMEASentenceGGA>,
+///			CNMEAParserPolicy::Sentence<CNMEAParserData::TID_GP, CNMEAParserData::SID_RMC, CNMEASentenceRMC>
+///		> MY_POLICY_T;
+///
+/// Every entry is a member of the policy object, so the parser holds exactly the listed
+/// sentence objects and nothing else. Dispatch is a chain of compares against constants
+/// that the compiler unrolls, first match wins. An entry with talker TID_ANY takes the
+/// sentence from every talker that no earlier entry took.
+///
+namespace CNMEAParserPolicy {
+
+	///
+	/// \brief One supported (talker, sentence) pair and the class that decodes it
+	///
+	template <CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID, class SENTENCE>
+	struct Sentence {
+		static const CNMEAParserData::TALKER_ID_E c_nTalkerID = nTalkerID;
+		static const CNMEAParserData::SENTENCE_ID_E c_nSentenceID = nSentenceID;
+		typedef SENTENCE SENTENCE_T;
+
+		static bool Matches(CNMEAParserData::TALKER_ID_E nTalker, CNMEAParserData::SENTENCE_ID_E nSentence) {
+			return nSentence == nSentenceID && (nTalkerID == CNMEAParserData::TID_ANY || nTalker == nTalkerID);
+		}
+	};
+
+	///
+	/// \brief Result of a compile time lookup of a pair that is not in the policy
+	///
+	struct NotSupported;
+
+	///
+	/// \brief List of supported pairs; holds one sentence object per entry
+	///
+	template <class... ENTRIES>
+	struct Sentences;
+
+	template <>
+	struct Sentences<> {
+		template <CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID>
+		struct Lookup {
+			typedef NotSupported SENTENCE_T;
+		};
+
+		CNMEASentenceBase *Find(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID) {
+			UNUSED_PARAM(nTalkerID);
+			UNUSED_PARAM(nSentenceID);
+			return NULL;
+		}
+		void ResetData(void) {}
+	};
+
+	template <class ENTRY, class... ENTRIES>
+	struct Sentences<ENTRY, ENTRIES...> {
+		typedef Sentences<ENTRIES...> NEXT_T;
+
+		typename ENTRY::SENTENCE_T	m_Sentence;									///< Sentence object of this entry
+		NEXT_T						m_Next;										///< Remaining entries
+
+		///
+		/// \brief Compile time lookup of the sentence class of a pair
+		///
+		template <CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID>
+		struct Lookup {
+			static const bool c_bHere = ENTRY::c_nSentenceID == nSentenceID && (ENTRY::c_nTalkerID == CNMEAParserData::TID_ANY || ENTRY::c_nTalkerID == nTalkerID);
+			typedef typename std::conditional<c_bHere, typename ENTRY::SENTENCE_T, typename NEXT_T::template Lookup<nTalkerID, nSentenceID>::SENTENCE_T>::type SENTENCE_T;
+		};
+
+		///
+		/// \brief Returns the sentence object of a pair, NULL if the pair is not supported
+		///
+		CNMEASentenceBase *Find(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID) {
+			if (ENTRY::Matches(nTalkerID, nSentenceID)) {
+				return &m_Sentence;
+			}
+			return m_Next.Find(nTalkerID, nSentenceID);
+		}
+
+		///
+		/// \brief Returns the sentence object of a pair that is in the policy
+		///
+		template <CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID>
+		typename Lookup<nTalkerID, nSentenceID>::SENTENCE_T &Get(void) {
+			static_assert(std::is_same<typename Lookup<nTalkerID, nSentenceID>::SENTENCE_T, NotSupported>::value == false, "The (talker, sentence) pair is not in the parser policy");
+			return Get<nTalkerID, nSentenceID>(std::integral_constant<bool, Lookup<nTalkerID, nSentenceID>::c_bHere>());
+		}
+
+		///
+		/// \brief Clears the data of every sentence object
+		///
+		void ResetData(void) {
+			m_Sentence.ResetData();
+			m_Next.ResetData();
+		}
+
+	private:
+		template <CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID>
+		typename ENTRY::SENTENCE_T &Get(std::true_type) {
+			return m_Sentence;
+		}
+
+		template <CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID>
+		typename NEXT_T::template Lookup<nTalkerID, nSentenceID>::SENTENCE_T &Get(std::false_type) {
+			return m_Next.template Get<nTalkerID, nSentenceID>();
+		}
+	};
+
+	///
+	/// \brief GPS only receiver: GGA, RMC, GSA and GSV from the GP talker
+	///
+	typedef Sentences<
+		Sentence<CNMEAParserData::TID_GP, CNMEAParserData::SID_GGA, CNMEASentenceGGA>,
+		Sentence<CNMEAParserData::TID_GP, CNMEAParserData::SID_RMC, CNMEASentenceRMC>,
+		Sentence<CNMEAParserData::TID_GP, CNMEAParserData::SID_GSA, CNMEASentenceGSA>,
+		Sentence<CNMEAParserData::TID_GP, CNMEAParserData::SID_GSV, CNMEASentenceGSV>
+	> GPS_T;
+
+	///
+	/// \brief Position only: GGA of every GNSS talker. Other talkers share the last entry.
+	///
+	typedef Sentences<
+		Sentence<CNMEAParserData::TID_GN, CNMEAParserData::SID_GGA, CNMEASentenceGGA>,
+		Sentence<CNMEAParserData::TID_GP, CNMEAParserData::SID_GGA, CNMEASentenceGGA>,
+		Sentence<CNMEAParserData::TID_GL, CNMEAParserData::SID_GGA, CNMEASentenceGGA>,
+		Sentence<CNMEAParserData::TID_GA, CNMEAParserData::SID_GGA, CNMEASentenceGGA>,
+		Sentence<CNMEAParserData::TID_GB, CNMEAParserData::SID_GGA, CNMEASentenceGGA>,
+		Sentence<CNMEAParserData::TID_BD, CNMEAParserData::SID_GGA, CNMEASentenceGGA>,
+		Sentence<CNMEAParserData::TID_QZ, CNMEAParserData::SID_GGA, CNMEASentenceGGA>,
+		Sentence<CNMEAParserData::TID_ANY, CNMEAParserData::SID_GGA, CNMEASentenceGGA>
+	> POSITION_T;
+};
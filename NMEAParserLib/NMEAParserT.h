@@ -0,0 +1,186 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include "NMEAParserData.h"
+#include "NMEAParserPacket.h"
+#include "NMEAParserPolicy.h"
+#include "NMEATrace.h"
+#include "NMEAClock.h"
+
+///
+/// \class CNMEAParserT
+/// \brief NMEA parser that only supports the (talker, sentence) pairs of a compile time policy
+///
+/// CNMEAParser creates a sentence object for every pair it receives and finds it through a
+/// hashed table. CNMEAParserT holds the sentence objects of its policy as plain members
+/// (see CNMEAParserPolicy) and dispatches with compares against constants, so pairs that are
+/// not in the policy cost neither memory nor code. It has no subscriptions, satellite
+/// database or fix records; redefine OnSentenceDecoded() to act on a sentence.
+///
+///		CNMEAParserT<CNMEAParserPolicy::GPS_T> parser;
+///		parser.ProcessNMEABuffer(pBuffer, nLength);
+///		const CNMEAParserData::GGA_DATA_T &ggaData = parser.GetSentence<CNMEAParserData::TID_GP, CNMEAParserData::SID_GGA>().GetSentenceData();
+///
+template <class POLICY>
+class CNMEAParserT : public CNMEAParserPacket
+{
+private:
+	POLICY							m_Sentences;								///< Sentence objects of the policy
+
+public:
+	CNMEAParserT()
+	{
+		ResetData();
+	}
+
+	virtual ~CNMEAParserT()
+	{
+	}
+
+	///
+	/// \brief Resets or clears all NMEA data to a known default value
+	///
+	void ResetData(void)
+	{
+		DataAccessSemaphoreLock();
+		m_Sentences.ResetData();
+		DataAccessSemaphoreUnlock();
+	}
+
+	///
+	/// \brief Returns the sentence object of a pair in the policy. Fails to compile for other pairs.
+	///
+	/// Use GetSentenceData() between DataAccessSemaphoreLock() and DataAccessSemaphoreUnlock()
+	/// when the parser runs on another thread, or GetSnapshot() without a lock.
+	///
+	template <CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID>
+	const typename POLICY::template Lookup<nTalkerID, nSentenceID>::SENTENCE_T &GetSentence(void) const
+	{
+		return const_cast<POLICY &>(m_Sentences).template Get<nTalkerID, nSentenceID>();
+	}
+
+	///
+	/// \brief Returns the sentence object of a (talker, sentence) pair, NULL if the pair is not in the policy
+	///
+	const CNMEASentenceBase *FindSentence(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID) const
+	{
+		return const_cast<POLICY &>(m_Sentences).Find(nTalkerID, nSentenceID);
+	}
+
+protected:
+	///
+	/// \brief Decodes a sentence of the policy. Sentences that are not in the policy are ignored.
+	///
+	virtual CNMEAParserData::ERROR_E ProcessRxCommand(char *pCmd, char *pData)
+	{
+		DataAccessSemaphoreLock();
+		CNMEAParserData::ERROR_E nErr = DecodeSentence(pCmd, pData, GetRxTimeNs());
+		DataAccessSemaphoreUnlock();
+		return nErr;
+	}
+
+	///
+	/// \brief Decodes a batch of sentences under a single lock
+	///
+	virtual void ProcessRxBatch(CNMEAParserData::SENTENCE_T *pSentences, uint32_t uCount)
+	{
+		DataAccessSemaphoreLock();
+		for (uint32_t i = 0; i < uCount; i++)
+		{
+			DecodeSentence(pSentences[i].pCmd, pSentences[i].pData, pSentences[i].nRxTimeNs);
+		}
+		DataAccessSemaphoreUnlock();
+	}
+
+	///
+	/// \brief Called with the data lock held after a sentence of the policy was decoded
+	///
+	/// \param nTalkerID Talker that sent the sentence
+	/// \param nSentenceID Sentence ID
+	/// \param pSentence Sentence object that holds the decoded data
+	/// \param nRxTimeNs Start of message time of the sentence
+	///
+	virtual void OnSentenceDecoded(CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID, const CNMEASentenceBase *pSentence, int64_t nRxTimeNs)
+	{
+		UNUSED_PARAM(nTalkerID);
+		UNUSED_PARAM(nSentenceID);
+		UNUSED_PARAM(pSentence);
+		UNUSED_PARAM(nRxTimeNs);
+	}
+
+	///
+	/// \brief Redefine to lock the data if it is accessed from more than one thread
+	///
+	virtual void DataAccessSemaphoreLock(void) {}
+
+	///
+	/// \brief Redefine to unlock the data if it is accessed from more than one thread
+	///
+	virtual void DataAccessSemaphoreUnlock(void) {}
+
+private:
+	///
+	/// \brief Decodes a sentence into its object. The caller holds the data lock.
+	///
+	CNMEAParserData::ERROR_E DecodeSentence(char *pCmd, char *pData, int64_t nRxTimeNs)
+	{
+		CNMEAParserData::TALKER_ID_E nTalkerID;
+		CNMEAParserData::SENTENCE_ID_E nSentenceID;
+		if (ParseAddress(pCmd, nTalkerID, nSentenceID) == false)
+		{
+			return CNMEAParserData::ERROR_OK;
+		}
+
+		CNMEASentenceBase *pSentence = m_Sentences.Find(nTalkerID, nSentenceID);
+		if (pSentence == NULL)
+		{
+			NMEA_TRACE_SENTENCE(CNMEATrace::TRACE_UNSUPPORTED, nTalkerID, nSentenceID, CNMEAParserData::ERROR_OK);
+			return CNMEAParserData::ERROR_OK;
+		}
+
+		CNMEAParserData::ERROR_E nErr = pSentence->ProcessSentence(pCmd, pData);
+		NMEA_TRACE_SENTENCE(CNMEATrace::TRACE_SENTENCE, nTalkerID, nSentenceID, nErr);
+
+		//
+		// A GGA starts a new position update, let the GSA of the same talker know about it
+		//
+		if (nSentenceID == CNMEAParserData::SID_GGA)
+		{
+			CNMEASentenceBase *pGSA = m_Sentences.Find(nTalkerID, CNMEAParserData::SID_GSA);
+			if (pGSA != NULL)
+			{
+				static_cast<CNMEASentenceGSA *>(pGSA)->FlagReceivedGGA();
+			}
+		}
+
+		if (nErr == CNMEAParserData::ERROR_OK)
+		{
+			OnSentenceDecoded(nTalkerID, nSentenceID, pSentence, nRxTimeNs);
+		}
+		return nErr;
+	}
+};
@@ -0,0 +1,139 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include <string.h>
+#include "NMEARTCM3Forwarder.h"
+#include "NMEAClock.h"
+
+CNMEARTCM3Forwarder::CNMEARTCM3Forwarder() :
+	m_nMaxAgeNs(c_nDefaultMaxAgeNs),
+	m_nTypeCount(0),
+	m_nLastType(0),
+	m_uCRCErrors(0)
+{
+	ResetStatistics();
+}
+
+CNMEARTCM3Forwarder::~CNMEARTCM3Forwarder()
+{
+}
+
+int CNMEARTCM3Forwarder::GetStatistics(CNMEAParserData::RTCM3_STATS_T * pStats, int nMaxStats) const
+{
+	int nCount = (m_nTypeCount < nMaxStats) ? m_nTypeCount : nMaxStats;
+	for (int i = 0; i < nCount; i++)
+	{
+		pStats[i] = m_Stats[i];
+		int64_t nSpanNs = m_Stats[i].m_nLastRxNs - m_Stats[i].m_nFirstRxNs;
+		pStats[i].m_dRateHz = (nSpanNs > 0) ? (double)(m_Stats[i].m_uReceived - 1) * 1e9 / (double)nSpanNs : 0.0;
+	}
+	return nCount;
+}
+
+void CNMEARTCM3Forwarder::ResetStatistics(void)
+{
+	m_nTypeCount = 0;
+	m_nLastType = 0;
+	memset(m_Stats, 0, sizeof(m_Stats));
+	m_Latency.Reset();
+	m_uCRCErrors = 0;
+}
+
+void CNMEARTCM3Forwarder::OnRTCM3Error(CNMEAParserData::ERROR_E nError)
+{
+	if (nError == CNMEAParserData::ERROR_CHECKSUM)
+	{
+		m_uCRCErrors++;
+	}
+}
+
+void CNMEARTCM3Forwarder::ProcessRTCM3Frame(const uint8_t * pFrame, uint16_t uFrameLength, uint16_t uMessageType, int64_t nRxTimeNs)
+{
+	CNMEAParserData::RTCM3_STATS_T *pStats = FindStatistics(uMessageType);
+	if (pStats != NULL)
+	{
+		if (pStats->m_uReceived == 0)
+		{
+			pStats->m_nFirstRxNs = nRxTimeNs;
+		}
+		else if (nRxTimeNs - pStats->m_nLastRxNs > pStats->m_nMaxGapNs)
+		{
+			pStats->m_nMaxGapNs = nRxTimeNs - pStats->m_nLastRxNs;
+		}
+		pStats->m_nLastRxNs = nRxTimeNs;
+		pStats->m_uReceived++;
+	}
+
+	//
+	// Drop corrections that are already too old to help the rover
+	//
+	if (CNMEAClock::GetTimeNs() - nRxTimeNs > m_nMaxAgeNs)
+	{
+		if (pStats != NULL)
+		{
+			pStats->m_uLate++;
+		}
+		return;
+	}
+
+	bool bWritten = m_Write ? m_Write(pFrame, uFrameLength) : false;
+	m_Latency.Record(CNMEAClock::GetTimeNs() - nRxTimeNs);
+	if (pStats != NULL)
+	{
+		if (bWritten)
+		{
+			pStats->m_uForwarded++;
+			pStats->m_uForwardedBytes += uFrameLength;
+		}
+		else
+		{
+			pStats->m_uWriteErrors++;
+		}
+	}
+}
+
+CNMEAParserData::RTCM3_STATS_T * CNMEARTCM3Forwarder::FindStatistics(uint16_t uMessageType)
+{
+	if (m_nTypeCount != 0 && m_Stats[m_nLastType].m_uMessageType == uMessageType)
+	{
+		return &m_Stats[m_nLastType];
+	}
+
+	for (int i = 0; i < m_nTypeCount; i++)
+	{
+		if (m_Stats[i].m_uMessageType == uMessageType)
+		{
+			m_nLastType = i;
+			return &m_Stats[i];
+		}
+	}
+
+	if (m_nTypeCount >= c_nMaxMessageTypes)
+	{
+		return NULL;
+	}
+	m_nLastType = m_nTypeCount++;
+	m_Stats[m_nLastType].m_uMessageType = uMessageType;
+	return &m_Stats[m_nLastType];
+}
@@ -0,0 +1,115 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include <functional>
+#include "NMEAParserData.h"
+#include "NMEARTCM3Packet.h"
+#include "NMEAHistogram.h"
+
+///
+/// \class CNMEARTCM3Forwarder
+/// \brief Passes RTCM 3 correction frames from a source (file, socket, NTRIP, ...) to the vehicle link.
+///
+/// Feed the source with ProcessRTCM3Buffer(). Every valid frame is handed to the write
+/// callback straight from the source buffer (or from the frame buffer if it was split across
+/// reads), there is no queue in between. A frame whose preamble arrived more than the maximum
+/// age ago is dropped instead of being sent: a late correction is of no use to an RTK rover
+/// and only delays the next one.
+///
+/// Statistics are kept per message type. The forwarder is not thread safe, call it and read
+/// the statistics from the same thread.
+///
+class CNMEARTCM3Forwarder : public CNMEARTCM3Packet
+{
+public:
+	static const int				c_nMaxMessageTypes = 32;					///< Message types with their own statistics, later types are forwarded but not counted
+	static const int64_t			c_nDefaultMaxAgeNs = 1000000000;			///< Default maximum age (1 s)
+
+	///
+	/// \brief Writes a frame to the link. Returns false if the link did not accept it.
+	///
+	typedef std::function<bool(const uint8_t *pData, size_t uLength)> WRITE_CALLBACK_T;
+
+private:
+	WRITE_CALLBACK_T				m_Write;									///< Link writer
+	int64_t							m_nMaxAgeNs;								///< Frames older than this are dropped
+	int								m_nTypeCount;								///< Entries in m_Stats
+	int								m_nLastType;								///< Entry of the last frame, checked first
+	CNMEAParserData::RTCM3_STATS_T	m_Stats[c_nMaxMessageTypes];				///< Per message type statistics
+	CNMEAHistogram					m_Latency;									///< Preamble received to frame written
+	uint32_t						m_uCRCErrors;								///< Frames dropped for a CRC mismatch
+
+public:
+	CNMEARTCM3Forwarder();
+	virtual ~CNMEARTCM3Forwarder();
+
+	///
+	/// \brief Sets the function that writes frames to the link
+	///
+	void SetWriter(const WRITE_CALLBACK_T &write) { m_Write = write; }
+
+	///
+	/// \brief Sets the maximum age of a frame, from its preamble arriving to being written
+	/// \param nMaxAgeNs Maximum age in nanoseconds
+	///
+	void SetMaxAge(int64_t nMaxAgeNs) { m_nMaxAgeNs = nMaxAgeNs; }
+
+	///
+	/// \brief Copies the statistics of every message type received so far
+	///
+	/// \param pStats Array to receive the statistics
+	/// \param nMaxStats Size of pStats, c_nMaxMessageTypes for all types
+	/// \return Number of entries copied
+	///
+	int GetStatistics(CNMEAParserData::RTCM3_STATS_T *pStats, int nMaxStats) const;
+
+	///
+	/// \brief Returns the time from the preamble arriving to the frame being written, all message types
+	///
+	const CNMEAHistogram &GetLatencyHistogram(void) const { return m_Latency; }
+
+	///
+	/// \brief Returns the number of frames dropped for a CRC mismatch
+	///
+	uint32_t GetCRCErrors(void) const { return m_uCRCErrors; }
+
+	///
+	/// \brief Clears all statistics
+	///
+	void ResetStatistics(void);
+
+	virtual void OnRTCM3Error(CNMEAParserData::ERROR_E nError);
+
+protected:
+	virtual void ProcessRTCM3Frame(const uint8_t *pFrame, uint16_t uFrameLength, uint16_t uMessageType, int64_t nRxTimeNs);
+
+private:
+	///
+	/// \brief Returns the statistics of a message type, adding it if there is room, NULL otherwise
+	///
+	CNMEAParserData::RTCM3_STATS_T *FindStatistics(uint16_t uMessageType);
+};
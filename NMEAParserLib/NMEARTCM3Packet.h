@@ -0,0 +1,114 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include "NMEAParserData.h"
+
+///
+/// \class CNMEARTCM3Packet
+/// \brief Frames RTCM 3 correction messages and calls its virtual processor method.
+///
+/// An RTCM 3 frame is: preamble 0xD3, 6 reserved bits (0) and a 10 bit payload length,
+/// the payload and a CRC-24Q over everything before it. The message type is the first 12
+/// bits of the payload.
+///
+/// A frame that is whole inside the buffer handed in is checked and delivered in place,
+/// nothing is copied. Only frames split across buffers are assembled in the internal frame
+/// buffer. After a CRC error the search resumes right after the preamble, so a 0xD3 inside
+/// a payload does not lose the frames that follow it.
+///
+class CNMEARTCM3Packet {
+
+public:
+	static const uint8_t			c_uPreamble = 0xD3;							///< Frame preamble
+	static const uint16_t			c_uMaxPayload = 1023;						///< Largest payload the 10 bit length can describe
+	static const uint16_t			c_uHeaderLen = 3;							///< Preamble, reserved bits and length
+	static const uint16_t			c_uCRCLen = 3;								///< CRC-24Q
+	static const uint16_t			c_uMaxFrameLen = c_uHeaderLen + c_uMaxPayload + c_uCRCLen;	///< Longest frame
+
+private:
+	uint16_t						m_uIndex;									///< Bytes of the split frame in m_pFrame, 0 while searching for a preamble
+	uint16_t						m_uFrameLength;								///< Length of the split frame, valid once its header is complete
+	int64_t							m_nRxTimeNs;								///< Time the preamble of the split frame arrived
+	uint8_t							m_pFrame[c_uMaxFrameLen];					///< Frame split across buffers
+
+public:
+	CNMEARTCM3Packet();
+	virtual ~CNMEARTCM3Packet();
+
+	///
+	/// \brief Parses pData for RTCM 3 frames, everything between frames is skipped
+	///
+	/// \param pData Pointer to buffer to parse
+	/// \param nBufferSize Number of bytes in pData to process.
+	/// \return CNMEAParserData::ERROR_E, if successful, ERROR_OK is returned.
+	///
+	CNMEAParserData::ERROR_E ProcessRTCM3Buffer(const char *pData, size_t nBufferSize);
+
+	///
+	/// \brief Reset the framer, a partially received frame is dropped
+	///
+	void Reset(void);
+
+	///
+	/// \brief Computes the CRC-24Q (table driven)
+	///
+	/// \param pData Data
+	/// \param uLength Number of bytes
+	/// \return CRC in the low 24 bits
+	///
+	static uint32_t CRC24Q(const uint8_t *pData, size_t uLength);
+
+	///
+	/// \brief Returns the message type (first 12 bits of the payload) of a complete frame
+	///
+	static uint16_t GetMessageType(const uint8_t *pFrame) { return (uint16_t)((pFrame[c_uHeaderLen] << 4) | (pFrame[c_uHeaderLen + 1] >> 4)); }
+
+	///
+	/// \brief This method is called for frames that are dropped
+	///
+	/// \param nError ERROR_CHECKSUM for a CRC mismatch
+	///
+	virtual void OnRTCM3Error(CNMEAParserData::ERROR_E nError) { UNUSED_PARAM(nError); }
+
+protected:
+
+	///
+	/// \brief Redefine this method to process valid frames
+	///
+	/// \param pFrame Whole frame, header and CRC included. Only valid for the duration of the call.
+	/// \param uFrameLength Frame length in bytes
+	/// \param uMessageType Message type, ie: 1077 (GPS MSM7)
+	/// \param nRxTimeNs Time the preamble arrived, monotonic (steady) clock in nanoseconds
+	///
+	virtual void ProcessRTCM3Frame(const uint8_t *pFrame, uint16_t uFrameLength, uint16_t uMessageType, int64_t nRxTimeNs) = 0;
+
+private:
+	///
+	/// \brief Returns true if the CRC of a complete frame matches
+	///
+	static bool CheckFrame(const uint8_t *pFrame, uint16_t uFrameLength);
+};
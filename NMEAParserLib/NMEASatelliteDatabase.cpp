@@ -0,0 +1,240 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include "NMEASatelliteDatabase.h"
+#include <string.h>
+
+CNMEASatelliteDatabase::CNMEASatelliteDatabase()
+{
+	Reset();
+}
+
+void CNMEASatelliteDatabase::Reset(void)
+{
+	m_nCount = 0;
+	m_uSerial = 0;
+	m_uSkyView = 0;
+	m_uSkyViewConstellations = 0;
+	m_nSkyViewTalkerID = CNMEAParserData::TID_ANY;
+	memset(m_puIndex, 0xFF, sizeof(m_puIndex));
+}
+
+CNMEAParserData::CONSTELLATION_E CNMEASatelliteDatabase::GetConstellation(CNMEAParserData::TALKER_ID_E nTalkerID, int nPRN)
+{
+	switch (nTalkerID)
+	{
+	case CNMEAParserData::TID_GL:
+		return CNMEAParserData::CONST_GLONASS;
+	case CNMEAParserData::TID_GA:
+		return CNMEAParserData::CONST_GALILEO;
+	case CNMEAParserData::TID_GB:
+	case CNMEAParserData::TID_BD:
+		return CNMEAParserData::CONST_BEIDOU;
+	case CNMEAParserData::TID_QZ:
+		return CNMEAParserData::CONST_QZSS;
+	default:
+		break;
+	}
+
+	if ((nPRN >= 33 && nPRN <= 64) || (nPRN >= 120 && nPRN <= 158))
+	{
+		return CNMEAParserData::CONST_SBAS;
+	}
+	if (nPRN >= 65 && nPRN <= 96)
+	{
+		return CNMEAParserData::CONST_GLONASS;
+	}
+	if (nPRN >= 193 && nPRN <= 202)
+	{
+		return CNMEAParserData::CONST_QZSS;
+	}
+	return CNMEAParserData::CONST_GPS;
+}
+
+void CNMEASatelliteDatabase::BeginSkyView(CNMEAParserData::TALKER_ID_E nTalkerID)
+{
+	m_uSkyView++;
+	m_nSkyViewTalkerID = nTalkerID;
+
+	//
+	// A single constellation talker covers its constellation even if it lists no satellites
+	//
+	m_uSkyViewConstellations = 0;
+	if (nTalkerID != CNMEAParserData::TID_GP && nTalkerID != CNMEAParserData::TID_GN && nTalkerID != CNMEAParserData::TID_UBX)
+	{
+		m_uSkyViewConstellations = 1u << GetConstellation(nTalkerID, 0);
+	}
+}
+
+CNMEAParserData::ERROR_E CNMEASatelliteDatabase::UpdateSatellite(int nPRN, int nElevation, int nAzimuth, int nSNR, int64_t nTimeNs)
+{
+	return UpdateSatellite(GetConstellation(m_nSkyViewTalkerID, nPRN), nPRN, nElevation, nAzimuth, nSNR, nTimeNs);
+}
+
+CNMEAParserData::ERROR_E CNMEASatelliteDatabase::UpdateSatellite(CNMEAParserData::CONSTELLATION_E nConstellation, int nPRN, int nElevation, int nAzimuth, int nSNR, int64_t nTimeNs)
+{
+	if (nPRN <= 0 || nPRN >= c_nMaxPRN || nConstellation < 0 || nConstellation >= CNMEAParserData::CONST_COUNT)
+	{
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	m_uSkyViewConstellations |= 1u << nConstellation;
+
+	//
+	// Clamp to the column ranges
+	//
+	int8_t nElevation8 = (int8_t)(nElevation < -90 ? -90 : (nElevation > 90 ? 90 : nElevation));
+	uint16_t uAzimuth16 = (uint16_t)(nAzimuth < 0 ? 0 : (nAzimuth > 359 ? 359 : nAzimuth));
+	uint8_t uSNR8 = (uint8_t)(nSNR < 0 ? 0 : (nSNR > 99 ? 99 : nSNR));
+
+	uint8_t uChangeMask = 0;
+	int nRow = m_puIndex[nConstellation][nPRN];
+	if (nRow == c_uNoSatellite)
+	{
+		if (m_nCount >= c_nMaxSatellites)
+		{
+			return CNMEAParserData::ERROR_TOO_MANY_SATELLITES;
+		}
+		nRow = m_nCount++;
+		m_puIndex[nConstellation][nPRN] = (uint16_t)nRow;
+		m_puConstellation[nRow] = (uint8_t)nConstellation;
+		m_puPRN[nRow] = (uint16_t)nPRN;
+		m_pnElevation[nRow] = nElevation8;
+		m_puAzimuth[nRow] = uAzimuth16;
+		m_puSNR[nRow] = uSNR8;
+		m_pbInView[nRow] = 1;
+		uChangeMask = CNMEAParserData::SAT_CHANGED_ADDED | CNMEAParserData::SAT_CHANGED_IN_VIEW;
+	}
+	else
+	{
+		if (m_pnElevation[nRow] != nElevation8)
+		{
+			m_pnElevation[nRow] = nElevation8;
+			uChangeMask |= CNMEAParserData::SAT_CHANGED_ELEVATION;
+		}
+		if (m_puAzimuth[nRow] != uAzimuth16)
+		{
+			m_puAzimuth[nRow] = uAzimuth16;
+			uChangeMask |= CNMEAParserData::SAT_CHANGED_AZIMUTH;
+		}
+		if (m_puSNR[nRow] != uSNR8)
+		{
+			m_puSNR[nRow] = uSNR8;
+			uChangeMask |= CNMEAParserData::SAT_CHANGED_SNR;
+		}
+		if (m_pbInView[nRow] == 0)
+		{
+			m_pbInView[nRow] = 1;
+			uChangeMask |= CNMEAParserData::SAT_CHANGED_IN_VIEW;
+		}
+	}
+
+	m_puSkyView[nRow] = m_uSkyView;
+	m_pnLastSeenNs[nRow] = nTimeNs;
+	if (uChangeMask != 0)
+	{
+		MarkChanged(nRow, uChangeMask);
+	}
+	return CNMEAParserData::ERROR_OK;
+}
+
+void CNMEASatelliteDatabase::EndSkyView(void)
+{
+	for (int i = 0; i < m_nCount; i++)
+	{
+		if (m_pbInView[i] != 0 && m_puSkyView[i] != m_uSkyView && (m_uSkyViewConstellations & (1u << m_puConstellation[i])) != 0)
+		{
+			m_pbInView[i] = 0;
+			m_puSNR[i] = 0;
+			MarkChanged(i, CNMEAParserData::SAT_CHANGED_IN_VIEW | CNMEAParserData::SAT_CHANGED_SNR);
+		}
+	}
+}
+
+int CNMEASatelliteDatabase::Find(CNMEAParserData::CONSTELLATION_E nConstellation, int nPRN) const
+{
+	if (nConstellation < 0 || nConstellation >= CNMEAParserData::CONST_COUNT || nPRN <= 0 || nPRN >= c_nMaxPRN)
+	{
+		return -1;
+	}
+	int nRow = m_puIndex[nConstellation][nPRN];
+	return nRow == c_uNoSatellite ? -1 : nRow;
+}
+
+CNMEAParserData::ERROR_E CNMEASatelliteDatabase::GetSatellite(int nRow, CNMEAParserData::SATELLITE_T & satellite) const
+{
+	if (nRow < 0 || nRow >= m_nCount)
+	{
+		return CNMEAParserData::ERROR_FAIL;
+	}
+	satellite.uConstellation = m_puConstellation[nRow];
+	satellite.uSNR = m_puSNR[nRow];
+	satellite.nElevation = m_pnElevation[nRow];
+	satellite.uChangeMask = m_puChangeMask[nRow];
+	satellite.uPRN = m_puPRN[nRow];
+	satellite.uAzimuth = m_puAzimuth[nRow];
+	satellite.bInView = m_pbInView[nRow] != 0;
+	satellite.uChangeSerial = m_puChangeSerial[nRow];
+	satellite.nLastSeenNs = m_pnLastSeenNs[nRow];
+	return CNMEAParserData::ERROR_OK;
+}
+
+int CNMEASatelliteDatabase::GetChanged(uint32_t uSinceSerial, CNMEAParserData::SATELLITE_T * pSatellites, int nMaxSatellites, uint32_t & uSerial) const
+{
+	int nCopied = 0;
+
+	//
+	// Only the serial column is scanned, rows are copied out when they changed
+	//
+	for (int i = 0; i < m_nCount; i++)
+	{
+		if ((int32_t)(m_puChangeSerial[i] - uSinceSerial) <= 0)
+		{
+			continue;
+		}
+		if (nCopied >= nMaxSatellites)
+		{
+			//
+			// Rows are not in serial order, so the caller has to ask again from the same serial
+			//
+			uSerial = uSinceSerial;
+			return nCopied;
+		}
+		GetSatellite(i, pSatellites[nCopied++]);
+	}
+
+	uSerial = m_uSerial;
+	return nCopied;
+}
+
+void CNMEASatelliteDatabase::MarkChanged(int nRow, uint8_t uChangeMask)
+{
+	m_uSerial++;
+	if (m_uSerial == 0)
+	{
+		m_uSerial = 1;
+	}
+	m_puChangeMask[nRow] = uChangeMask;
+	m_puChangeSerial[nRow] = m_uSerial;
+}
@@ -0,0 +1,195 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include "NMEAParserData.h"
+
+///
+/// \class CNMEASatelliteDatabase
+/// \brief Satellites of all constellations in a single table, keyed by (constellation, PRN).
+///
+/// The table is kept as a structure of arrays with small integer fields, so a sky plot or
+/// SNR chart walks a few compact arrays instead of one 64 entry GSV_DATA_T per talker.
+/// A satellite keeps its row for the lifetime of the database.
+///
+/// Every change is stamped with an increasing serial number. A consumer remembers the
+/// serial it last saw and asks for the satellites that changed since (GetChanged()), so
+/// it only redraws what changed. Each row also records what changed most recently
+/// (SAT_CHANGE_E bits) and when the satellite was last reported.
+///
+/// The database is fed one GSV group (sky view) at a time:
+///   BeginSkyView(), UpdateSatellite() for every satellite, EndSkyView().
+/// Satellites of the group's constellations that were not listed are marked out of view.
+///
+class CNMEASatelliteDatabase
+{
+public:
+	static const int				c_nMaxSatellites = 256;						///< Maximum number of satellites in the database
+	static const int				c_nMaxPRN = 256;							///< PRNs must be between 1 and c_nMaxPRN - 1
+	static const uint16_t			c_uNoSatellite = 0xFFFF;					///< Empty entry in the (constellation, PRN) index
+
+private:
+	int								m_nCount;									///< Number of satellites in the table
+	uint32_t						m_uSerial;									///< Serial of the most recent change
+	uint32_t						m_uSkyView;									///< Number of the sky view being received
+	uint32_t						m_uSkyViewConstellations;					///< Constellations (bit per CONSTELLATION_E) listed in the current sky view
+	CNMEAParserData::TALKER_ID_E	m_nSkyViewTalkerID;							///< Talker of the current sky view
+
+	uint16_t						m_puIndex[CNMEAParserData::CONST_COUNT][c_nMaxPRN];	///< (constellation, PRN) to row
+
+	uint8_t							m_puConstellation[c_nMaxSatellites];		///< CONSTELLATION_E
+	uint16_t						m_puPRN[c_nMaxSatellites];					///< PRN
+	int8_t							m_pnElevation[c_nMaxSatellites];			///< Elevation (degrees)
+	uint16_t						m_puAzimuth[c_nMaxSatellites];				///< Azimuth (degrees)
+	uint8_t							m_puSNR[c_nMaxSatellites];					///< Signal to noise ratio (dB-Hz)
+	uint8_t							m_puChangeMask[c_nMaxSatellites];			///< SAT_CHANGE_E bits of the most recent change
+	uint8_t							m_pbInView[c_nMaxSatellites];				///< Listed in the last complete sky view
+	uint32_t						m_puChangeSerial[c_nMaxSatellites];			///< Serial of the most recent change
+	uint32_t						m_puSkyView[c_nMaxSatellites];				///< Last sky view that listed the satellite
+	int64_t							m_pnLastSeenNs[c_nMaxSatellites];			///< Last time the satellite was reported
+
+public:
+	CNMEASatelliteDatabase();
+
+	///
+	/// \brief Removes all satellites
+	///
+	void Reset(void);
+
+	///
+	/// \brief Returns the constellation of a satellite reported by the given talker
+	///
+	/// Single constellation talkers (GL, GA, GB/BD, QZ) map directly. GP and GN report
+	/// several constellations and are split by the NMEA PRN ranges: 1-32 GPS,
+	/// 33-64 and 120-158 SBAS, 65-96 GLONASS, 193-202 QZSS.
+	///
+	/// \param nTalkerID Talker that sent the GSV sentence
+	/// \param nPRN PRN as reported in the GSV sentence
+	/// \return The constellation
+	///
+	static CNMEAParserData::CONSTELLATION_E GetConstellation(CNMEAParserData::TALKER_ID_E nTalkerID, int nPRN);
+
+	///
+	/// \brief Starts a new sky view (the first sentence of a GSV group)
+	/// \param nTalkerID Talker that sent the GSV group
+	///
+	void BeginSkyView(CNMEAParserData::TALKER_ID_E nTalkerID);
+
+	///
+	/// \brief Adds or updates a satellite of the current sky view
+	///
+	/// \param nPRN PRN as reported in the GSV sentence
+	/// \param nElevation Elevation (degrees)
+	/// \param nAzimuth Azimuth (degrees)
+	/// \param nSNR Signal to noise ratio (dB-Hz), 0 if not tracked
+	/// \param nTimeNs Receive time, monotonic (steady) clock in nanoseconds
+	/// \return ERROR_OK if successful, ERROR_FAIL for an invalid PRN, ERROR_TOO_MANY_SATELLITES if the table is full
+	///
+	CNMEAParserData::ERROR_E UpdateSatellite(int nPRN, int nElevation, int nAzimuth, int nSNR, int64_t nTimeNs);
+
+	///
+	/// \brief Adds or updates a satellite of the current sky view whose constellation is known
+	///
+	/// Used for sources that report the constellation explicitly (UBX NAV-SAT). nPRN uses the
+	/// NMEA numbering so the satellite shares its row with the one reported in GSV.
+	///
+	/// \param nConstellation Constellation of the satellite
+	/// \param nPRN PRN (NMEA numbering)
+	/// \param nElevation Elevation (degrees)
+	/// \param nAzimuth Azimuth (degrees)
+	/// \param nSNR Signal to noise ratio (dB-Hz), 0 if not tracked
+	/// \param nTimeNs Receive time, monotonic (steady) clock in nanoseconds
+	/// \return ERROR_OK if successful, ERROR_FAIL for an invalid PRN, ERROR_TOO_MANY_SATELLITES if the table is full
+	///
+	CNMEAParserData::ERROR_E UpdateSatellite(CNMEAParserData::CONSTELLATION_E nConstellation, int nPRN, int nElevation, int nAzimuth, int nSNR, int64_t nTimeNs);
+
+	///
+	/// \brief Ends the current sky view (the last sentence of a GSV group)
+	///
+	/// Satellites of the constellations in this sky view that were not listed are marked out of view.
+	///
+	void EndSkyView(void);
+
+	///
+	/// \brief Returns the number of satellites in the table
+	///
+	int GetCount(void) const { return m_nCount; }
+
+	///
+	/// \brief Returns the serial of the most recent change, 0 if nothing changed yet
+	///
+	uint32_t GetSerial(void) const { return m_uSerial; }
+
+	///
+	/// \brief Returns the number of the sky view being received, it changes with every BeginSkyView()
+	///
+	uint32_t GetSkyView(void) const { return m_uSkyView; }
+
+	///
+	/// \brief Returns the row of a satellite, or -1 if it is not in the table
+	///
+	int Find(CNMEAParserData::CONSTELLATION_E nConstellation, int nPRN) const;
+
+	///
+	/// \brief Copies a satellite out of the table
+	///
+	/// \param nRow Row, 0 to GetCount() - 1
+	/// \param satellite Returned satellite
+	/// \return ERROR_OK if successful, ERROR_FAIL if nRow is out of range
+	///
+	CNMEAParserData::ERROR_E GetSatellite(int nRow, CNMEAParserData::SATELLITE_T &satellite) const;
+
+	///
+	/// \brief Copies the satellites that changed after a given serial
+	///
+	/// \param uSinceSerial Serial the caller already has, 0 for all satellites
+	/// \param pSatellites Array to receive the changed satellites
+	/// \param nMaxSatellites Size of pSatellites
+	/// \param uSerial Returned serial to pass as uSinceSerial next time. Left at uSinceSerial if
+	///        pSatellites was too small; use c_nMaxSatellites entries to always get every change.
+	/// \return Number of satellites copied
+	///
+	int GetChanged(uint32_t uSinceSerial, CNMEAParserData::SATELLITE_T *pSatellites, int nMaxSatellites, uint32_t &uSerial) const;
+
+	//
+	// Direct access to the columns, nRow must be between 0 and GetCount() - 1
+	//
+	CNMEAParserData::CONSTELLATION_E GetConstellation(int nRow) const { return (CNMEAParserData::CONSTELLATION_E)m_puConstellation[nRow]; }
+	int GetPRN(int nRow) const { return m_puPRN[nRow]; }
+	int GetElevation(int nRow) const { return m_pnElevation[nRow]; }
+	int GetAzimuth(int nRow) const { return m_puAzimuth[nRow]; }
+	int GetSNR(int nRow) const { return m_puSNR[nRow]; }
+	bool IsInView(int nRow) const { return m_pbInView[nRow] != 0; }
+	uint8_t GetChangeMask(int nRow) const { return m_puChangeMask[nRow]; }
+	uint32_t GetChangeSerial(int nRow) const { return m_puChangeSerial[nRow]; }
+	int64_t GetLastSeen(int nRow) const { return m_pnLastSeenNs[nRow]; }
+
+private:
+	///
+	/// \brief Stamps a row with a new change serial
+	///
+	void MarkChanged(int nRow, uint8_t uChangeMask);
+};
@@ -0,0 +1,243 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include "NMEAScan.h"
+
+#if defined(NMEA_SCAN_AVX2)
+#include <immintrin.h>
+#elif defined(NMEA_SCAN_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && defined(NMEA_SCAN_SSE2)
+#include <intrin.h>
+#endif
+
+namespace {
+
+#if defined(NMEA_SCAN_SSE2)
+	///
+	/// \brief Index of the lowest set bit. uMask must not be 0.
+	///
+	inline unsigned int LowestBit(uint32_t uMask)
+	{
+#if defined(_MSC_VER)
+		unsigned long uIndex;
+		_BitScanForward(&uIndex, uMask);
+		return (unsigned int)uIndex;
+#else
+		return (unsigned int)__builtin_ctz(uMask);
+#endif
+	}
+#endif
+
+	///
+	/// \brief Scalar tail for the data terminator search
+	///
+	inline size_t FindDataEndScalar(const char *pData, size_t uStart, size_t uLength)
+	{
+		for (size_t i = uStart; i < uLength; i++)
+		{
+			if (pData[i] == '*' || pData[i] == '\r')
+			{
+				return i;
+			}
+		}
+		return uLength;
+	}
+}
+
+size_t CNMEAScan::FindChar(const char * pData, size_t uLength, char cFind)
+{
+	size_t i = 0;
+
+#if defined(NMEA_SCAN_AVX2)
+	const __m256i vFind32 = _mm256_set1_epi8(cFind);
+	for (; i + 32 <= uLength; i += 32)
+	{
+		__m256i vData = _mm256_loadu_si256((const __m256i *)(pData + i));
+		uint32_t uMask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(vData, vFind32));
+		if (uMask != 0)
+		{
+			return i + LowestBit(uMask);
+		}
+	}
+#endif
+
+#if defined(NMEA_SCAN_SSE2)
+	const __m128i vFind = _mm_set1_epi8(cFind);
+	for (; i + 16 <= uLength; i += 16)
+	{
+		__m128i vData = _mm_loadu_si128((const __m128i *)(pData + i));
+		uint32_t uMask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(vData, vFind));
+		if (uMask != 0)
+		{
+			return i + LowestBit(uMask);
+		}
+	}
+#endif
+
+	for (; i < uLength; i++)
+	{
+		if (pData[i] == cFind)
+		{
+			return i;
+		}
+	}
+	return uLength;
+}
+
+size_t CNMEAScan::FindEitherChar(const char * pData, size_t uLength, char cFind1, char cFind2)
+{
+	size_t i = 0;
+
+#if defined(NMEA_SCAN_AVX2)
+	const __m256i vFind1_32 = _mm256_set1_epi8(cFind1);
+	const __m256i vFind2_32 = _mm256_set1_epi8(cFind2);
+	for (; i + 32 <= uLength; i += 32)
+	{
+		__m256i vData = _mm256_loadu_si256((const __m256i *)(pData + i));
+		__m256i vHit = _mm256_or_si256(_mm256_cmpeq_epi8(vData, vFind1_32), _mm256_cmpeq_epi8(vData, vFind2_32));
+		uint32_t uMask = (uint32_t)_mm256_movemask_epi8(vHit);
+		if (uMask != 0)
+		{
+			return i + LowestBit(uMask);
+		}
+	}
+#endif
+
+#if defined(NMEA_SCAN_SSE2)
+	const __m128i vFind1 = _mm_set1_epi8(cFind1);
+	const __m128i vFind2 = _mm_set1_epi8(cFind2);
+	for (; i + 16 <= uLength; i += 16)
+	{
+		__m128i vData = _mm_loadu_si128((const __m128i *)(pData + i));
+		__m128i vHit = _mm_or_si128(_mm_cmpeq_epi8(vData, vFind1), _mm_cmpeq_epi8(vData, vFind2));
+		uint32_t uMask = (uint32_t)_mm_movemask_epi8(vHit);
+		if (uMask != 0)
+		{
+			return i + LowestBit(uMask);
+		}
+	}
+#endif
+
+	for (; i < uLength; i++)
+	{
+		if (pData[i] == cFind1 || pData[i] == cFind2)
+		{
+			return i;
+		}
+	}
+	return uLength;
+}
+
+size_t CNMEAScan::FindDataEnd(const char * pData, size_t uLength)
+{
+	size_t i = 0;
+
+#if defined(NMEA_SCAN_AVX2)
+	const __m256i vStar32 = _mm256_set1_epi8('*');
+	const __m256i vCR32 = _mm256_set1_epi8('\r');
+	for (; i + 32 <= uLength; i += 32)
+	{
+		__m256i vData = _mm256_loadu_si256((const __m256i *)(pData + i));
+		__m256i vHit = _mm256_or_si256(_mm256_cmpeq_epi8(vData, vStar32), _mm256_cmpeq_epi8(vData, vCR32));
+		uint32_t uMask = (uint32_t)_mm256_movemask_epi8(vHit);
+		if (uMask != 0)
+		{
+			return i + LowestBit(uMask);
+		}
+	}
+#endif
+
+#if defined(NMEA_SCAN_SSE2)
+	const __m128i vStar = _mm_set1_epi8('*');
+	const __m128i vCR = _mm_set1_epi8('\r');
+	for (; i + 16 <= uLength; i += 16)
+	{
+		__m128i vData = _mm_loadu_si128((const __m128i *)(pData + i));
+		__m128i vHit = _mm_or_si128(_mm_cmpeq_epi8(vData, vStar), _mm_cmpeq_epi8(vData, vCR));
+		uint32_t uMask = (uint32_t)_mm_movemask_epi8(vHit);
+		if (uMask != 0)
+		{
+			return i + LowestBit(uMask);
+		}
+	}
+#endif
+
+	return FindDataEndScalar(pData, i, uLength);
+}
+
+uint8_t CNMEAScan::XorReduce(const char * pData, size_t uLength)
+{
+	size_t i = 0;
+	uint8_t u8Checksum = 0;
+
+#if defined(NMEA_SCAN_SSE2)
+	if (uLength >= 16)
+	{
+		//
+		// XOR 16 byte lanes together, then fold the lane down to a single byte
+		//
+		__m128i vAcc = _mm_setzero_si128();
+#if defined(NMEA_SCAN_AVX2)
+		if (uLength >= 32)
+		{
+			__m256i vAcc32 = _mm256_setzero_si256();
+			for (; i + 32 <= uLength; i += 32)
+			{
+				vAcc32 = _mm256_xor_si256(vAcc32, _mm256_loadu_si256((const __m256i *)(pData + i)));
+			}
+			vAcc = _mm_xor_si128(_mm256_castsi256_si128(vAcc32), _mm256_extracti128_si256(vAcc32, 1));
+		}
+#endif
+		for (; i + 16 <= uLength; i += 16)
+		{
+			vAcc = _mm_xor_si128(vAcc, _mm_loadu_si128((const __m128i *)(pData + i)));
+		}
+		vAcc = _mm_xor_si128(vAcc, _mm_srli_si128(vAcc, 8));
+		vAcc = _mm_xor_si128(vAcc, _mm_srli_si128(vAcc, 4));
+		vAcc = _mm_xor_si128(vAcc, _mm_srli_si128(vAcc, 2));
+		vAcc = _mm_xor_si128(vAcc, _mm_srli_si128(vAcc, 1));
+		u8Checksum = (uint8_t)_mm_cvtsi128_si32(vAcc);
+	}
+#endif
+
+	for (; i < uLength; i++)
+	{
+		u8Checksum ^= (uint8_t)pData[i];
+	}
+	return u8Checksum;
+}
+
+const char * CNMEAScan::GetImplementation(void)
+{
+#if defined(NMEA_SCAN_AVX2)
+	return "AVX2";
+#elif defined(NMEA_SCAN_SSE2)
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
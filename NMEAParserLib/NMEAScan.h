@@ -0,0 +1,95 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+
+///
+/// Define NMEA_SCAN_NO_SIMD to force the portable scalar scanners
+///
+#if !defined(NMEA_SCAN_NO_SIMD)
+#if defined(__AVX2__)
+#define NMEA_SCAN_AVX2	1
+#define NMEA_SCAN_SSE2	1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NMEA_SCAN_SSE2	1
+#endif
+#endif
+
+///
+/// \brief Block scanners used by CNMEAParserPacket to frame sentences.
+///
+/// The packet state machine hands whole spans of the receive buffer to these functions
+/// instead of switching on every byte. With SSE2 (x86-64 baseline) 16 bytes are examined
+/// per step, 32 with AVX2 when the compiler targets it (-mavx2, /arch:AVX2). Other
+/// targets use the scalar fallback.
+///
+namespace CNMEAScan {
+
+	///
+	/// \brief Finds the first occurrence of cFind
+	///
+	/// \param pData Pointer to the data to scan
+	/// \param uLength Number of bytes to scan
+	/// \param cFind Byte to find
+	/// \return Offset of the byte or uLength if it was not found
+	///
+	size_t FindChar(const char *pData, size_t uLength, char cFind);
+
+	///
+	/// \brief Finds the first occurrence of either cFind1 or cFind2
+	///
+	/// \param pData Pointer to the data to scan
+	/// \param uLength Number of bytes to scan
+	/// \param cFind1 First byte to find
+	/// \param cFind2 Second byte to find
+	/// \return Offset of the first match or uLength if neither was found
+	///
+	size_t FindEitherChar(const char *pData, size_t uLength, char cFind1, char cFind2);
+
+	///
+	/// \brief Finds the end of the NMEA data section: the '*' checksum flag or '\r'
+	///
+	/// \param pData Pointer to the data to scan
+	/// \param uLength Number of bytes to scan
+	/// \return Offset of the terminator or uLength if it was not found
+	///
+	size_t FindDataEnd(const char *pData, size_t uLength);
+
+	///
+	/// \brief XOR of all bytes, ie: the NMEA checksum of the span
+	///
+	/// \param pData Pointer to the data
+	/// \param uLength Number of bytes
+	/// \return XOR of the bytes
+	///
+	uint8_t XorReduce(const char *pData, size_t uLength);
+
+	///
+	/// \brief Returns the name of the compiled in implementation ("AVX2", "SSE2" or "scalar")
+	///
+	const char *GetImplementation(void);
+};
@@ -0,0 +1,107 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <string.h>
+#include "NMEASentenceBase.h"
+#include "NMEASentenceFields.h"
+#include "NMEAFieldSchema.h"
+#include "NMEASnapshot.h"
+
+///
+/// \class CNMEASchemaSentence
+/// \brief Sentence decoder generated from a field schema (see CNMEAFieldSchema).
+///
+/// SCHEMA provides the data structure (SCHEMA::DATA_T) and the field list (SCHEMA::Decode).
+/// Every sentence starts from cleared data, so fields that are empty in the sentence read
+/// as 0. Adding a sentence type is a schema declaration and a typedef, see NMEASentenceHDT.h.
+///
+template <class SCHEMA>
+class CNMEASchemaSentence : public CNMEASentenceBase
+{
+public:
+	typedef typename SCHEMA::DATA_T	DATA_T;										///< Sentence data structure
+
+private:
+	DATA_T							m_SentenceData;								///< Sentence specific data
+	CNMEASnapshot<DATA_T>			m_Snapshot;									///< Last complete data, readable from other threads
+
+public:
+	CNMEASchemaSentence() { ResetData(); }
+	virtual ~CNMEASchemaSentence() {}
+
+	///
+	/// \brief Decodes the sentence as described by the schema
+	///
+	/// \param pCmd Talker command
+	/// \param pData Comma separated talker data string.
+	/// \return ERROR_OK if successful
+	///
+	virtual CNMEAParserData::ERROR_E ProcessSentence(char *pCmd, char *pData)
+	{
+		UNUSED_PARAM(pCmd);
+		CNMEASentenceFields Fields(pData);
+
+		memset(&m_SentenceData, 0, sizeof(m_SentenceData));
+		CNMEAFieldSchema::Decode<SCHEMA>(Fields, m_SentenceData);
+
+		m_uRxCount++;
+		m_Snapshot.Publish(m_SentenceData);
+
+		return CNMEAParserData::ERROR_OK;
+	}
+
+	///
+	/// \brief Clears the sentence specific data to a default value
+	///
+	virtual void ResetData(void)
+	{
+		m_uRxCount = 0;
+		memset(&m_SentenceData, 0, sizeof(m_SentenceData));
+		m_Snapshot.Publish(m_SentenceData);
+	}
+
+	///
+	/// \brief Returns the NMEA sentence data structure
+	///
+	DATA_T GetSentenceData(void) { return m_SentenceData; }
+	const DATA_T &GetSentenceData(void) const { return m_SentenceData; }
+
+	///
+	/// \brief Stores data decoded from a non NMEA source (UBX) as if the sentence was received
+	///
+	/// \param data New sentence data
+	///
+	void SetSentenceData(const DATA_T &data)
+	{
+		m_SentenceData = data;
+		m_uRxCount++;
+		m_Snapshot.Publish(m_SentenceData);
+	}
+
+	///
+	/// \brief Returns the published copy of the sentence data. Safe to read from any thread.
+	///
+	const CNMEASnapshot<DATA_T> &GetSnapshot(void) const { return m_Snapshot; }
+};
@@ -24,9 +24,15 @@
 */
 #include "NMEASentenceBase.h"
 
+///
+/// \brief Returned by the histogram getters of a sentence that was never timed
+///
+static const CNMEAHistogram s_EmptyHistogram;
+
 
 
 CNMEASentenceBase::CNMEASentenceBase() :
+	m_nRxTimeNs(0),
 	m_uRxCount(0)
 {
 }
@@ -36,6 +42,40 @@ CNMEASentenceBase::~CNMEASentenceBase()
 {
 }
 
+void CNMEASentenceBase::RecordTiming(int64_t nRxTimeNs, int64_t nDecodedNs)
+{
+	if (!m_pTiming)
+	{
+		m_pTiming.reset(new TIMING_T);
+	}
+	if (m_nRxTimeNs != 0)
+	{
+		m_pTiming->interArrival.Record(nRxTimeNs - m_nRxTimeNs);
+	}
+	m_pTiming->latency.Record(nDecodedNs - nRxTimeNs);
+	m_nRxTimeNs = nRxTimeNs;
+}
+
+void CNMEASentenceBase::ResetTiming(void)
+{
+	m_nRxTimeNs = 0;
+	if (m_pTiming)
+	{
+		m_pTiming->interArrival.Reset();
+		m_pTiming->latency.Reset();
+	}
+}
+
+const CNMEAHistogram & CNMEASentenceBase::GetInterArrivalHistogram(void) const
+{
+	return m_pTiming ? m_pTiming->interArrival : s_EmptyHistogram;
+}
+
+const CNMEAHistogram & CNMEASentenceBase::GetLatencyHistogram(void) const
+{
+	return m_pTiming ? m_pTiming->latency : s_EmptyHistogram;
+}
+
 CNMEAParserData::ERROR_E CNMEASentenceBase::GetField(char * pData, char * pField, int nFieldNum, int nMaxFieldLen)
 {
 	//
@@ -25,7 +25,9 @@
 
 #pragma once
 #include <string>
+#include <memory>
 #include "NMEAParserData.h"
+#include "NMEAHistogram.h"
 
 ///
 /// \class CNMEASentenceBase
@@ -39,13 +41,24 @@ public:
 private:
 	std::string						m_strSentenceID;							///< Sentence ID, ie: GGA, RMC, etc...
 	CNMEAParserData::TALKER_ID_E	m_nTalkerID;								///< Talker ID, ie: GP, GN, etc...
+	int64_t							m_nRxTimeNs;								///< Start of message time of the last sentence
+
+	///
+	/// \brief Timing histograms, allocated by the first RecordTiming() so sentence objects that are never timed stay small
+	///
+	typedef struct _TIMING_T {
+		CNMEAHistogram				interArrival;								///< Time between the start of consecutive sentences
+		CNMEAHistogram				latency;									///< Time from start of message until the sentence was decoded
+	} TIMING_T;
+
+	std::unique_ptr<TIMING_T>		m_pTiming;									///< Timing histograms, NULL until the first RecordTiming()
 
 protected:
 	unsigned int					m_uRxCount;									///< Receive count
 
 public:
 	CNMEASentenceBase();
-	~CNMEASentenceBase();
+	virtual ~CNMEASentenceBase();
 
 	///
 	/// \brief Process the data from the specific NMEA sentence. 
@@ -75,7 +88,35 @@ public:
 	/// \brief Returns the receive count for this sentence
 	/// \return unsigned int - receive count
 	///
-	unsigned int GetRxCount(void) {	return m_uRxCount;	}
+	unsigned int GetRxCount(void) const { return m_uRxCount; }
+
+	///
+	/// \brief Records the timing of a sentence. Called by the parser after every decode.
+	///
+	/// \param nRxTimeNs Start of message time of the sentence
+	/// \param nDecodedNs Time the sentence was decoded
+	///
+	void RecordTiming(int64_t nRxTimeNs, int64_t nDecodedNs);
+
+	///
+	/// \brief Clears the timing histograms
+	///
+	void ResetTiming(void);
+
+	///
+	/// \brief Returns the start of message time of the last sentence, monotonic (steady) clock in nanoseconds. 0 if none.
+	///
+	int64_t GetRxTimeNs(void) const { return m_nRxTimeNs; }
+
+	///
+	/// \brief Returns the histogram of the time between the start of consecutive sentences
+	///
+	const CNMEAHistogram &GetInterArrivalHistogram(void) const;
+
+	///
+	/// \brief Returns the histogram of the time from start of message until the sentence was decoded
+	///
+	const CNMEAHistogram &GetLatencyHistogram(void) const;
 protected:
 	///
 	/// \brief
@@ -86,6 +127,9 @@ protected:
 	///	\param	nFieldNum -		Field offset to get
 	///	\param	nMaxFieldLen -	Maximum of bytes pFiled can handle
 	///
+	/// Note: every call rescans pData from the start. Decoders reading more than one
+	/// field should tokenize the data once with CNMEASentenceFields instead.
+	///
 	CNMEAParserData::ERROR_E GetField(char * pData, char * pField, int nFieldNum, int nMaxFieldLen);
 
 };
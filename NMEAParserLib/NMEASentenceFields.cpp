@@ -0,0 +1,59 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include "NMEASentenceFields.h"
+
+CNMEASentenceFields::CNMEASentenceFields(const char * pData) :
+	m_pData(pData),
+	m_nFieldCount(0)
+{
+	if (pData == NULL)
+	{
+		m_pData = "";
+		return;
+	}
+
+	//
+	// Walk the data once, closing a field at every ',' and at the end of the data
+	//
+	size_t uStart = 0;
+	size_t i = 0;
+	for (;;)
+	{
+		char cData = pData[i];
+		if (cData == ',' || cData == '*' || cData == '\0')
+		{
+			m_Fields[m_nFieldCount].uOffset = (uint16_t)uStart;
+			m_Fields[m_nFieldCount].uLength = (uint16_t)(i - uStart);
+			m_nFieldCount++;
+
+			if (cData != ',' || m_nFieldCount >= c_nMaxFields)
+			{
+				break;
+			}
+			uStart = i + 1;
+		}
+		i++;
+	}
+}
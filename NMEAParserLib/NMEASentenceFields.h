@@ -0,0 +1,113 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include "NMEAParserData.h"
+#include "NMEAFieldParser.h"
+
+///
+/// \class CNMEASentenceFields
+/// \brief Splits the comma separated data of a NMEA sentence into fields in a single pass.
+///
+/// The sentence data is scanned once and every field is recorded as an (offset, length)
+/// view into the original data. Sentence decoders then read fields by index without
+/// rescanning the data or copying the field into a temporary buffer.
+///
+/// Fields are not null terminated. They end at the next ',' or at the end of the data
+/// so the C library numeric conversions (atoi, atof, ...) can be used directly on GetField().
+///
+class CNMEASentenceFields
+{
+public:
+	static const int				c_nMaxFields = 40;							///< Maximum number of fields tracked per sentence
+
+private:
+	///
+	/// \brief View of a single field within the sentence data
+	///
+	typedef struct _FIELD_T {
+		uint16_t					uOffset;									///< Offset of the first field character
+		uint16_t					uLength;									///< Number of characters in the field
+	} FIELD_T;
+
+	const char *					m_pData;									///< Sentence data the views point into
+	int								m_nFieldCount;								///< Number of fields found
+	FIELD_T							m_Fields[c_nMaxFields];						///< Field views
+
+public:
+	///
+	/// \brief Tokenizes the comma separated sentence data
+	///
+	/// \param pData Comma separated talker data string. Scanning stops at '\0' or '*'.
+	///
+	explicit CNMEASentenceFields(const char *pData);
+
+	///
+	/// \brief Returns the number of fields found in the sentence
+	///
+	int GetCount(void) const { return m_nFieldCount; }
+
+	///
+	/// \brief Returns true if the field exists and is not empty
+	///
+	bool IsValid(int nField) const { return nField >= 0 && nField < m_nFieldCount && m_Fields[nField].uLength != 0; }
+
+	///
+	/// \brief Returns a pointer to the first character of the field (not null terminated)
+	///
+	/// Check the field with IsValid() first. An empty string is returned for fields that do not exist.
+	///
+	const char *GetField(int nField) const { return (nField >= 0 && nField < m_nFieldCount) ? m_pData + m_Fields[nField].uOffset : ""; }
+
+	///
+	/// \brief Returns the number of characters in the field, 0 if the field is empty or does not exist
+	///
+	size_t GetLength(int nField) const { return (nField >= 0 && nField < m_nFieldCount) ? m_Fields[nField].uLength : 0; }
+
+	///
+	/// \brief Returns the first character of the field or '\0' if the field is empty or does not exist
+	///
+	char GetChar(int nField) const { return IsValid(nField) ? m_pData[m_Fields[nField].uOffset] : '\0'; }
+
+	///
+	/// \brief Converts the field to an integer (see CNMEAFieldParser::ParseInt)
+	/// \return ERROR_OK if successful. nValue is left untouched on failure.
+	///
+	CNMEAParserData::ERROR_E GetInt(int nField, int &nValue) const { return CNMEAFieldParser::ParseInt(GetField(nField), GetLength(nField), nValue); }
+
+	///
+	/// \brief Converts the field to a double (see CNMEAFieldParser::ParseDouble)
+	/// \return ERROR_OK if successful. dValue is left untouched on failure.
+	///
+	CNMEAParserData::ERROR_E GetDouble(int nField, double &dValue) const { return CNMEAFieldParser::ParseDouble(GetField(nField), GetLength(nField), dValue); }
+
+	///
+	/// \brief Converts a (d)ddmm.mmmmm field to decimal degrees (see CNMEAFieldParser::ParseCoordinate)
+	/// \return ERROR_OK if successful. dDegrees is left untouched on failure.
+	///
+	CNMEAParserData::ERROR_E GetCoordinate(int nField, int nDegreeDigits, double &dDegrees) const { return CNMEAFieldParser::ParseCoordinate(GetField(nField), GetLength(nField), nDegreeDigits, dDegrees); }
+};
@@ -22,12 +22,40 @@
 *  SOFTWARE.
 *
 */
-#include <stdlib.h>
 #include "NMEASentenceGGA.h"
+#include "NMEASentenceFields.h"
+#include "NMEAFieldSchema.h"
+
+namespace {
+	static const double			c_dVSpeedJerkDensity = 0.1;						///< m^2/s^5, see CNMEAKinematicFilter
+	static const double			c_dVSpeedSigmaPerHDOP = 4.5;					///< Altitude error (meters, 1 sigma) per unit of HDOP
+	static const double			c_dVSpeedMaxGap = 10.0;							///< Start again after this many seconds without an altitude
+	static const double			c_dVSpeedInitialVariance = 100.0;				///< (m/s)^2, the vertical speed of the first altitude is not known
+	static const double			c_dAccelInitialVariance = 4.0;					///< (m/s^2)^2
+	static const double			c_dSecondsPerDay = 86400.0;
+}
+
+///
+/// \brief --GGA field schema. Empty fields keep the last received value.
+///
+typedef CNMEAFieldSchema::Fields<
+	//	$--GGA,hhmmss.ss,llll.ll,a,yyyyy.yy,a,x,xx,x.x,x.x,M,x.x,M,x.x,xxxx*hh
+	//	       0         1       2 3        4 5 6  7   8   9 10  11 12  13
+	CNMEAFieldSchema::Time<CNMEAParserData::GGA_DATA_T, 0>,
+	CNMEAFieldSchema::Coordinate<CNMEAParserData::GGA_DATA_T, 1, 2, &CNMEAParserData::GGA_DATA_T::m_dLatitude>,
+	CNMEAFieldSchema::Coordinate<CNMEAParserData::GGA_DATA_T, 3, 3, &CNMEAParserData::GGA_DATA_T::m_dLongitude>,
+	CNMEAFieldSchema::Digit<CNMEAParserData::GGA_DATA_T, 5, CNMEAParserData::GPS_QUALITY_E, &CNMEAParserData::GGA_DATA_T::m_nGPSQuality>,
+	CNMEAFieldSchema::Int<CNMEAParserData::GGA_DATA_T, 6, &CNMEAParserData::GGA_DATA_T::m_nSatsInView>,
+	CNMEAFieldSchema::Double<CNMEAParserData::GGA_DATA_T, 7, &CNMEAParserData::GGA_DATA_T::m_dHDOP>,
+	CNMEAFieldSchema::Double<CNMEAParserData::GGA_DATA_T, 8, &CNMEAParserData::GGA_DATA_T::m_dAltitudeMSL>,
+	CNMEAFieldSchema::Double<CNMEAParserData::GGA_DATA_T, 9, &CNMEAParserData::GGA_DATA_T::m_dGeoidalSep>,
+	CNMEAFieldSchema::Double<CNMEAParserData::GGA_DATA_T, 11, &CNMEAParserData::GGA_DATA_T::m_dDifferentialAge>,
+	CNMEAFieldSchema::Int<CNMEAParserData::GGA_DATA_T, 13, &CNMEAParserData::GGA_DATA_T::m_nDifferentialID>
+> GGA_SCHEMA_T;
 
 CNMEASentenceGGA::CNMEASentenceGGA() :
-	m_nOldVSpeedSeconds(0),
-	m_dOldVSpeedAlt(0.0)
+	m_VSpeedFilter(c_dVSpeedJerkDensity),
+	m_dVSpeedTimeOfDay(0.0)
 {
 	ResetData();
 }
@@ -38,130 +66,53 @@ CNMEASentenceGGA::~CNMEASentenceGGA() {
 CNMEAParserData::ERROR_E CNMEASentenceGGA::ProcessSentence(char * pCmd, char * pData)
 {
     UNUSED_PARAM(pCmd);
-    char szField[c_nMaxField];
-	char szTemp[c_nMaxField];
+	CNMEASentenceFields Fields(pData);
 
-	if (GetField(pData, szField, 0, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.m_nHour = (szField[0] - '0') * 10 + (szField[1] - '0');
-		m_SentenceData.m_nMinute = (szField[2] - '0') * 10 + (szField[3] - '0');
-		m_SentenceData.m_nSecond = (szField[4] - '0') * 10 + (szField[5] - '0');
-	}
+	CNMEAFieldSchema::Decode<GGA_SCHEMA_T>(Fields, m_SentenceData);
 
 	//
-	// Latitude
+	// Derive vertical speed (bonus), meters per minute. The elapsed time comes from the full
+	// UTC time so the hour and day boundaries do not matter, and the altitude goes through a
+	// constant acceleration filter instead of a difference of two noisy samples.
 	//
-	if (GetField(pData, szField, 1, c_nMaxField) == CNMEAParserData::ERROR_OK)
-	{
-		m_SentenceData.m_dLatitude = atof((char *)szField + 2) / 60.0;
-		szField[2] = '\0';
-		m_SentenceData.m_dLatitude += atof((char *)szField);
-
-	}
-	if (GetField(pData, szField, 2, c_nMaxField) == CNMEAParserData::ERROR_OK)
+	if (m_SentenceData.m_nGPSQuality != CNMEAParserData::GQ_FIX_NOT_AVAILABLE)
 	{
-		if (szField[0] == 'S')
+		double dTimeOfDay = (double)m_SentenceData.m_nHour * 3600.0 + (double)m_SentenceData.m_nMinute * 60.0 + m_SentenceData.m_dSecond;
+		double dElapsed = dTimeOfDay - m_dVSpeedTimeOfDay;
+		if (dElapsed < -c_dSecondsPerDay / 2.0)
 		{
-			m_SentenceData.m_dLatitude = -m_SentenceData.m_dLatitude;
+			dElapsed += c_dSecondsPerDay;
 		}
-	}
 
-	//
-	// Longitude
-	//
-	if (GetField(pData, szField, 3, c_nMaxField) == CNMEAParserData::ERROR_OK)
-	{
-		m_SentenceData.m_dLongitude = atof((char *)szField + 3) / 60.0;
-		szField[3] = '\0';
-		m_SentenceData.m_dLongitude += atof((char *)szField);
-	}
-	if (GetField(pData, szField, 4, c_nMaxField) == CNMEAParserData::ERROR_OK)
-	{
-		if (szField[0] == 'W')
+		double dHDOP = m_SentenceData.m_dHDOP > 0.0 ? m_SentenceData.m_dHDOP : 1.0;
+		double dVariance = (dHDOP * c_dVSpeedSigmaPerHDOP) * (dHDOP * c_dVSpeedSigmaPerHDOP);
+		if (m_VSpeedFilter.IsInitialized() == false || dElapsed < 0.0 || dElapsed > c_dVSpeedMaxGap)
 		{
-			m_SentenceData.m_dLongitude = -m_SentenceData.m_dLongitude;
+			m_VSpeedFilter.Initialize(m_SentenceData.m_dAltitudeMSL, dVariance, 0.0, c_dVSpeedInitialVariance, c_dAccelInitialVariance);
+			m_SentenceData.m_dVertSpeed = 0.0;
 		}
-	}
-
-	//
-	// GPS quality
-	//
-	if (GetField(pData, szField, 5, c_nMaxField) == CNMEAParserData::ERROR_OK)
-	{
-		m_SentenceData.m_nGPSQuality = (CNMEAParserData::GPS_QUALITY_E) ( (char)szField[0] - '0');
-	}
-
-	//
-	// Satellites in use
-	//
-	if (GetField(pData, szField, 6, c_nMaxField) == CNMEAParserData::ERROR_OK)
-	{
-		szTemp[0] = szField[0];
-		szTemp[1] = szField[1];
-		szTemp[2] = '\0';
-		m_SentenceData.m_nSatsInView = atoi(szTemp);
-	}
-
-	//
-	// HDOP
-	//
-	if (GetField(pData, szField, 7, c_nMaxField) == CNMEAParserData::ERROR_OK)
-	{
-		m_SentenceData.m_dHDOP = atof((char *)szField);
-	}
-
-	//
-	// Altitude, Meters, above mean sea level
-	//
-	if (GetField(pData, szField, 8, c_nMaxField) == CNMEAParserData::ERROR_OK)
-	{
-		m_SentenceData.m_dAltitudeMSL = atof((char *)szField);
-	}
-
-	//
-	// Geoidal separation, meters
-	//
-	if (GetField(pData, szField, 9, c_nMaxField) == CNMEAParserData::ERROR_OK)
-	{
-		m_SentenceData.m_dGeoidalSep = atof((char *)szField);
-	}
-
-	//
-	// Differential age
-	//
-	if (GetField(pData, szField, 11, c_nMaxField) == CNMEAParserData::ERROR_OK)
-	{
-		m_SentenceData.m_dDifferentialAge = atof((char *)szField);
-	}
-
-	//
-	// Differential ID
-	//
-	if (GetField(pData, szField, 13, c_nMaxField) == CNMEAParserData::ERROR_OK)
-	{
-		m_SentenceData.m_nDifferentialID = atoi((char *)szField);
-	}
-
-	//
-	// Derive vertical speed (bonus)
-	//
-	int nSeconds = (int)m_SentenceData.m_nMinute * 60 + (int)m_SentenceData.m_nSecond;
-	if (nSeconds > m_nOldVSpeedSeconds)
-	{
-		double dDiff = (double)(m_nOldVSpeedSeconds - nSeconds);
-		double dVal = dDiff / 60.0;
-		if (dVal != 0.0)
+		else if (dElapsed > 0.0)
 		{
-			m_SentenceData.m_dVertSpeed = (m_dOldVSpeedAlt - m_SentenceData.m_dAltitudeMSL) / dVal;
+			m_VSpeedFilter.Predict(dElapsed);
+			m_VSpeedFilter.Update(CNMEAKinematicAxis::STATE_POSITION, m_SentenceData.m_dAltitudeMSL, dVariance);
+			m_SentenceData.m_dVertSpeed = m_VSpeedFilter.GetVelocity() * 60.0;
 		}
+		m_dVSpeedTimeOfDay = dTimeOfDay;
 	}
-	m_dOldVSpeedAlt = m_SentenceData.m_dAltitudeMSL;
-	m_nOldVSpeedSeconds = nSeconds;
 
 	m_uRxCount++;
+	m_Snapshot.Publish(m_SentenceData);
 
 	return CNMEAParserData::ERROR_OK;
 }
 
+void CNMEASentenceGGA::SetSentenceData(const CNMEAParserData::GGA_DATA_T & data)
+{
+	m_SentenceData = data;
+	m_uRxCount++;
+	m_Snapshot.Publish(m_SentenceData);
+}
+
 void CNMEASentenceGGA::ResetData(void)
 {
 	m_uRxCount = 0;
@@ -172,10 +123,14 @@ void CNMEASentenceGGA::ResetData(void)
 	m_SentenceData.m_dLatitude = 0.0;
 	m_SentenceData.m_dLongitude = 0.0;
 	m_SentenceData.m_dVertSpeed = 0.0;
+	m_VSpeedFilter.Reset();
 	m_SentenceData.m_nDifferentialID = 0;
 	m_SentenceData.m_nGPSQuality = CNMEAParserData::GQ_FIX_NOT_AVAILABLE;
 	m_SentenceData.m_nHour = 0;
 	m_SentenceData.m_nMinute = 0;
 	m_SentenceData.m_nSatsInView = 0;
 	m_SentenceData.m_nSecond = 0;
+	m_SentenceData.m_dSecond = 0.0;
+
+	m_Snapshot.Publish(m_SentenceData);
 }
@@ -27,6 +27,8 @@
 #include <string>
 #include "NMEAParserData.h"
 #include "NMEASentenceBase.h"
+#include "NMEASnapshot.h"
+#include "NMEAKinematicFilter.h"
 #include "NMEAParserData.h"
 
 ///
@@ -37,8 +39,9 @@ class CNMEASentenceGGA : public CNMEASentenceBase
 {
 private:
 	CNMEAParserData::GGA_DATA_T		m_SentenceData;								///< Sentence specific data
-	int								m_nOldVSpeedSeconds;						///< Used to calculate vertical speed
-	double							m_dOldVSpeedAlt;							///< Used to calculate vertical speed
+	CNMEASnapshot<CNMEAParserData::GGA_DATA_T>	m_Snapshot;		///< Last complete data, readable from other threads
+	CNMEAKinematicAxis				m_VSpeedFilter;								///< Smooths the altitude into the vertical speed
+	double							m_dVSpeedTimeOfDay;							///< UTC time of the last altitude in m_VSpeedFilter (seconds since midnight)
 
 public:
 	CNMEASentenceGGA();
@@ -64,6 +67,19 @@ public:
 	/// \brief Returns the NMEA sentence data structure
 	///
 	CNMEAParserData::GGA_DATA_T GetSentenceData(void) { return m_SentenceData; }
+	const CNMEAParserData::GGA_DATA_T &GetSentenceData(void) const { return m_SentenceData; }
+
+	///
+	/// \brief Stores data decoded from a non NMEA source (UBX) as if the sentence was received
+	///
+	/// \param data New sentence data
+	///
+	void SetSentenceData(const CNMEAParserData::GGA_DATA_T &data);
+
+	///
+	/// \brief Returns the published copy of the sentence data. Safe to read from any thread.
+	///
+	const CNMEASnapshot<CNMEAParserData::GGA_DATA_T> &GetSnapshot(void) const { return m_Snapshot; }
 
 };
 
@@ -0,0 +1,47 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include "NMEASchemaSentence.h"
+
+///
+/// \brief --GLL Geographic position, latitude / longitude field schema
+///
+struct GLL_SCHEMA_T : CNMEAFieldSchema::Fields<
+	//	$--GLL,llll.ll,a,yyyyy.yy,a,hhmmss.ss,a,a*hh
+	//	       0       1 2        3 4         5 6
+	CNMEAFieldSchema::Coordinate<CNMEAParserData::GLL_DATA_T, 0, 2, &CNMEAParserData::GLL_DATA_T::m_dLatitude>,
+	CNMEAFieldSchema::Coordinate<CNMEAParserData::GLL_DATA_T, 2, 3, &CNMEAParserData::GLL_DATA_T::m_dLongitude>,
+	CNMEAFieldSchema::Time<CNMEAParserData::GLL_DATA_T, 4>,
+	CNMEAFieldSchema::Char<CNMEAParserData::GLL_DATA_T, 5, CNMEAParserData::RMC_STATUS_E, &CNMEAParserData::GLL_DATA_T::m_nStatus>,
+	CNMEAFieldSchema::Char<CNMEAParserData::GLL_DATA_T, 6, CNMEAParserData::FAA_MODE_E, &CNMEAParserData::GLL_DATA_T::m_nMode> >
+{
+	typedef CNMEAParserData::GLL_DATA_T DATA_T;
+};
+
+///
+/// \class CNMEASentenceGLL
+/// \brief --GLL Geographic position, latitude / longitude decoder
+///
+typedef CNMEASchemaSentence<GLL_SCHEMA_T> CNMEASentenceGLL;
@@ -22,9 +22,9 @@
 *  SOFTWARE.
 *
 */
-#include <stdlib.h>
 #include <string.h>
 #include "NMEASentenceGSA.h"
+#include "NMEASentenceFields.h"
 
 CNMEASentenceGSA::CNMEASentenceGSA() 
 {
@@ -38,28 +38,30 @@ CNMEAParserData::ERROR_E CNMEASentenceGSA::ProcessSentence(char * pCmd, char * p
 {
     UNUSED_PARAM(pCmd);
 
-	char szField[c_nMaxField];
+	CNMEASentenceFields Fields(pData);
 
 	// Auto mode
-	if (GetField(pData, szField, 0, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.nAutoMode = (szField[0] == 'A') ? CNMEAParserData::ASAM_AUTO : CNMEAParserData::ASAM_MANUAL;
+	if (Fields.IsValid(0)) {
+		m_SentenceData.nAutoMode = (Fields.GetChar(0) == 'A') ? CNMEAParserData::ASAM_AUTO : CNMEAParserData::ASAM_MANUAL;
 	}
 	else {
 		m_SentenceData.nAutoMode = CNMEAParserData::ASAM_MANUAL;
 	}
 	// Fix mode
-	if (GetField(pData, szField, 1, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.nMode = (CNMEAParserData::ACTIVE_SAT_MODE_E)atoi(szField);
+	int nMode = 0;
+	if (Fields.GetInt(1, nMode) == CNMEAParserData::ERROR_OK) {
+		m_SentenceData.nMode = (CNMEAParserData::ACTIVE_SAT_MODE_E)nMode;
 	}
 	else {
 		m_SentenceData.nMode = CNMEAParserData::ASM_FIX_NOT_AVAILABLE;
 	}
 
 	// Grab the satellite data
+	m_nSentenceIndex = m_nIndexCount;
+	m_nSentencePRNCount = CNMEAParserData::c_nMaxGSASats;
 	int nIndexCount = 0;
 	for (int i = 0; i < CNMEAParserData::c_nMaxGSASats; i++) {
-		if (GetField(pData, szField, 2 + i, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-			m_SentenceData.pnPRN[i + m_nIndexCount] = atoi(szField);
+		if (Fields.GetInt(2 + i, m_SentenceData.pnPRN[i + m_nIndexCount]) == CNMEAParserData::ERROR_OK) {
 			nIndexCount++;
 		}
 		else {
@@ -69,34 +71,35 @@ CNMEAParserData::ERROR_E CNMEASentenceGSA::ProcessSentence(char * pCmd, char * p
 	m_nIndexCount = nIndexCount;
 
 	// PDOP
-	if (GetField(pData, szField, 14, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.dPDOP = atof(szField);
-	}
-	else {
+	if (Fields.GetDouble(14, m_SentenceData.dPDOP) != CNMEAParserData::ERROR_OK) {
 		m_SentenceData.dPDOP = 0.0;
 	}
 
 	// HDOP
-	if (GetField(pData, szField, 15, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.dHDOP = atof(szField);
-	}
-	else {
+	if (Fields.GetDouble(15, m_SentenceData.dHDOP) != CNMEAParserData::ERROR_OK) {
 		m_SentenceData.dHDOP = 0.0;
 	}
 
 	// VDOP
-	if (GetField(pData, szField, 16, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.dVDOP = atof(szField);
-	}
-	else {
+	if (Fields.GetDouble(16, m_SentenceData.dVDOP) != CNMEAParserData::ERROR_OK) {
 		m_SentenceData.dVDOP = 0.0;
 	}
 
 	m_uRxCount++;
+	m_Snapshot.Publish(m_SentenceData);
 
 	return CNMEAParserData::ERROR_OK;
 }
 
+void CNMEASentenceGSA::SetSentenceData(const CNMEAParserData::GSA_DATA_T & data)
+{
+	m_SentenceData = data;
+	m_nSentenceIndex = 0;
+	m_nSentencePRNCount = CNMEAParserData::c_nMaxConstellation;
+	m_uRxCount++;
+	m_Snapshot.Publish(m_SentenceData);
+}
+
 void CNMEASentenceGSA::ResetData(void)
 {
 	m_uRxCount = 0;
@@ -109,4 +112,8 @@ void CNMEASentenceGSA::ResetData(void)
 
 	m_nOldGGACount = 0;
 	m_nIndexCount = 0;
+	m_nSentenceIndex = 0;
+	m_nSentencePRNCount = CNMEAParserData::c_nMaxGSASats;
+
+	m_Snapshot.Publish(m_SentenceData);
 }
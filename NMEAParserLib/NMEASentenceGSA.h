@@ -27,6 +27,7 @@
 #include <string>
 #include "NMEAParserData.h"
 #include "NMEASentenceBase.h"
+#include "NMEASnapshot.h"
 #include "NMEAParserData.h"
 
 ///
@@ -37,8 +38,11 @@ class CNMEASentenceGSA : public CNMEASentenceBase
 {
 private:
 	CNMEAParserData::GSA_DATA_T		m_SentenceData;								///< Sentence specific data
+	CNMEASnapshot<CNMEAParserData::GSA_DATA_T>	m_Snapshot;		///< Last complete data, readable from other threads
 	unsigned int					m_nOldGGACount;								///< Used to determine if we are getting more than one GSA sentence per position
 	int								m_nIndexCount;								///< Index into the satellite database
+	int								m_nSentenceIndex;							///< Index of the first PRN of the last sentence in pnPRN
+	int								m_nSentencePRNCount;						///< Number of PRN entries of the last sentence
 
 public:
 	CNMEASentenceGSA();
@@ -64,6 +68,19 @@ public:
 	/// \brief Returns the NMEA sentence data structure
 	///
 	CNMEAParserData::GSA_DATA_T GetSentenceData(void) {	return m_SentenceData; 	}
+	const CNMEAParserData::GSA_DATA_T &GetSentenceData(void) const { return m_SentenceData; }
+
+	///
+	/// \brief Stores data decoded from a non NMEA source (UBX) as if the sentence was received
+	///
+	/// \param data New sentence data
+	///
+	void SetSentenceData(const CNMEAParserData::GSA_DATA_T &data);
+
+	///
+	/// \brief Returns the published copy of the sentence data. Safe to read from any thread.
+	///
+	const CNMEASnapshot<CNMEAParserData::GSA_DATA_T> &GetSnapshot(void) const { return m_Snapshot; }
 
 	///
 	/// \brief This method is called from the same constellation GGA processing to let 
@@ -74,5 +91,13 @@ public:
 	/// sends another GSA sentence right after this one. We use the GGA to reset the count.
 	/// 
 	void FlagReceivedGGA() { m_nIndexCount = 0;	}
+
+	///
+	/// \brief Returns the PRN fields of the last sentence only
+	///
+	/// \param nCount Returned number of entries, unused fields are c_nInvlidPRN
+	/// \return Pointer to the first entry
+	///
+	const int *GetSentencePRNs(int &nCount) const { nCount = m_nSentencePRNCount; return &m_SentenceData.pnPRN[m_nSentenceIndex]; }
 };
 
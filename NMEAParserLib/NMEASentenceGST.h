@@ -0,0 +1,50 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include "NMEASchemaSentence.h"
+
+///
+/// \brief --GST GNSS pseudorange error statistics field schema
+///
+struct GST_SCHEMA_T : CNMEAFieldSchema::Fields<
+	//	$--GST,hhmmss.ss,x.x,x.x,x.x,x.x,x.x,x.x,x.x*hh
+	//	       0         1   2   3   4   5   6   7
+	CNMEAFieldSchema::Time<CNMEAParserData::GST_DATA_T, 0>,
+	CNMEAFieldSchema::Double<CNMEAParserData::GST_DATA_T, 1, &CNMEAParserData::GST_DATA_T::m_dRangeRMS>,
+	CNMEAFieldSchema::Double<CNMEAParserData::GST_DATA_T, 2, &CNMEAParserData::GST_DATA_T::m_dSemiMajor>,
+	CNMEAFieldSchema::Double<CNMEAParserData::GST_DATA_T, 3, &CNMEAParserData::GST_DATA_T::m_dSemiMinor>,
+	CNMEAFieldSchema::Double<CNMEAParserData::GST_DATA_T, 4, &CNMEAParserData::GST_DATA_T::m_dOrientation>,
+	CNMEAFieldSchema::Double<CNMEAParserData::GST_DATA_T, 5, &CNMEAParserData::GST_DATA_T::m_dLatitudeSigma>,
+	CNMEAFieldSchema::Double<CNMEAParserData::GST_DATA_T, 6, &CNMEAParserData::GST_DATA_T::m_dLongitudeSigma>,
+	CNMEAFieldSchema::Double<CNMEAParserData::GST_DATA_T, 7, &CNMEAParserData::GST_DATA_T::m_dAltitudeSigma> >
+{
+	typedef CNMEAParserData::GST_DATA_T DATA_T;
+};
+
+///
+/// \class CNMEASentenceGST
+/// \brief --GST GNSS pseudorange error statistics decoder
+///
+typedef CNMEASchemaSentence<GST_SCHEMA_T> CNMEASentenceGST;
@@ -23,12 +23,13 @@
 *
 */
 #include "NMEASentenceGSV.h"
-#include <stdlib.h>
+#include "NMEASentenceFields.h"
 #include <string.h>
 
 
 CNMEASentenceGSV::CNMEASentenceGSV()
 {
+	ResetData();
 }
 
 
@@ -39,82 +40,82 @@ CNMEASentenceGSV::~CNMEASentenceGSV()
 CNMEAParserData::ERROR_E CNMEASentenceGSV::ProcessSentence(char * pCmd, char * pData)
 {
     UNUSED_PARAM(pCmd);
-    char szField[c_nMaxField];
+	CNMEASentenceFields Fields(pData);
 
 	// Number of sentences
-	if (GetField(pData, szField, 0, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.nTotalNumberOfSentences = atoi(szField);
-	}
+	Fields.GetInt(0, m_SentenceData.nTotalNumberOfSentences);
 
 	// Number of sentences
-	if (GetField(pData, szField, 1, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.nSentenceNumber = atoi(szField);
-	}
+	Fields.GetInt(1, m_SentenceData.nSentenceNumber);
 
 	// Number of satellites in view
-	if (GetField(pData, szField, 2, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.nSatsInView = atoi(szField);
-	}
+	Fields.GetInt(2, m_SentenceData.nSatsInView);
 
+	CNMEAParserData::ERROR_E nErr = CNMEAParserData::ERROR_OK;
+	m_nSentenceSatCount = 0;
 	for (int i = 0; i < 4; i++) {
-		// Calculate the index into the satellite data array base on the sentence number
-		int nIndex = (m_SentenceData.nSentenceNumber - 1) * 4 + i;
-		if ((nIndex + 4) >= CNMEAParserData::c_nMaxConstellation) {
-			return CNMEAParserData::ERROR_TOO_MANY_SATELLITES;
-		}
+		CNMEAParserData::SAT_INFO_T satInfo;
 
 		// Get PRN
-		if (GetField(pData, szField, i*4 + 3, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-			m_SentenceData.SatInfo[nIndex].nPRN = atoi(szField);
-		}
-		else {
-			m_SentenceData.SatInfo[nIndex].nPRN = CNMEAParserData::c_nInvlidPRN;
+		if (Fields.GetInt(i * 4 + 3, satInfo.nPRN) != CNMEAParserData::ERROR_OK) {
+			satInfo.nPRN = CNMEAParserData::c_nInvlidPRN;
 		}
 		// Elevation
-		if (GetField(pData, szField, i * 4 + 4, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-			m_SentenceData.SatInfo[nIndex].dElevation = atof(szField);
-		}
-		else {
-			m_SentenceData.SatInfo[nIndex].dElevation = 0.0;
+		if (Fields.GetDouble(i * 4 + 4, satInfo.dElevation) != CNMEAParserData::ERROR_OK) {
+			satInfo.dElevation = 0.0;
 		}
 		// Azimuth
-		if (GetField(pData, szField, i * 4 + 5, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-			m_SentenceData.SatInfo[nIndex].dAzimuth = atof(szField);
-		}
-		else {
-			m_SentenceData.SatInfo[nIndex].dAzimuth = atof(szField);
+		if (Fields.GetDouble(i * 4 + 5, satInfo.dAzimuth) != CNMEAParserData::ERROR_OK) {
+			satInfo.dAzimuth = 0.0;
 		}
 		// Signal to noise
-		if (GetField(pData, szField, i * 4 + 6, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-			m_SentenceData.SatInfo[nIndex].nSNR = atoi(szField);
+		if (Fields.GetInt(i * 4 + 6, satInfo.nSNR) != CNMEAParserData::ERROR_OK) {
+			satInfo.nSNR = 0;
+		}
+
+		// Keep every satellite of this sentence, even the ones that do not fit into SatInfo[]
+		if (satInfo.nPRN != CNMEAParserData::c_nInvlidPRN) {
+			m_SentenceSats[m_nSentenceSatCount++] = satInfo;
 		}
-		else {
-			m_SentenceData.SatInfo[nIndex].nSNR = 0;
+
+		// Calculate the index into the satellite data array base on the sentence number
+		int nIndex = (m_SentenceData.nSentenceNumber - 1) * 4 + i;
+		if (nIndex < 0 || nIndex >= CNMEAParserData::c_nMaxConstellation) {
+			nErr = CNMEAParserData::ERROR_TOO_MANY_SATELLITES;
+			continue;
 		}
+		m_SentenceData.SatInfo[nIndex] = satInfo;
 	}
 
 	// Check if this was the last sentence and clear the rest of the constellation data
 	if (m_SentenceData.nSentenceNumber == m_SentenceData.nTotalNumberOfSentences) {
-		for (int i = m_SentenceData.nTotalNumberOfSentences * 4; i < CNMEAParserData::c_nMaxConstellation; i++) {
+		int nFirstUnused = m_SentenceData.nTotalNumberOfSentences > 0 ? m_SentenceData.nTotalNumberOfSentences * 4 : 0;
+		for (int i = nFirstUnused; i < CNMEAParserData::c_nMaxConstellation; i++) {
 			m_SentenceData.SatInfo[i].nPRN = CNMEAParserData::c_nInvlidPRN;
 			m_SentenceData.SatInfo[i].dAzimuth = 0.0;
 			m_SentenceData.SatInfo[i].dElevation = 0.0;
 			m_SentenceData.SatInfo[i].nSNR = 0;
 		}
+
+		//
+		// Readers only ever see a complete sky view
+		//
+		m_Snapshot.Publish(m_SentenceData);
 	}
 
 	m_uRxCount++;
 
-	return CNMEAParserData::ERROR_OK;
+	return nErr;
 }
 
 void CNMEASentenceGSV::ResetData(void)
 {
 	m_uRxCount = 0;
+	m_nSentenceSatCount = 0;
 	memset(&m_SentenceData.SatInfo[0], 0, sizeof(m_SentenceData.SatInfo));
 	m_SentenceData.nSatsInView = 0;
 	m_SentenceData.nSentenceNumber = 0;
 	m_SentenceData.nTotalNumberOfSentences = 0;
 
-
+	m_Snapshot.Publish(m_SentenceData);
 }
@@ -24,11 +24,15 @@
 */
 #pragma once
 #include "NMEASentenceBase.h"
+#include "NMEASnapshot.h"
 
 class CNMEASentenceGSV : public CNMEASentenceBase
 {
 private:
 	CNMEAParserData::GSV_DATA_T		m_SentenceData;								///< Sentence specific data
+	CNMEASnapshot<CNMEAParserData::GSV_DATA_T>	m_Snapshot;		///< Last complete data, readable from other threads
+	CNMEAParserData::SAT_INFO_T		m_SentenceSats[4];							///< Satellites listed in the last sentence
+	int								m_nSentenceSatCount;						///< Number of satellites in m_SentenceSats
 
 public:
 
@@ -55,6 +59,18 @@ public:
 	/// \brief Returns the NMEA sentence data structure
 	///
 	CNMEAParserData::GSV_DATA_T GetSentenceData(void) { return m_SentenceData; }
+	const CNMEAParserData::GSV_DATA_T &GetSentenceData(void) const { return m_SentenceData; }
+
+	///
+	/// \brief Returns the published copy of the sentence data. Safe to read from any thread.
+	///
+	const CNMEASnapshot<CNMEAParserData::GSV_DATA_T> &GetSnapshot(void) const { return m_Snapshot; }
+
+	///
+	/// \brief Returns the satellites listed in the last sentence, including those beyond SatInfo[]
+	/// \param nCount Returned number of satellites (0 to 4)
+	///
+	const CNMEAParserData::SAT_INFO_T *GetSentenceSatellites(int &nCount) const { nCount = m_nSentenceSatCount; return m_SentenceSats; }
 
 };
 
@@ -31,11 +31,10 @@
 
 
 #include "NMEASentenceRMC.h"
-#include <stdlib.h>
+#include "NMEASentenceFields.h"
 
 CNMEASentenceRMC::CNMEASentenceRMC() {
-	// TODO Auto-generated constructor stub
-
+	ResetData();
 }
 
 CNMEASentenceRMC::~CNMEASentenceRMC() {
@@ -45,18 +44,20 @@ CNMEASentenceRMC::~CNMEASentenceRMC() {
 CNMEAParserData::ERROR_E CNMEASentenceRMC::ProcessSentence(char *pCmd, char *pData) {
 
     UNUSED_PARAM(pCmd);
-    char szField[c_nMaxField];
-
-	// Time
-	if (GetField(pData, szField, 0, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.m_nHour = (szField[0] - '0') * 10 + (szField[1] - '0');
-		m_SentenceData.m_nMinute = (szField[2] - '0') * 10 + (szField[3] - '0');
-		m_SentenceData.m_nSecond = (szField[4] - '0') * 10 + (szField[5] - '0');
+	CNMEASentenceFields Fields(pData);
+
+	// Time, hhmmss[.sss]; shorter fields would read past the field
+	if (Fields.GetLength(0) >= 6) {
+		const char *pField = Fields.GetField(0);
+		m_SentenceData.m_nHour = (pField[0] - '0') * 10 + (pField[1] - '0');
+		m_SentenceData.m_nMinute = (pField[2] - '0') * 10 + (pField[3] - '0');
+		m_SentenceData.m_nSecond = (pField[4] - '0') * 10 + (pField[5] - '0');
+		CNMEAFieldParser::ParseDouble(&pField[4], Fields.GetLength(0) - 4, m_SentenceData.m_dSecond);
 	}
 
 	// Status
-	if (GetField(pData, szField, 1, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.m_nStatus = (CNMEAParserData::RMC_STATUS_E)((char)szField[0]);
+	if (Fields.IsValid(1)) {
+		m_SentenceData.m_nStatus = (CNMEAParserData::RMC_STATUS_E)(Fields.GetChar(1));
 	}
 	else {
 		m_SentenceData.m_nStatus = (CNMEAParserData::RMC_STATUS_VOID);
@@ -65,61 +66,39 @@ CNMEAParserData::ERROR_E CNMEASentenceRMC::ProcessSentence(char *pCmd, char *pDa
 	//
 	// Latitude
 	//
-	if (GetField(pData, szField, 2, c_nMaxField) == CNMEAParserData::ERROR_OK)
-	{
-		m_SentenceData.m_dLatitude = atof((char *)szField + 2) / 60.0;
-		szField[2] = '\0';
-		m_SentenceData.m_dLatitude += atof((char *)szField);
-
-	}
-	if (GetField(pData, szField, 3, c_nMaxField) == CNMEAParserData::ERROR_OK)
+	Fields.GetCoordinate(2, 2, m_SentenceData.m_dLatitude);
+	if (Fields.GetChar(3) == 'S')
 	{
-		if (szField[0] == 'S')
-		{
-			m_SentenceData.m_dLatitude = -m_SentenceData.m_dLatitude;
-		}
+		m_SentenceData.m_dLatitude = -m_SentenceData.m_dLatitude;
 	}
 
 	//
 	// Longitude
 	//
-	if (GetField(pData, szField, 4, c_nMaxField) == CNMEAParserData::ERROR_OK)
+	Fields.GetCoordinate(4, 3, m_SentenceData.m_dLongitude);
+	if (Fields.GetChar(5) == 'W')
 	{
-		m_SentenceData.m_dLongitude = atof((char *)szField + 3) / 60.0;
-		szField[3] = '\0';
-		m_SentenceData.m_dLongitude += atof((char *)szField);
-	}
-	if (GetField(pData, szField, 5, c_nMaxField) == CNMEAParserData::ERROR_OK)
-	{
-		if (szField[0] == 'W')
-		{
-			m_SentenceData.m_dLongitude = -m_SentenceData.m_dLongitude;
-		}
+		m_SentenceData.m_dLongitude = -m_SentenceData.m_dLongitude;
 	}
 
-	// Speed over ground knots
-	if (GetField(pData, szField, 6, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.m_dSpeedKnots = atol(szField);
-	}
-	else {
-		m_SentenceData.m_dSpeedKnots = 0.0;
-	}
+	// Speed over ground knots (whole knots, as the field has always been decoded)
+	double dSpeed = 0.0;
+	Fields.GetDouble(6, dSpeed);
+	m_SentenceData.m_dSpeedKnots = (double)(long)dSpeed;
 
 	// Track Angle
-	if (GetField(pData, szField, 7, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.m_dTrackAngle = atof(szField);
-	}
-	else {
+	if (Fields.GetDouble(7, m_SentenceData.m_dTrackAngle) != CNMEAParserData::ERROR_OK) {
 		m_SentenceData.m_dTrackAngle = 0.0;
 	}
 
 
-	// Date
-	if (GetField(pData, szField, 8, c_nMaxField) == CNMEAParserData::ERROR_OK) {
+	// Date, ddmmyy
+	if (Fields.GetLength(8) >= 6) {
 		// 23 03 94       Date - 23rd of March 1994
-		m_SentenceData.m_nDay = (szField[0] - '0') * 10 + (szField[1] - '0');
-		m_SentenceData.m_nMonth = (szField[2] - '0') * 10 + (szField[3] - '0');
-		m_SentenceData.m_nYear = (szField[4] - '0') * 10 + (szField[4] - '0');
+		const char *pField = Fields.GetField(8);
+		m_SentenceData.m_nDay = (pField[0] - '0') * 10 + (pField[1] - '0');
+		m_SentenceData.m_nMonth = (pField[2] - '0') * 10 + (pField[3] - '0');
+		m_SentenceData.m_nYear = (pField[4] - '0') * 10 + (pField[5] - '0');
 		m_SentenceData.m_nYear += 2000;
 	}
 	else {
@@ -130,14 +109,10 @@ CNMEAParserData::ERROR_E CNMEASentenceRMC::ProcessSentence(char *pCmd, char *pDa
 
 
 	// Magnetic Variation
-	if (GetField(pData, szField, 9, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-
-		m_SentenceData.m_dMagneticVariation = atof(szField);
+	if (Fields.GetDouble(9, m_SentenceData.m_dMagneticVariation) == CNMEAParserData::ERROR_OK) {
 
-		if (GetField(pData, szField, 10, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-			if(szField[0] == 'W') {
-				m_SentenceData.m_dMagneticVariation *= -1.0;
-			}
+		if (Fields.GetChar(10) == 'W') {
+			m_SentenceData.m_dMagneticVariation *= -1.0;
 		}
 	}
 	else {
@@ -146,10 +121,18 @@ CNMEAParserData::ERROR_E CNMEASentenceRMC::ProcessSentence(char *pCmd, char *pDa
 
 
 	m_uRxCount++;
+	m_Snapshot.Publish(m_SentenceData);
 
 	return CNMEAParserData::ERROR_OK;
 }
 
+void CNMEASentenceRMC::SetSentenceData(const CNMEAParserData::RMC_DATA_T & data)
+{
+	m_SentenceData = data;
+	m_uRxCount++;
+	m_Snapshot.Publish(m_SentenceData);
+}
+
 void CNMEASentenceRMC::ResetData(void) {
 	m_uRxCount = 0;
 	m_SentenceData.m_dAltitudeMSL = 0.0;
@@ -166,4 +149,6 @@ void CNMEASentenceRMC::ResetData(void) {
 	m_SentenceData.m_nSecond = 0;
 	m_SentenceData.m_nStatus = CNMEAParserData::RMC_STATUS_VOID;
 	m_SentenceData.m_nYear = 0;
+
+	m_Snapshot.Publish(m_SentenceData);
 }
@@ -35,11 +35,13 @@
 #define NMEAPARSERLIB_NMEASENTENCERMC_H_
 
 #include "NMEASentenceBase.h"
+#include "NMEASnapshot.h"
 #include "NMEAParserData.h"
 
 class CNMEASentenceRMC : public CNMEASentenceBase {
 private:
 	CNMEAParserData::RMC_DATA_T		m_SentenceData;								///< Sentence specific data
+	CNMEASnapshot<CNMEAParserData::RMC_DATA_T>	m_Snapshot;		///< Last complete data, readable from other threads
 
 public:
 	CNMEASentenceRMC();
@@ -73,6 +75,19 @@ public:
 	/// \brief Returns the NMEA sentence data structure
 	///
 	CNMEAParserData::RMC_DATA_T GetSentenceData(void) { return m_SentenceData; }
+	const CNMEAParserData::RMC_DATA_T &GetSentenceData(void) const { return m_SentenceData; }
+
+	///
+	/// \brief Stores data decoded from a non NMEA source (UBX) as if the sentence was received
+	///
+	/// \param data New sentence data
+	///
+	void SetSentenceData(const CNMEAParserData::RMC_DATA_T &data);
+
+	///
+	/// \brief Returns the published copy of the sentence data. Safe to read from any thread.
+	///
+	const CNMEASnapshot<CNMEAParserData::RMC_DATA_T> &GetSnapshot(void) const { return m_Snapshot; }
 };
 
 #endif /* NMEAPARSERLIB_NMEASENTENCERMC_H_ */
@@ -0,0 +1,48 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include "NMEASchemaSentence.h"
+
+///
+/// \brief --VTG Course over ground and ground speed field schema
+///
+struct VTG_SCHEMA_T : CNMEAFieldSchema::Fields<
+	//	$--VTG,x.x,T,x.x,M,x.x,N,x.x,K,a*hh
+	//	       0   1 2   3 4   5 6   7 8
+	CNMEAFieldSchema::Double<CNMEAParserData::VTG_DATA_T, 0, &CNMEAParserData::VTG_DATA_T::m_dTrackTrue>,
+	CNMEAFieldSchema::Double<CNMEAParserData::VTG_DATA_T, 2, &CNMEAParserData::VTG_DATA_T::m_dTrackMagnetic>,
+	CNMEAFieldSchema::Double<CNMEAParserData::VTG_DATA_T, 4, &CNMEAParserData::VTG_DATA_T::m_dSpeedKnots>,
+	CNMEAFieldSchema::Scaled<CNMEAParserData::VTG_DATA_T, 4, &CNMEAParserData::VTG_DATA_T::m_dSpeedMetersPerSecond, 1852, 3600>,
+	CNMEAFieldSchema::Double<CNMEAParserData::VTG_DATA_T, 6, &CNMEAParserData::VTG_DATA_T::m_dSpeedKmh>,
+	CNMEAFieldSchema::Char<CNMEAParserData::VTG_DATA_T, 8, CNMEAParserData::FAA_MODE_E, &CNMEAParserData::VTG_DATA_T::m_nMode> >
+{
+	typedef CNMEAParserData::VTG_DATA_T DATA_T;
+};
+
+///
+/// \class CNMEASentenceVTG
+/// \brief --VTG Course over ground and ground speed decoder
+///
+typedef CNMEASchemaSentence<VTG_SCHEMA_T> CNMEASentenceVTG;
@@ -0,0 +1,48 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include "NMEASchemaSentence.h"
+
+///
+/// \brief --ZDA Time and date field schema
+///
+struct ZDA_SCHEMA_T : CNMEAFieldSchema::Fields<
+	//	$--ZDA,hhmmss.ss,xx,xx,xxxx,xx,xx*hh
+	//	       0         1  2  3    4  5
+	CNMEAFieldSchema::Time<CNMEAParserData::ZDA_DATA_T, 0>,
+	CNMEAFieldSchema::Int<CNMEAParserData::ZDA_DATA_T, 1, &CNMEAParserData::ZDA_DATA_T::m_nDay>,
+	CNMEAFieldSchema::Int<CNMEAParserData::ZDA_DATA_T, 2, &CNMEAParserData::ZDA_DATA_T::m_nMonth>,
+	CNMEAFieldSchema::Int<CNMEAParserData::ZDA_DATA_T, 3, &CNMEAParserData::ZDA_DATA_T::m_nYear>,
+	CNMEAFieldSchema::Int<CNMEAParserData::ZDA_DATA_T, 4, &CNMEAParserData::ZDA_DATA_T::m_nLocalZoneHours>,
+	CNMEAFieldSchema::Int<CNMEAParserData::ZDA_DATA_T, 5, &CNMEAParserData::ZDA_DATA_T::m_nLocalZoneMinutes> >
+{
+	typedef CNMEAParserData::ZDA_DATA_T DATA_T;
+};
+
+///
+/// \class CNMEASentenceZDA
+/// \brief --ZDA Time and date decoder
+///
+typedef CNMEASchemaSentence<ZDA_SCHEMA_T> CNMEASentenceZDA;
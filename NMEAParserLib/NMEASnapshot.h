@@ -0,0 +1,112 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+
+///
+/// \class CNMEASnapshot
+/// \brief Sequence locked copy of a sentence data structure.
+///
+/// The parser thread publishes a new copy of the sentence data with Publish(); it never
+/// waits for readers. Readers on other threads copy a consistent version with Read() or
+/// ReadIfNewer(). A reader that raced with Publish() notices the sequence change and
+/// copies again, so it never sees a half written structure. ReadIfNewer() does not copy
+/// anything if the caller already has the latest version.
+///
+/// T must be trivially copyable (the CNMEAParserData::*_DATA_T structures are).
+///
+template <typename T>
+class CNMEASnapshot
+{
+private:
+	std::atomic<uint32_t>		m_uSequence;									///< Twice the version, odd while a publish is in progress
+	T							m_Data;											///< Last published data
+
+public:
+	CNMEASnapshot() : m_uSequence(0) { memset(&m_Data, 0, sizeof(m_Data)); }
+
+	///
+	/// \brief Publishes a new version. Only one thread (the parser) may publish.
+	///
+	void Publish(const T &data)
+	{
+		uint32_t uSequence = m_uSequence.load(std::memory_order_relaxed);
+		m_uSequence.store(uSequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		memcpy(&m_Data, &data, sizeof(T));
+		m_uSequence.store(uSequence + 2, std::memory_order_release);
+	}
+
+	///
+	/// \brief Returns the latest published version, 0 if nothing was published yet
+	///
+	uint32_t GetVersion(void) const { return m_uSequence.load(std::memory_order_acquire) >> 1; }
+
+	///
+	/// \brief Copies the latest published version
+	///
+	/// \param data Returned data
+	/// \param uVersion Returned version of data
+	///
+	void Read(T &data, uint32_t &uVersion) const
+	{
+		for (;;)
+		{
+			uint32_t uBefore = m_uSequence.load(std::memory_order_acquire);
+			if ((uBefore & 1) == 0)
+			{
+				memcpy(&data, &m_Data, sizeof(T));
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (m_uSequence.load(std::memory_order_relaxed) == uBefore)
+				{
+					uVersion = uBefore >> 1;
+					return;
+				}
+			}
+			std::this_thread::yield();
+		}
+	}
+
+	///
+	/// \brief Copies the latest published version only if it is newer than uVersion
+	///
+	/// \param data Returned data, untouched if nothing changed
+	/// \param uVersion Version the caller has, updated when new data is copied
+	/// \return true if new data was copied
+	///
+	bool ReadIfNewer(T &data, uint32_t &uVersion) const
+	{
+		if (GetVersion() == uVersion)
+		{
+			return false;
+		}
+		Read(data, uVersion);
+		return true;
+	}
+};
@@ -0,0 +1,180 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include "NMEATrace.h"
+#include <string.h>
+#include <atomic>
+#include "NMEAClock.h"
+
+///
+/// \brief Ring buffer slot. uSequence is odd while the record is written and 2 * (index + 1)
+/// once record index is complete, so readers can detect torn and overwritten records.
+///
+typedef struct _TRACE_SLOT_T {
+	std::atomic<uint64_t>			uSequence;									///< Slot sequence
+	CNMEATrace::TRACE_RECORD_T		record;										///< Record data
+} TRACE_SLOT_T;
+
+static TRACE_SLOT_T					s_Slots[CNMEATrace::c_uMaxRecords];			///< Ring buffer
+static std::atomic<uint64_t>		s_uHead(0);									///< Index of the next record to write
+static std::atomic<uint64_t>		s_uTail(0);									///< Index of the next record to drain
+
+///
+/// \brief Reads record uIndex if it is still in the ring
+/// \return 1 if the record was copied, 0 if it is not written yet, -1 if it was overwritten
+///
+static int ReadSlot(uint64_t uIndex, CNMEATrace::TRACE_RECORD_T &record)
+{
+	const TRACE_SLOT_T &slot = s_Slots[uIndex & (CNMEATrace::c_uMaxRecords - 1)];
+	uint64_t uExpected = 2 * (uIndex + 1);
+	uint64_t uBefore = slot.uSequence.load(std::memory_order_acquire);
+	if (uBefore != uExpected)
+	{
+		return uBefore > uExpected ? -1 : 0;
+	}
+	memcpy(&record, &slot.record, sizeof(record));
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return slot.uSequence.load(std::memory_order_relaxed) == uBefore ? 1 : -1;
+}
+
+void CNMEATrace::Record(TRACE_EVENT_E nEvent, CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID, CNMEAParserData::ERROR_E nError)
+{
+	uint64_t uIndex = s_uHead.fetch_add(1, std::memory_order_relaxed);
+	TRACE_SLOT_T &slot = s_Slots[uIndex & (c_uMaxRecords - 1)];
+
+	slot.uSequence.store(2 * uIndex + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	slot.record.nTimeNs = CNMEAClock::GetTimeNs();
+	slot.record.uSentenceID = (uint32_t)nSentenceID;
+	slot.record.uTalkerID = (uint16_t)nTalkerID;
+	slot.record.uEvent = (uint8_t)nEvent;
+	slot.record.uError = (uint8_t)nError;
+	slot.uSequence.store(2 * (uIndex + 1), std::memory_order_release);
+}
+
+void CNMEATrace::Record(TRACE_EVENT_E nEvent, const char * pCmd, CNMEAParserData::ERROR_E nError)
+{
+	//
+	// Pack the address the same way CNMEAParser does, missing characters stay 0
+	//
+	uint16_t uTalkerID = 0;
+	uint32_t uSentenceID = 0;
+	if (pCmd != NULL)
+	{
+		for (int i = 0; i < 5 && pCmd[i] != '\0'; i++)
+		{
+			if (i < 2)
+			{
+				uTalkerID |= (uint16_t)((uint8_t)pCmd[i]) << (8 * (1 - i));
+			}
+			else
+			{
+				uSentenceID |= (uint32_t)((uint8_t)pCmd[i]) << (8 * (4 - i));
+			}
+		}
+	}
+	Record(nEvent, (CNMEAParserData::TALKER_ID_E)uTalkerID, (CNMEAParserData::SENTENCE_ID_E)uSentenceID, nError);
+}
+
+uint32_t CNMEATrace::Drain(TRACE_RECORD_T * pRecords, uint32_t uMaxRecords, uint64_t * puLost)
+{
+	uint64_t uHead = s_uHead.load(std::memory_order_acquire);
+	uint64_t uTail = s_uTail.load(std::memory_order_relaxed);
+	uint64_t uLost = 0;
+
+	//
+	// Records older than one ring are gone
+	//
+	if (uHead - uTail > c_uMaxRecords)
+	{
+		uLost = uHead - uTail - c_uMaxRecords;
+		uTail = uHead - c_uMaxRecords;
+	}
+
+	uint32_t uCount = 0;
+	while (uTail < uHead && uCount < uMaxRecords)
+	{
+		int nResult = ReadSlot(uTail, pRecords[uCount]);
+		if (nResult == 0)
+		{
+			//
+			// Claimed but still being written, pick it up next time
+			//
+			break;
+		}
+		if (nResult > 0)
+		{
+			uCount++;
+		}
+		else
+		{
+			uLost++;
+		}
+		uTail++;
+	}
+
+	s_uTail.store(uTail, std::memory_order_relaxed);
+	if (puLost != NULL)
+	{
+		*puLost = uLost;
+	}
+	return uCount;
+}
+
+void CNMEATrace::Dump(FILE * pFile)
+{
+	uint64_t uHead = s_uHead.load(std::memory_order_acquire);
+	uint64_t uIndex = uHead > c_uMaxRecords ? uHead - c_uMaxRecords : 0;
+
+	for (; uIndex < uHead; uIndex++)
+	{
+		TRACE_RECORD_T record;
+		if (ReadSlot(uIndex, record) <= 0)
+		{
+			continue;
+		}
+		const char *pszEvent = record.uEvent == TRACE_ERROR ? "ERROR" : (record.uEvent == TRACE_SENTENCE ? "SENTENCE" : "UNSUPPORTED");
+		char szAddress[6];
+		szAddress[0] = (char)(record.uTalkerID >> 8);
+		szAddress[1] = (char)(record.uTalkerID);
+		szAddress[2] = (char)(record.uSentenceID >> 16);
+		szAddress[3] = (char)(record.uSentenceID >> 8);
+		szAddress[4] = (char)(record.uSentenceID);
+		szAddress[5] = '\0';
+		for (int i = 0; i < 5; i++)
+		{
+			if (szAddress[i] < ' ' || szAddress[i] > '~')
+			{
+				szAddress[i] = '?';
+			}
+		}
+		fprintf(pFile, "%llu %lld.%09lld %-11s %s error %d\n", (unsigned long long)uIndex,
+			(long long)(record.nTimeNs / 1000000000), (long long)(record.nTimeNs % 1000000000), pszEvent, szAddress, (int)record.uError);
+	}
+}
+
+uint64_t CNMEATrace::GetRecordCount(void)
+{
+	return s_uHead.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,125 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include <stdio.h>
+#include "NMEAParserData.h"
+
+//
+// Trace levels. Set NMEA_TRACE_LEVEL (ie: DEFINES += NMEA_TRACE_LEVEL=2) to choose what
+// the library records. Trace points above the level compile to nothing.
+//
+#define NMEA_TRACE_LEVEL_NONE		0											///< No tracing
+#define NMEA_TRACE_LEVEL_ERROR		1											///< Framing and checksum errors
+#define NMEA_TRACE_LEVEL_SENTENCE	2											///< Every sentence
+
+#ifndef NMEA_TRACE_LEVEL
+#define NMEA_TRACE_LEVEL			NMEA_TRACE_LEVEL_ERROR
+#endif
+
+///
+/// \brief Structured trace of the NMEA library.
+///
+/// Trace points write fixed size binary records into a lock free ring buffer; nothing is
+/// formatted or written to a console on the parsing path. When the ring is full the
+/// oldest records are overwritten. The records are read on demand with Drain() (consumes)
+/// or Dump() (prints the records still in the ring).
+///
+/// Writers never block and may run on any number of threads. Drain() must only be called
+/// from one thread at a time.
+///
+namespace CNMEATrace {
+
+	static const uint32_t			c_uMaxRecords = 4096;						///< Ring buffer size (records), power of two
+
+	///
+	/// Trace events
+	///
+	enum TRACE_EVENT_E {
+		TRACE_ERROR = 1,														///< Framing or checksum error, see TRACE_RECORD_T::uError
+		TRACE_SENTENCE,															///< Sentence decoded
+		TRACE_UNSUPPORTED,														///< Sentence without a decoder
+	};
+
+	///
+	/// \brief A single trace record (16 bytes)
+	///
+	typedef struct _TRACE_RECORD_T {
+		int64_t						nTimeNs;									///< Monotonic (steady) clock in nanoseconds
+		uint32_t					uSentenceID;								///< CNMEAParserData::SENTENCE_ID_E, 0 if unknown
+		uint16_t					uTalkerID;									///< CNMEAParserData::TALKER_ID_E, 0 if unknown
+		uint8_t						uEvent;										///< TRACE_EVENT_E
+		uint8_t						uError;										///< CNMEAParserData::ERROR_E
+	} TRACE_RECORD_T;
+
+	///
+	/// \brief Writes a trace record
+	///
+	/// \param nEvent Event
+	/// \param nTalkerID Talker ID
+	/// \param nSentenceID Sentence ID
+	/// \param nError Error code, ERROR_OK if none
+	///
+	void Record(TRACE_EVENT_E nEvent, CNMEAParserData::TALKER_ID_E nTalkerID, CNMEAParserData::SENTENCE_ID_E nSentenceID, CNMEAParserData::ERROR_E nError);
+
+	///
+	/// \brief Writes a trace record for a (possibly incomplete) NMEA address, ie: "GPGGA"
+	///
+	void Record(TRACE_EVENT_E nEvent, const char *pCmd, CNMEAParserData::ERROR_E nError);
+
+	///
+	/// \brief Moves the records written since the last call into pRecords, oldest first
+	///
+	/// \param pRecords Array to receive the records
+	/// \param uMaxRecords Size of pRecords
+	/// \param puLost Optional, returns the number of records that were overwritten before they could be drained
+	/// \return Number of records copied
+	///
+	uint32_t Drain(TRACE_RECORD_T *pRecords, uint32_t uMaxRecords, uint64_t *puLost = NULL);
+
+	///
+	/// \brief Prints the records in the ring, oldest first, without consuming them
+	/// \param pFile Output, ie: stdout
+	///
+	void Dump(FILE *pFile);
+
+	///
+	/// \brief Returns the number of records written since the program started
+	///
+	uint64_t GetRecordCount(void);
+};
+
+#if NMEA_TRACE_LEVEL >= NMEA_TRACE_LEVEL_ERROR
+#define NMEA_TRACE_ERROR(pCmd, nError)							CNMEATrace::Record(CNMEATrace::TRACE_ERROR, (pCmd), (nError))
+#else
+#define NMEA_TRACE_ERROR(pCmd, nError)							((void)0)
+#endif
+
+#if NMEA_TRACE_LEVEL >= NMEA_TRACE_LEVEL_SENTENCE
+#define NMEA_TRACE_SENTENCE(nEvent, nTalkerID, nSentenceID, nError)	CNMEATrace::Record((nEvent), (nTalkerID), (nSentenceID), (nError))
+#else
+#define NMEA_TRACE_SENTENCE(nEvent, nTalkerID, nSentenceID, nError)	((void)0)
+#endif
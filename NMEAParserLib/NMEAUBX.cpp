@@ -0,0 +1,255 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include <string.h>
+#include "NMEAUBX.h"
+
+namespace {
+
+	//
+	// Little endian field readers, the payload is not aligned
+	//
+	inline uint16_t ReadU16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+	inline int16_t ReadI16(const uint8_t *p) { return (int16_t)ReadU16(p); }
+	inline uint32_t ReadU32(const uint8_t *p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24); }
+	inline int32_t ReadI32(const uint8_t *p) { return (int32_t)ReadU32(p); }
+
+	static const double			c_dKnotsPerMMPerSecond = 3.6 / 1852.0;			///< mm/s to knots
+	static const double			c_dKmhPerMMPerSecond = 0.0036;					///< mm/s to km/h
+
+	//
+	// NAV-PVT fixType, flags and valid bits
+	//
+	static const uint8_t		c_uFixNone = 0;
+	static const uint8_t		c_uFixDeadReckoning = 1;
+	static const uint8_t		c_uFix2D = 2;
+	static const uint8_t		c_uFixGNSSDeadReckoning = 4;
+	static const uint8_t		c_uFlagGNSSFixOK = 0x01;
+	static const uint8_t		c_uFlagDiffSoln = 0x02;
+	static const uint8_t		c_uValidDate = 0x01;
+	static const uint8_t		c_uValidMag = 0x08;
+	static const uint32_t		c_uSatFlagUsed = 0x08;							///< NAV-SAT flags svUsed
+}
+
+CNMEAParserData::ERROR_E CNMEAUBX::DecodeNavPVT(const uint8_t * pPayload, uint16_t uLength, CNMEAParserData::GGA_DATA_T & ggaData, CNMEAParserData::RMC_DATA_T & rmcData, CNMEAParserData::VTG_DATA_T & vtgData, CNMEAParserData::ACTIVE_SAT_MODE_E & nFixMode)
+{
+	if (uLength < c_uNavPVTLength)
+	{
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	uint8_t uValid = pPayload[11];
+	uint8_t uFixType = pPayload[20];
+	uint8_t uFlags = pPayload[21];
+	uint8_t uCarrier = (uint8_t)((uFlags >> 6) & 0x03);
+	int nHour = pPayload[8];
+	int nMinute = pPayload[9];
+	int nSecond = pPayload[10];
+	double dSecond = nSecond + ReadI32(&pPayload[16]) * 1e-9;
+	double dLongitude = ReadI32(&pPayload[24]) * 1e-7;
+	double dLatitude = ReadI32(&pPayload[28]) * 1e-7;
+	double dHeight = ReadI32(&pPayload[32]) * 1e-3;
+	double dAltitudeMSL = ReadI32(&pPayload[36]) * 1e-3;
+	int32_t nVelDown = ReadI32(&pPayload[56]);
+	int32_t nGroundSpeed = ReadI32(&pPayload[60]);
+	double dHeading = ReadI32(&pPayload[64]) * 1e-5;
+	double dMagneticVariation = ((uValid & c_uValidMag) != 0) ? ReadI16(&pPayload[88]) * 1e-2 : 0.0;
+
+	//
+	// Map the fix type and flags onto the NMEA quality, mode and status
+	//
+	CNMEAParserData::GPS_QUALITY_E nQuality;
+	CNMEAParserData::FAA_MODE_E nMode;
+	if ((uFlags & c_uFlagGNSSFixOK) == 0 || uFixType == c_uFixNone || uFixType > c_uFixGNSSDeadReckoning)
+	{
+		nQuality = CNMEAParserData::GQ_FIX_NOT_AVAILABLE;
+		nMode = CNMEAParserData::FAA_MODE_NOT_VALID;
+	}
+	else if (uFixType == c_uFixDeadReckoning)
+	{
+		nQuality = CNMEAParserData::GQ_ESTIMATED_DEAD_RECONING;
+		nMode = CNMEAParserData::FAA_MODE_ESTIMATED;
+	}
+	else if (uCarrier == 2)
+	{
+		nQuality = CNMEAParserData::GQ_REAL_TIME_KINEMATIC;
+		nMode = CNMEAParserData::FAA_MODE_RTK;
+	}
+	else if (uCarrier == 1)
+	{
+		nQuality = CNMEAParserData::GQ_FLOAT_RTK;
+		nMode = CNMEAParserData::FAA_MODE_FLOAT_RTK;
+	}
+	else if ((uFlags & c_uFlagDiffSoln) != 0)
+	{
+		nQuality = CNMEAParserData::GQ_GPS_DIFFERENTIAL_SPS_MODE;
+		nMode = CNMEAParserData::FAA_MODE_DIFFERENTIAL;
+	}
+	else
+	{
+		nQuality = CNMEAParserData::GQ_GPS_SPS_MODE;
+		nMode = CNMEAParserData::FAA_MODE_AUTONOMOUS;
+	}
+
+	if (nQuality == CNMEAParserData::GQ_FIX_NOT_AVAILABLE)
+	{
+		nFixMode = CNMEAParserData::ASM_FIX_NOT_AVAILABLE;
+	}
+	else
+	{
+		nFixMode = (uFixType == c_uFix2D) ? CNMEAParserData::ASM_2D : CNMEAParserData::ASM_3D;
+	}
+
+	//
+	// GGA
+	//
+	ggaData.m_nHour = nHour;
+	ggaData.m_nMinute = nMinute;
+	ggaData.m_nSecond = nSecond;
+	ggaData.m_dSecond = dSecond;
+	ggaData.m_dLatitude = dLatitude;
+	ggaData.m_dLongitude = dLongitude;
+	ggaData.m_dAltitudeMSL = dAltitudeMSL;
+	ggaData.m_nGPSQuality = nQuality;
+	ggaData.m_nSatsInView = pPayload[23];
+	ggaData.m_dGeoidalSep = dHeight - dAltitudeMSL;
+	ggaData.m_dDifferentialAge = 0.0;
+	ggaData.m_nDifferentialID = 0;
+	ggaData.m_dVertSpeed = -nVelDown * 0.06;				// mm/s down to meters per minute up, the unit of the NMEA derived value
+
+	//
+	// RMC
+	//
+	memset(&rmcData, 0, sizeof(rmcData));
+	rmcData.m_nHour = nHour;
+	rmcData.m_nMinute = nMinute;
+	rmcData.m_nSecond = nSecond;
+	rmcData.m_dSecond = dSecond;
+	rmcData.m_dLatitude = dLatitude;
+	rmcData.m_dLongitude = dLongitude;
+	rmcData.m_dAltitudeMSL = dAltitudeMSL;
+	rmcData.m_nStatus = (nQuality != CNMEAParserData::GQ_FIX_NOT_AVAILABLE) ? CNMEAParserData::RMC_STATUS_ACTIVE : CNMEAParserData::RMC_STATUS_VOID;
+	rmcData.m_dSpeedKnots = nGroundSpeed * c_dKnotsPerMMPerSecond;
+	rmcData.m_dTrackAngle = dHeading;
+	if ((uValid & c_uValidDate) != 0)
+	{
+		rmcData.m_nYear = ReadU16(&pPayload[4]);
+		rmcData.m_nMonth = pPayload[6];
+		rmcData.m_nDay = pPayload[7];
+	}
+	rmcData.m_dMagneticVariation = dMagneticVariation;
+
+	//
+	// VTG
+	//
+	vtgData.m_dTrackTrue = dHeading;
+	vtgData.m_dTrackMagnetic = ((uValid & c_uValidMag) != 0) ? dHeading - dMagneticVariation : 0.0;
+	vtgData.m_dSpeedKnots = rmcData.m_dSpeedKnots;
+	vtgData.m_dSpeedKmh = nGroundSpeed * c_dKmhPerMMPerSecond;
+	vtgData.m_dSpeedMetersPerSecond = nGroundSpeed * 1e-3;
+	vtgData.m_nMode = nMode;
+
+	return CNMEAParserData::ERROR_OK;
+}
+
+CNMEAParserData::ERROR_E CNMEAUBX::DecodeNavDOP(const uint8_t * pPayload, uint16_t uLength, CNMEAParserData::GSA_DATA_T & gsaData)
+{
+	if (uLength < c_uNavDOPLength)
+	{
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	gsaData.dPDOP = ReadU16(&pPayload[6]) * 0.01;
+	gsaData.dVDOP = ReadU16(&pPayload[10]) * 0.01;
+	gsaData.dHDOP = ReadU16(&pPayload[12]) * 0.01;
+	return CNMEAParserData::ERROR_OK;
+}
+
+CNMEAParserData::ERROR_E CNMEAUBX::DecodeNavSAT(const uint8_t * pPayload, uint16_t uLength, CNMEASatelliteDatabase & satellites, int64_t nTimeNs, CNMEAParserData::GSA_DATA_T & gsaData)
+{
+	if (uLength < c_uNavSATHeaderLength)
+	{
+		return CNMEAParserData::ERROR_FAIL;
+	}
+	int nSatellites = pPayload[5];
+	if (uLength != c_uNavSATHeaderLength + nSatellites * c_uNavSATBlockLength)
+	{
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	int nUsed = 0;
+	satellites.BeginSkyView(CNMEAParserData::TID_UBX);
+	for (int i = 0; i < nSatellites; i++)
+	{
+		const uint8_t *pBlock = &pPayload[c_uNavSATHeaderLength + i * c_uNavSATBlockLength];
+		CNMEAParserData::CONSTELLATION_E nConstellation;
+		int nPRN;
+		if (GetNMEAPRN(pBlock[0], pBlock[1], nConstellation, nPRN) == false)
+		{
+			continue;
+		}
+
+		satellites.UpdateSatellite(nConstellation, nPRN, (int8_t)pBlock[3], ReadI16(&pBlock[4]), pBlock[2], nTimeNs);
+		if ((ReadU32(&pBlock[8]) & c_uSatFlagUsed) != 0 && nUsed < CNMEAParserData::c_nMaxConstellation)
+		{
+			gsaData.pnPRN[nUsed++] = nPRN;
+		}
+	}
+	satellites.EndSkyView();
+
+	for (int i = nUsed; i < CNMEAParserData::c_nMaxConstellation; i++)
+	{
+		gsaData.pnPRN[i] = CNMEAParserData::c_nInvlidPRN;
+	}
+	return CNMEAParserData::ERROR_OK;
+}
+
+bool CNMEAUBX::GetNMEAPRN(uint8_t uGnssID, uint8_t uSvID, CNMEAParserData::CONSTELLATION_E & nConstellation, int & nPRN)
+{
+	nPRN = uSvID;
+	switch (uGnssID)
+	{
+	case 0:		nConstellation = CNMEAParserData::CONST_GPS; break;
+	case 1:		nConstellation = CNMEAParserData::CONST_SBAS; break;
+	case 2:		nConstellation = CNMEAParserData::CONST_GALILEO; break;
+	case 3:		nConstellation = CNMEAParserData::CONST_BEIDOU; break;
+	case 5:
+		nConstellation = CNMEAParserData::CONST_QZSS;
+		if (uSvID <= 10)
+		{
+			nPRN += 192;
+		}
+		break;
+	case 6:
+		nConstellation = CNMEAParserData::CONST_GLONASS;
+		if (uSvID <= 32)
+		{
+			nPRN += 64;
+		}
+		break;
+	default:
+		return false;
+	}
+	return uSvID != 0 && uSvID != 255;
+}
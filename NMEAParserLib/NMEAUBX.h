@@ -0,0 +1,101 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include "NMEAParserData.h"
+#include "NMEASatelliteDatabase.h"
+
+///
+/// \brief Decoders for the u-blox UBX navigation messages that overlap the NMEA sentences.
+///
+/// The messages are decoded into the same structures the NMEA sentences fill, so UBX and
+/// NMEA receivers look the same to the rest of the application:
+///   NAV-PVT  GGA, RMC, VTG and the GSA fix mode
+///   NAV-DOP  GSA DOPs
+///   NAV-SAT  satellite database and GSA active satellites
+///
+/// Payloads are read byte by byte (little endian), they do not need to be aligned.
+///
+namespace CNMEAUBX {
+
+	static const uint8_t		c_uClassNAV = 0x01;								///< NAV message class
+	static const uint8_t		c_uIdNavDOP = 0x04;								///< NAV-DOP Dilution of precision
+	static const uint8_t		c_uIdNavPVT = 0x07;								///< NAV-PVT Navigation position velocity time solution
+	static const uint8_t		c_uIdNavSAT = 0x35;								///< NAV-SAT Satellite information
+	static const uint16_t		c_uNavDOPLength = 18;							///< NAV-DOP payload length
+	static const uint16_t		c_uNavPVTLength = 92;							///< NAV-PVT payload length
+	static const uint16_t		c_uNavSATHeaderLength = 8;						///< NAV-SAT payload length without the satellite blocks
+	static const uint16_t		c_uNavSATBlockLength = 12;						///< NAV-SAT length of one satellite block
+
+	///
+	/// \brief Decodes NAV-PVT
+	///
+	/// \param pPayload Payload
+	/// \param uLength Payload length
+	/// \param ggaData Returned position, quality and altitude. m_dHDOP is not part of NAV-PVT and is left alone.
+	/// \param rmcData Returned status, speed, track and date
+	/// \param vtgData Returned speed and track
+	/// \param nFixMode Returned 2D/3D fix mode for GSA
+	/// \return ERROR_OK if successful, ERROR_FAIL if the payload is too short
+	///
+	CNMEAParserData::ERROR_E DecodeNavPVT(const uint8_t *pPayload, uint16_t uLength, CNMEAParserData::GGA_DATA_T &ggaData, CNMEAParserData::RMC_DATA_T &rmcData, CNMEAParserData::VTG_DATA_T &vtgData, CNMEAParserData::ACTIVE_SAT_MODE_E &nFixMode);
+
+	///
+	/// \brief Decodes NAV-DOP into the DOP fields of gsaData
+	///
+	/// \param pPayload Payload
+	/// \param uLength Payload length
+	/// \param gsaData GSA data to update, only dPDOP, dHDOP and dVDOP are written
+	/// \return ERROR_OK if successful, ERROR_FAIL if the payload is too short
+	///
+	CNMEAParserData::ERROR_E DecodeNavDOP(const uint8_t *pPayload, uint16_t uLength, CNMEAParserData::GSA_DATA_T &gsaData);
+
+	///
+	/// \brief Decodes NAV-SAT into the satellite database, as one sky view
+	///
+	/// \param pPayload Payload
+	/// \param uLength Payload length
+	/// \param satellites Database to update
+	/// \param nTimeNs Receive time, monotonic (steady) clock in nanoseconds
+	/// \param gsaData GSA data to update, pnPRN is replaced by the satellites used in the solution
+	/// \return ERROR_OK if successful, ERROR_FAIL if the length does not match the satellite count
+	///
+	CNMEAParserData::ERROR_E DecodeNavSAT(const uint8_t *pPayload, uint16_t uLength, CNMEASatelliteDatabase &satellites, int64_t nTimeNs, CNMEAParserData::GSA_DATA_T &gsaData);
+
+	///
+	/// \brief Converts a UBX gnssId and svId to the constellation and NMEA PRN
+	///
+	/// GLONASS is moved to 65-96 and QZSS to 193-202 as in NMEA GSV; GPS, SBAS, Galileo and
+	/// BeiDou keep their numbers.
+	///
+	/// \param uGnssID UBX GNSS identifier
+	/// \param uSvID UBX satellite identifier
+	/// \param nConstellation Returned constellation
+	/// \param nPRN Returned PRN
+	/// \return false for GNSS that the database does not track (IMES)
+	///
+	bool GetNMEAPRN(uint8_t uGnssID, uint8_t uSvID, CNMEAParserData::CONSTELLATION_E &nConstellation, int &nPRN);
+};
@@ -0,0 +1,196 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include <string.h>
+#include "NMEAUBXPacket.h"
+#include "NMEAScan.h"
+#include "NMEAClock.h"
+
+CNMEAUBXPacket::CNMEAUBXPacket() :
+	m_nState(UBX_STATE_SYNC1),
+	m_uIndex(0),
+	m_uLength(0),
+	m_nRxTimeNs(0)
+{
+}
+
+CNMEAUBXPacket::~CNMEAUBXPacket()
+{
+}
+
+CNMEAParserData::ERROR_E CNMEAUBXPacket::ProcessUBXBuffer(const char * pData, size_t nBufferSize)
+{
+	size_t i = 0;
+	while (i < nBufferSize)
+	{
+		if (m_nState == UBX_STATE_SYNC1)
+		{
+			i += CNMEAScan::FindChar(&pData[i], nBufferSize - i, (char)c_uSync1);
+			if (i >= nBufferSize)
+			{
+				break;
+			}
+		}
+		i += ConsumeUBX(&pData[i], nBufferSize - i);
+	}
+	return CNMEAParserData::ERROR_OK;
+}
+
+size_t CNMEAUBXPacket::ConsumeUBX(const char * pData, size_t nBufferSize)
+{
+	const uint8_t *pBytes = (const uint8_t *)pData;
+	size_t i = 0;
+
+	if (m_nState == UBX_STATE_SYNC1)
+	{
+		if (nBufferSize == 0)
+		{
+			return 0;
+		}
+		if (pBytes[0] != c_uSync1)
+		{
+			return 1;
+		}
+		m_nRxTimeNs = CNMEAClock::GetTimeNs();
+		m_nState = UBX_STATE_SYNC2;
+		i = 1;
+	}
+
+	if (m_nState == UBX_STATE_SYNC2)
+	{
+		if (i >= nBufferSize)
+		{
+			return i;
+		}
+		if (pBytes[i] != c_uSync2)
+		{
+			m_nState = UBX_STATE_SYNC1;		// not a frame, let the caller look at this byte
+			return i;
+		}
+		i++;
+		m_uIndex = 0;
+		m_nState = UBX_STATE_HEADER;
+
+		//
+		// Fast path, the whole frame is in this buffer: check and deliver it in place
+		//
+		size_t uLeft = nBufferSize - i;
+		if (uLeft >= c_uHeaderLen)
+		{
+			uint16_t uLength = (uint16_t)(pBytes[i + 2] | (pBytes[i + 3] << 8));
+			if (uLength <= c_uMaxPayload && uLeft >= (size_t)c_uHeaderLen + uLength + c_uChecksumLen)
+			{
+				m_nState = UBX_STATE_SYNC1;
+				OnFrame(&pBytes[i], uLength);
+				return i + c_uHeaderLen + uLength + c_uChecksumLen;
+			}
+		}
+	}
+
+	//
+	// Slow path, assemble the frame in m_pFrame
+	//
+	while (i < nBufferSize)
+	{
+		if (m_nState == UBX_STATE_HEADER)
+		{
+			m_pFrame[m_uIndex++] = pBytes[i++];
+			if (m_uIndex == c_uHeaderLen)
+			{
+				m_uLength = (uint16_t)(m_pFrame[2] | (m_pFrame[3] << 8));
+				if (m_uLength > c_uMaxPayload)
+				{
+					OnUBXError(CNMEAParserData::ERROR_RX_BUFFER_OVERFLOW, m_pFrame[0], m_pFrame[1]);
+					m_nState = UBX_STATE_SYNC1;
+					return i;
+				}
+				m_nState = UBX_STATE_PAYLOAD;
+			}
+		}
+		else
+		{
+			size_t uNeed = (size_t)c_uHeaderLen + m_uLength + c_uChecksumLen - m_uIndex;
+			size_t uTake = (nBufferSize - i < uNeed) ? nBufferSize - i : uNeed;
+			memcpy(&m_pFrame[m_uIndex], &pBytes[i], uTake);
+			m_uIndex += (uint16_t)uTake;
+			i += uTake;
+			if (uTake == uNeed)
+			{
+				m_nState = UBX_STATE_SYNC1;
+				OnFrame(m_pFrame, m_uLength);
+				return i;
+			}
+		}
+	}
+	return i;
+}
+
+void CNMEAUBXPacket::Reset(void)
+{
+	m_nState = UBX_STATE_SYNC1;
+	m_uIndex = 0;
+	m_uLength = 0;
+}
+
+void CNMEAUBXPacket::Checksum(const uint8_t * pData, size_t uLength, uint8_t & u8CkA, uint8_t & u8CkB)
+{
+	//
+	// Sum in 32 bits and truncate once at the end. Both sums are only needed modulo 256,
+	// which a 32 bit wrap preserves.
+	//
+	uint32_t uA = 0;
+	uint32_t uB = 0;
+	size_t i = 0;
+	for (; i + 4 <= uLength; i += 4)
+	{
+		uA += pData[i];
+		uB += uA;
+		uA += pData[i + 1];
+		uB += uA;
+		uA += pData[i + 2];
+		uB += uA;
+		uA += pData[i + 3];
+		uB += uA;
+	}
+	for (; i < uLength; i++)
+	{
+		uA += pData[i];
+		uB += uA;
+	}
+	u8CkA = (uint8_t)uA;
+	u8CkB = (uint8_t)uB;
+}
+
+void CNMEAUBXPacket::OnFrame(const uint8_t * pFrame, uint16_t uLength)
+{
+	uint8_t u8CkA;
+	uint8_t u8CkB;
+	Checksum(pFrame, c_uHeaderLen + uLength, u8CkA, u8CkB);
+	if (u8CkA != pFrame[c_uHeaderLen + uLength] || u8CkB != pFrame[c_uHeaderLen + uLength + 1])
+	{
+		OnUBXError(CNMEAParserData::ERROR_CHECKSUM, pFrame[0], pFrame[1]);
+		return;
+	}
+	ProcessUBXMessage(pFrame[0], pFrame[1], &pFrame[c_uHeaderLen], uLength, m_nRxTimeNs);
+}
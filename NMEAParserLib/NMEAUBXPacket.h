@@ -0,0 +1,143 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include "NMEAParserData.h"
+
+///
+/// \class CNMEAUBXPacket
+/// \brief Frames u-blox UBX binary messages and calls its virtual processor method.
+///
+/// A UBX frame is: 0xB5 0x62, class, ID, 16 bit little endian payload length, payload and
+/// the two byte 8-bit Fletcher checksum (CK_A, CK_B) over class, ID, length and payload.
+///
+/// When a whole frame is inside the buffer handed in, the checksum is verified in place and
+/// ProcessUBXMessage() gets a pointer into that buffer, nothing is copied. Only frames that
+/// are split across buffers are assembled in the internal frame buffer.
+///
+/// Use ProcessUBXBuffer() for a pure UBX stream. CNMEAParserPacket calls ConsumeUBX() to
+/// take UBX frames out of a mixed NMEA and UBX stream, see CNMEAParser::EnableUBX().
+///
+class CNMEAUBXPacket {
+
+public:
+	static const uint8_t			c_uSync1 = 0xB5;							///< First sync character
+	static const uint8_t			c_uSync2 = 0x62;							///< Second sync character
+	static const uint16_t			c_uMaxPayload = 4096;						///< Longest payload accepted. Longer frames are dropped.
+	static const uint16_t			c_uHeaderLen = 4;							///< Class, ID and length
+	static const uint16_t			c_uChecksumLen = 2;							///< CK_A and CK_B
+
+private:
+
+	enum PARSE_STATE {
+		UBX_STATE_SYNC1 = 0,													///< Search for the first sync character
+		UBX_STATE_SYNC2,														///< Get the second sync character
+		UBX_STATE_HEADER,														///< Get class, ID and length
+		UBX_STATE_PAYLOAD,														///< Get payload and checksum
+	};
+
+	PARSE_STATE						m_nState;									///< Current parse state
+	uint16_t						m_uIndex;									///< Bytes of the frame (after the sync characters) in m_pFrame
+	uint16_t						m_uLength;									///< Payload length of the frame being received
+	int64_t							m_nRxTimeNs;								///< Time the first sync character of the frame arrived
+	uint8_t							m_pFrame[c_uHeaderLen + c_uMaxPayload + c_uChecksumLen];	///< Frame split across buffers
+
+public:
+	CNMEAUBXPacket();
+	virtual ~CNMEAUBXPacket();
+
+	///
+	/// \brief Parses pData for UBX frames, everything between frames is skipped
+	///
+	/// \param pData Pointer to buffer to parse
+	/// \param nBufferSize Number of bytes in pData to process.
+	/// \return CNMEAParserData::ERROR_E, if successful, ERROR_OK is returned.
+	///
+	CNMEAParserData::ERROR_E ProcessUBXBuffer(const char *pData, size_t nBufferSize);
+
+	///
+	/// \brief Takes the bytes of one UBX frame from pData
+	///
+	/// Call it with pData pointing at a first sync character, or at the next byte of the
+	/// stream while IsInFrame() is true. It stops at the end of the frame, or right after the
+	/// sync character if the second sync character does not follow, so the caller can resume
+	/// its own scan there.
+	///
+	/// \param pData Pointer to the data
+	/// \param nBufferSize Number of bytes in pData
+	/// \return Number of bytes consumed. 0 if nBufferSize is 0, or if the sync character that ended
+	///         the previous buffer turned out not to start a frame.
+	///
+	size_t ConsumeUBX(const char *pData, size_t nBufferSize);
+
+	///
+	/// \brief Returns true while a frame is partially received
+	///
+	bool IsInFrame(void) const { return m_nState != UBX_STATE_SYNC1; }
+
+	///
+	/// \brief Reset the framer, a partially received frame is dropped
+	///
+	void Reset(void);
+
+	///
+	/// \brief Computes the UBX (8-bit Fletcher) checksum
+	///
+	/// \param pData Class, ID, length and payload
+	/// \param uLength Number of bytes
+	/// \param u8CkA Returned CK_A
+	/// \param u8CkB Returned CK_B
+	///
+	static void Checksum(const uint8_t *pData, size_t uLength, uint8_t &u8CkA, uint8_t &u8CkB);
+
+	///
+	/// \brief This method is called for frames that are dropped
+	///
+	/// \param nError ERROR_CHECKSUM or ERROR_RX_BUFFER_OVERFLOW (payload longer than c_uMaxPayload)
+	/// \param uClass Message class
+	/// \param uID Message ID
+	///
+	virtual void OnUBXError(CNMEAParserData::ERROR_E nError, uint8_t uClass, uint8_t uID) { UNUSED_PARAM(nError); UNUSED_PARAM(uClass); UNUSED_PARAM(uID); }
+
+protected:
+
+	///
+	/// \brief Redefine this method to process valid UBX messages
+	///
+	/// \param uClass Message class
+	/// \param uID Message ID
+	/// \param pPayload Payload, only valid for the duration of the call. Not aligned.
+	/// \param uLength Payload length
+	/// \param nRxTimeNs Time the first sync character arrived, monotonic (steady) clock in nanoseconds
+	///
+	virtual void ProcessUBXMessage(uint8_t uClass, uint8_t uID, const uint8_t *pPayload, uint16_t uLength, int64_t nRxTimeNs) = 0;
+
+private:
+	///
+	/// \brief Verifies the checksum of a complete frame (without sync characters) and delivers it
+	///
+	void OnFrame(const uint8_t *pFrame, uint16_t uLength);
+};
@@ -0,0 +1,575 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+
+//
+// Micro benchmarks for the NMEA parser library.
+//
+// Build with bench.pro, or directly:
+//   g++ -O2 -std=c++11 -I.. NMEAParserBench.cpp ../*.cpp -o nmeabench
+// Add -mavx2 for the AVX2 scanner or -DNMEA_SCAN_NO_SIMD for the scalar one.
+//
+// Usage: nmeabench [recorded.nmea]
+//
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "NMEAFieldParser.h"
+#include "NMEAGeodesy.h"
+#include "NMEALogIngest.h"
+#include "NMEAParser.h"
+#include "NMEAParserPacket.h"
+#include "NMEARTCM3Forwarder.h"
+#include "NMEAUBX.h"
+#include "NMEAScan.h"
+
+typedef std::chrono::steady_clock BenchClock;
+
+static double ElapsedNs(BenchClock::time_point start)
+{
+	return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(BenchClock::now() - start).count();
+}
+
+///
+/// \brief Synthetic numeric fields shaped like real GGA/RMC/GSV content
+///
+static void MakeNumericFields(std::vector<std::string> &vDecimals, std::vector<std::string> &vLatitudes, size_t uCount)
+{
+	char szField[64];
+	srand(1);
+	for (size_t i = 0; i < uCount; i++)
+	{
+		int nDecimals = 1 + rand() % 5;
+		snprintf(szField, sizeof(szField), "%.*f", nDecimals, (rand() % 200000) / 10.0 - 500.0);
+		vDecimals.push_back(szField);
+
+		snprintf(szField, sizeof(szField), "%02d%08.5f", rand() % 90, (rand() % 6000000) / 100000.0);
+		vLatitudes.push_back(szField);
+	}
+}
+
+///
+/// \brief Field conversion: historical copy + atof path against CNMEAFieldParser
+///
+static void BenchFieldConversion(void)
+{
+	const size_t uCount = 4096;
+	const int nPasses = 500;
+	std::vector<std::string> vDecimals, vLatitudes;
+	MakeNumericFields(vDecimals, vLatitudes, uCount);
+
+	double dSink = 0.0;
+	size_t uMismatch = 0;
+
+	//
+	// Decimal fields
+	//
+	BenchClock::time_point start = BenchClock::now();
+	for (int p = 0; p < nPasses; p++)
+	{
+		for (size_t i = 0; i < uCount; i++)
+		{
+			char szField[256];
+			strcpy(szField, vDecimals[i].c_str());
+			dSink += atof(szField);
+		}
+	}
+	double dAtofNs = ElapsedNs(start) / (uCount * nPasses);
+
+	start = BenchClock::now();
+	for (int p = 0; p < nPasses; p++)
+	{
+		for (size_t i = 0; i < uCount; i++)
+		{
+			double dValue = 0.0;
+			CNMEAFieldParser::ParseDouble(vDecimals[i].c_str(), vDecimals[i].size(), dValue);
+			dSink += dValue;
+		}
+	}
+	double dParseNs = ElapsedNs(start) / (uCount * nPasses);
+
+	//
+	// Latitude fields, ddmm.mmmmm
+	//
+	start = BenchClock::now();
+	for (int p = 0; p < nPasses; p++)
+	{
+		for (size_t i = 0; i < uCount; i++)
+		{
+			char szField[256];
+			strcpy(szField, vLatitudes[i].c_str());
+			double dLat = atof(szField + 2) / 60.0;
+			szField[2] = '\0';
+			dLat += atof(szField);
+			dSink += dLat;
+		}
+	}
+	double dAtofLatNs = ElapsedNs(start) / (uCount * nPasses);
+
+	start = BenchClock::now();
+	for (int p = 0; p < nPasses; p++)
+	{
+		for (size_t i = 0; i < uCount; i++)
+		{
+			double dLat = 0.0;
+			CNMEAFieldParser::ParseCoordinate(vLatitudes[i].c_str(), vLatitudes[i].size(), 2, dLat);
+			dSink += dLat;
+		}
+	}
+	double dParseLatNs = ElapsedNs(start) / (uCount * nPasses);
+
+	start = BenchClock::now();
+	for (int p = 0; p < nPasses; p++)
+	{
+		for (size_t i = 0; i < uCount; i++)
+		{
+			int64_t nLat = 0;
+			CNMEAFieldParser::ParseCoordinate(vLatitudes[i].c_str(), vLatitudes[i].size(), 2, nLat);
+			dSink += (double)nLat;
+		}
+	}
+	double dParseNanoNs = ElapsedNs(start) / (uCount * nPasses);
+
+	//
+	// Results must be bit identical to the atof path
+	//
+	for (size_t i = 0; i < uCount; i++)
+	{
+		double dOld = atof(vDecimals[i].c_str());
+		double dNew = 0.0;
+		CNMEAFieldParser::ParseDouble(vDecimals[i].c_str(), vDecimals[i].size(), dNew);
+		uMismatch += memcmp(&dOld, &dNew, sizeof(double)) != 0;
+
+		char szField[64];
+		strcpy(szField, vLatitudes[i].c_str());
+		dOld = atof(szField + 2) / 60.0;
+		szField[2] = '\0';
+		dOld += atof(szField);
+		CNMEAFieldParser::ParseCoordinate(vLatitudes[i].c_str(), vLatitudes[i].size(), 2, dNew);
+		uMismatch += memcmp(&dOld, &dNew, sizeof(double)) != 0;
+	}
+
+	printf("Field conversion (ns/field)\n");
+	printf("   decimal      atof: %6.1f   ParseDouble:     %6.1f\n", dAtofNs, dParseNs);
+	printf("   ddmm.mmmmm   atof: %6.1f   ParseCoordinate: %6.1f (nano-degrees: %.1f)\n", dAtofLatNs, dParseLatNs, dParseNanoNs);
+	printf("   mismatches against atof: %u (checksum %g)\n", (unsigned int)uMismatch, dSink);
+}
+
+///
+/// \brief Packet framer that only counts what it frames
+///
+class CBenchPacket : public CNMEAParserPacket
+{
+public:
+	size_t	m_uSentences;
+	size_t	m_uErrors;
+
+	CBenchPacket() : m_uSentences(0), m_uErrors(0) {}
+
+	virtual void OnError(CNMEAParserData::ERROR_E nError, char *pCmd) { UNUSED_PARAM(nError); UNUSED_PARAM(pCmd); m_uErrors++; }
+
+protected:
+	virtual CNMEAParserData::ERROR_E ProcessRxCommand(char *pCmd, char *pData) { UNUSED_PARAM(pCmd); UNUSED_PARAM(pData); m_uSentences++; return CNMEAParserData::ERROR_OK; }
+};
+
+///
+/// \brief Appends a sentence with its checksum
+///
+static void AppendSentence(std::string &strLog, const char *pBody)
+{
+	uint8_t u8Checksum = 0;
+	for (const char *p = pBody; *p; p++)
+	{
+		u8Checksum ^= (uint8_t)*p;
+	}
+	char szTail[8];
+	snprintf(szTail, sizeof(szTail), "*%02X\r\n", u8Checksum);
+	strLog += '$';
+	strLog += pBody;
+	strLog += szTail;
+}
+
+///
+/// \brief Synthetic multi-constellation log: one GGA, RMC, GSA and three GSV sentences per epoch
+///
+static void MakeSyntheticLog(std::string &strLog, size_t uBytes)
+{
+	char szBody[256];
+	srand(2);
+	for (int nEpoch = 0; strLog.size() < uBytes; nEpoch++)
+	{
+		int nSec = nEpoch % 86400;
+		snprintf(szBody, sizeof(szBody), "GNGGA,%02d%02d%02d.00,3350.%05d,N,11751.%05d,W,1,12,0.85,%d.%d,M,-32.7,M,,",
+			nSec / 3600, (nSec / 60) % 60, nSec % 60, rand() % 100000, rand() % 100000, 60 + rand() % 20, rand() % 10);
+		AppendSentence(strLog, szBody);
+		snprintf(szBody, sizeof(szBody), "GNRMC,%02d%02d%02d.00,A,3350.%05d,N,11751.%05d,W,0.%03d,%d.%02d,160626,,,A",
+			nSec / 3600, (nSec / 60) % 60, nSec % 60, rand() % 100000, rand() % 100000, rand() % 1000, rand() % 360, rand() % 100);
+		AppendSentence(strLog, szBody);
+		AppendSentence(strLog, "GNGSA,A,3,02,05,12,13,15,18,20,25,29,,,,1.53,0.85,1.27");
+		for (int nGSV = 1; nGSV <= 3; nGSV++)
+		{
+			snprintf(szBody, sizeof(szBody), "GPGSV,3,%d,12,%02d,%02d,%03d,%02d,%02d,%02d,%03d,%02d,%02d,%02d,%03d,%02d,%02d,%02d,%03d,%02d",
+				nGSV, rand() % 32 + 1, rand() % 90, rand() % 360, rand() % 50, rand() % 32 + 1, rand() % 90, rand() % 360, rand() % 50,
+				rand() % 32 + 1, rand() % 90, rand() % 360, rand() % 50, rand() % 32 + 1, rand() % 90, rand() % 360, rand() % 50);
+			AppendSentence(strLog, szBody);
+		}
+	}
+}
+
+///
+/// \brief Frames the whole log in uReadSize chunks, the way a serial or file reader would
+///
+static void BenchFraming(const char *pName, std::string &strLog, size_t uReadSize)
+{
+	const int nPasses = 5;
+	double dBestNs = 0.0;
+	CBenchPacket packet;
+
+	for (int p = 0; p < nPasses; p++)
+	{
+		packet.Reset();
+		packet.m_uSentences = packet.m_uErrors = 0;
+		BenchClock::time_point start = BenchClock::now();
+		for (size_t i = 0; i < strLog.size(); i += uReadSize)
+		{
+			size_t uLength = (strLog.size() - i < uReadSize) ? strLog.size() - i : uReadSize;
+			packet.ProcessNMEABuffer(&strLog[i], uLength);
+		}
+		double dNs = ElapsedNs(start);
+		if (p == 0 || dNs < dBestNs)
+		{
+			dBestNs = dNs;
+		}
+	}
+
+	printf("   %-10s %6u byte reads: %8.1f MB/s  (%u sentences, %u errors)\n", pName, (unsigned int)uReadSize,
+		(double)strLog.size() / 1e6 / (dBestNs / 1e9), (unsigned int)packet.m_uSentences, (unsigned int)packet.m_uErrors);
+}
+
+///
+/// \brief Parses the whole log with CNMEALogIngest on 1, 2, 4, ... threads
+///
+static void BenchIngest(const char *pName, const std::string &strLog)
+{
+	int nMaxThreads = (int)std::thread::hardware_concurrency();
+	if (nMaxThreads <= 0)
+	{
+		nMaxThreads = 1;
+	}
+
+	double dSingleNs = 0.0;
+	for (int nThreads = 1; ; nThreads *= 2)
+	{
+		if (nThreads > nMaxThreads)
+		{
+			nThreads = nMaxThreads;
+		}
+		CNMEALogIngest ingest;
+		double dBestNs = 1e30;
+		for (int nRun = 0; nRun < 3; nRun++)
+		{
+			BenchClock::time_point start = BenchClock::now();
+			ingest.Ingest(strLog.data(), strLog.size(), nThreads);
+			double dNs = ElapsedNs(start);
+			if (dNs < dBestNs)
+			{
+				dBestNs = dNs;
+			}
+		}
+		if (nThreads == 1)
+		{
+			dSingleNs = dBestNs;
+		}
+		printf("   %-10s %3d threads: %8.1f MB/s  speedup %4.2f  (%u fixes)\n", pName, nThreads,
+			(double)strLog.size() / 1e6 / (dBestNs / 1e9), dSingleNs / dBestNs, (unsigned int)ingest.GetFixCount());
+		if (nThreads == nMaxThreads)
+		{
+			break;
+		}
+	}
+}
+
+///
+/// \brief Appends a UBX frame with its checksum
+///
+static void AppendUBX(std::string &strLog, uint8_t uClass, uint8_t uID, const std::vector<uint8_t> &vPayload)
+{
+	std::vector<uint8_t> vFrame;
+	vFrame.push_back(uClass);
+	vFrame.push_back(uID);
+	vFrame.push_back((uint8_t)vPayload.size());
+	vFrame.push_back((uint8_t)(vPayload.size() >> 8));
+	vFrame.insert(vFrame.end(), vPayload.begin(), vPayload.end());
+	uint8_t u8CkA;
+	uint8_t u8CkB;
+	CNMEAUBXPacket::Checksum(vFrame.data(), vFrame.size(), u8CkA, u8CkB);
+	strLog += (char)CNMEAUBXPacket::c_uSync1;
+	strLog += (char)CNMEAUBXPacket::c_uSync2;
+	strLog.append((const char *)vFrame.data(), vFrame.size());
+	strLog += (char)u8CkA;
+	strLog += (char)u8CkB;
+}
+
+///
+/// \brief Decodes the same epochs sent as NMEA (GGA, RMC, GSA, VTG) and as UBX (NAV-DOP, NAV-PVT)
+///
+static void BenchUBX(void)
+{
+	const int nEpochs = 200000;
+	std::string strNMEA;
+	std::string strUBX;
+	char szBody[256];
+	std::vector<uint8_t> vPVT(CNMEAUBX::c_uNavPVTLength, 0);
+	std::vector<uint8_t> vDOP(CNMEAUBX::c_uNavDOPLength, 0);
+	srand(3);
+	for (int nEpoch = 0; nEpoch < nEpochs; nEpoch++)
+	{
+		int nSec = nEpoch % 86400;
+		snprintf(szBody, sizeof(szBody), "GNGGA,%02d%02d%02d.00,3350.%05d,N,11751.%05d,W,1,12,0.85,%d.%d,M,-32.7,M,,",
+			nSec / 3600, (nSec / 60) % 60, nSec % 60, rand() % 100000, rand() % 100000, 60 + rand() % 20, rand() % 10);
+		AppendSentence(strNMEA, szBody);
+		snprintf(szBody, sizeof(szBody), "GNRMC,%02d%02d%02d.00,A,3350.%05d,N,11751.%05d,W,0.%03d,%d.%02d,160626,,,A",
+			nSec / 3600, (nSec / 60) % 60, nSec % 60, rand() % 100000, rand() % 100000, rand() % 1000, rand() % 360, rand() % 100);
+		AppendSentence(strNMEA, szBody);
+		AppendSentence(strNMEA, "GNGSA,A,3,02,05,12,13,15,18,20,25,29,,,,1.53,0.85,1.27");
+		AppendSentence(strNMEA, "GNVTG,54.70,T,,M,0.52,N,0.96,K,A");
+
+		vDOP[6] = 153;
+		vDOP[12] = 85;
+		AppendUBX(strUBX, CNMEAUBX::c_uClassNAV, CNMEAUBX::c_uIdNavDOP, vDOP);
+		vPVT[8] = (uint8_t)(nSec / 3600);
+		vPVT[9] = (uint8_t)((nSec / 60) % 60);
+		vPVT[10] = (uint8_t)(nSec % 60);
+		vPVT[20] = 3;
+		vPVT[21] = 0x01;
+		vPVT[23] = 12;
+		for (int i = 24; i < 40; i++)
+		{
+			vPVT[i] = (uint8_t)rand();
+		}
+		AppendUBX(strUBX, CNMEAUBX::c_uClassNAV, CNMEAUBX::c_uIdNavPVT, vPVT);
+	}
+
+	const std::string *pLogs[2] = { &strNMEA, &strUBX };
+	const char *pNames[2] = { "NMEA", "UBX" };
+	for (int n = 0; n < 2; n++)
+	{
+		std::string strLog = *pLogs[n];
+		double dBestNs = 1e30;
+		for (int nRun = 0; nRun < 3; nRun++)
+		{
+			CNMEAParser parser;
+			parser.EnableUBX(n == 1);
+			BenchClock::time_point start = BenchClock::now();
+			for (size_t i = 0; i < strLog.size(); i += 4096)
+			{
+				size_t uLength = (strLog.size() - i < 4096) ? strLog.size() - i : 4096;
+				parser.ProcessNMEABuffer(&strLog[i], uLength);
+			}
+			double dNs = ElapsedNs(start);
+			if (dNs < dBestNs)
+			{
+				dBestNs = dNs;
+			}
+		}
+		printf("   %-10s %6.1f bytes/epoch: %7.1f ns/epoch\n", pNames[n], (double)strLog.size() / nEpochs, dBestNs / nEpochs);
+	}
+}
+
+///
+/// \brief Frames and forwards a synthetic MSM correction stream to a link that only counts bytes
+///
+static void BenchRTCM3(size_t uReadSize)
+{
+	const uint16_t puTypes[] = { 1005, 1077, 1087, 1097, 1127, 1230 };
+	const size_t puPayloads[] = { 19, 600, 450, 500, 400, 8 };
+	std::string strLog;
+	srand(4);
+	while (strLog.size() < 64 * 1024 * 1024)
+	{
+		for (int t = 0; t < 6; t++)
+		{
+			std::vector<uint8_t> vFrame(CNMEARTCM3Packet::c_uHeaderLen + puPayloads[t]);
+			vFrame[0] = CNMEARTCM3Packet::c_uPreamble;
+			vFrame[1] = (uint8_t)(puPayloads[t] >> 8);
+			vFrame[2] = (uint8_t)puPayloads[t];
+			for (size_t i = CNMEARTCM3Packet::c_uHeaderLen; i < vFrame.size(); i++)
+			{
+				vFrame[i] = (uint8_t)rand();
+			}
+			vFrame[3] = (uint8_t)(puTypes[t] >> 4);
+			vFrame[4] = (uint8_t)((puTypes[t] << 4) | (vFrame[4] & 0x0F));
+			uint32_t uCRC = CNMEARTCM3Packet::CRC24Q(vFrame.data(), vFrame.size());
+			vFrame.push_back((uint8_t)(uCRC >> 16));
+			vFrame.push_back((uint8_t)(uCRC >> 8));
+			vFrame.push_back((uint8_t)uCRC);
+			strLog.append((const char *)vFrame.data(), vFrame.size());
+		}
+	}
+
+	double dBestNs = 1e30;
+	size_t uForwarded = 0;
+	CNMEARTCM3Forwarder forwarder;
+	forwarder.SetWriter([&uForwarded](const uint8_t *pData, size_t uLength) { UNUSED_PARAM(pData); uForwarded += uLength; return true; });
+	for (int nRun = 0; nRun < 3; nRun++)
+	{
+		forwarder.Reset();
+		forwarder.ResetStatistics();
+		uForwarded = 0;
+		BenchClock::time_point start = BenchClock::now();
+		for (size_t i = 0; i < strLog.size(); i += uReadSize)
+		{
+			size_t uLength = (strLog.size() - i < uReadSize) ? strLog.size() - i : uReadSize;
+			forwarder.ProcessRTCM3Buffer(&strLog[i], uLength);
+		}
+		double dNs = ElapsedNs(start);
+		if (dNs < dBestNs)
+		{
+			dBestNs = dNs;
+		}
+	}
+	printf("   %6u byte reads: %8.1f MB/s  (%.1f%% forwarded, p99 latency %lld ns)\n", (unsigned int)uReadSize,
+		(double)strLog.size() / 1e6 / (dBestNs / 1e9), 100.0 * (double)uForwarded / (double)strLog.size(),
+		(long long)forwarder.GetLatencyHistogram().GetPercentile(99.0));
+}
+
+//
+// Track of geodetic points to a local ENU frame: one libm call per point and
+// angle against CNMEALocalFrame::GeodeticToENU() on the whole array
+//
+static void BenchGeodesy(void)
+{
+	const size_t uCount = 100000;
+	const int nPasses = 20;
+	const double dPi = 3.14159265358979323846;
+	const double dA = 6378137.0;
+	const double dE2 = 6.69437999014e-3;
+	std::vector<double> vLat(uCount), vLon(uCount), vAlt(uCount), vEast(uCount), vNorth(uCount), vUp(uCount);
+	srand(5);
+	for (size_t i = 0; i < uCount; i++)
+	{
+		vLat[i] = 47.0 + (double)rand() / RAND_MAX - 0.5;
+		vLon[i] = 8.0 + (double)rand() / RAND_MAX - 0.5;
+		vAlt[i] = 400.0 + (double)rand() / RAND_MAX * 1000.0;
+	}
+	CNMEALocalFrame frame(47.0, 8.0, 400.0);
+	const CNMEAMatrix<3, 3> &R = frame.GetRotation();
+	double dOriginX, dOriginY, dOriginZ;
+	double dLat0 = 47.0, dLon0 = 8.0, dAlt0 = 400.0;
+	CNMEAGeodesy::GeodeticToECEF(&dLat0, &dLon0, &dAlt0, 1, &dOriginX, &dOriginY, &dOriginZ);
+
+	double dSink = 0.0;
+	BenchClock::time_point start = BenchClock::now();
+	for (int p = 0; p < nPasses; p++)
+	{
+		for (size_t i = 0; i < uCount; i++)
+		{
+			double dSinLat = sin(vLat[i] * dPi / 180.0);
+			double dCosLat = cos(vLat[i] * dPi / 180.0);
+			double dN = dA / sqrt(1.0 - dE2 * dSinLat * dSinLat);
+			double dX = (dN + vAlt[i]) * dCosLat * cos(vLon[i] * dPi / 180.0) - dOriginX;
+			double dY = (dN + vAlt[i]) * dCosLat * sin(vLon[i] * dPi / 180.0) - dOriginY;
+			double dZ = (dN * (1.0 - dE2) + vAlt[i]) * dSinLat - dOriginZ;
+			vEast[i] = R(0, 0) * dX + R(0, 1) * dY + R(0, 2) * dZ;
+			vNorth[i] = R(1, 0) * dX + R(1, 1) * dY + R(1, 2) * dZ;
+			vUp[i] = R(2, 0) * dX + R(2, 1) * dY + R(2, 2) * dZ;
+		}
+		dSink += vEast[p];
+	}
+	double dLibmNs = ElapsedNs(start) / ((double)nPasses * uCount);
+
+	start = BenchClock::now();
+	for (int p = 0; p < nPasses; p++)
+	{
+		frame.GeodeticToENU(vLat.data(), vLon.data(), vAlt.data(), uCount, vEast.data(), vNorth.data(), vUp.data());
+		dSink += vEast[p];
+	}
+	double dBatchNs = ElapsedNs(start) / ((double)nPasses * uCount);
+
+	start = BenchClock::now();
+	for (int p = 0; p < nPasses; p++)
+	{
+		frame.ENUToGeodetic(vEast.data(), vNorth.data(), vUp.data(), uCount, vLat.data(), vLon.data(), vAlt.data());
+		dSink += vLat[p];
+	}
+	double dInverseNs = ElapsedNs(start) / ((double)nPasses * uCount);
+
+	printf("   geodetic to ENU: libm per point %.1f ns, batch %.1f ns (%.1fx); ENU to geodetic batch %.1f ns  (%s, checksum %g)\n",
+		dLibmNs, dBatchNs, dLibmNs / dBatchNs, dInverseNs, CNMEAGeodesy::GetImplementation(), dSink);
+}
+
+int main(int argc, char *argv[])
+{
+	BenchFieldConversion();
+
+	printf("Sentence framing, %s scanner\n", CNMEAScan::GetImplementation());
+	std::string strLog;
+	MakeSyntheticLog(strLog, 64 * 1024 * 1024);
+	BenchFraming("synthetic", strLog, 64);
+	BenchFraming("synthetic", strLog, 4096);
+	BenchFraming("synthetic", strLog, 1024 * 1024);
+
+	printf("Log ingest (decode into fix table)\n");
+	BenchIngest("synthetic", strLog);
+
+	printf("Epoch decode, NMEA text vs UBX binary\n");
+	BenchUBX();
+
+	printf("RTCM 3 framing and forwarding\n");
+	BenchRTCM3(64);
+	BenchRTCM3(4096);
+
+	printf("Coordinate transformation, 100000 point track\n");
+	BenchGeodesy();
+
+	//
+	// Optional recorded log
+	//
+	if (argc > 1)
+	{
+		FILE *pFile = fopen(argv[1], "rb");
+		if (pFile == NULL)
+		{
+			printf("Could not open %s\n", argv[1]);
+			return 1;
+		}
+		std::string strRecorded;
+		char szBuffer[65536];
+		size_t uRead;
+		while ((uRead = fread(szBuffer, 1, sizeof(szBuffer), pFile)) > 0)
+		{
+			strRecorded.append(szBuffer, uRead);
+		}
+		fclose(pFile);
+		BenchFraming("recorded", strRecorded, 4096);
+		BenchFraming("recorded", strRecorded, 1024 * 1024);
+		BenchIngest("recorded", strRecorded);
+	}
+	return 0;
+}
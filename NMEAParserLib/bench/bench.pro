@@ -0,0 +1,39 @@
+#-------------------------------------------------
+#
+# NMEA parser micro benchmarks (console, no Qt)
+#
+#   qmake bench.pro && make && ./nmeabench [recorded.nmea]
+#
+#-------------------------------------------------
+
+TEMPLATE = app
+TARGET = nmeabench
+CONFIG += console c++11 release thread
+CONFIG -= qt app_bundle
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    NMEAParserBench.cpp \
+    ../NMEAFieldParser.cpp \
+    ../NMEASentenceFields.cpp \
+    ../NMEASentenceBase.cpp \
+    ../NMEASatelliteDatabase.cpp \
+    ../NMEAEpochAssembler.cpp \
+    ../NMEAKinematicFilter.cpp \
+    ../NMEAClockCorrelator.cpp \
+    ../NMEASentenceGGA.cpp \
+    ../NMEASentenceGSA.cpp \
+    ../NMEASentenceGSV.cpp \
+    ../NMEASentenceRMC.cpp \
+    ../NMEAParserPacket.cpp \
+    ../NMEAUBXPacket.cpp \
+    ../NMEAUBX.cpp \
+    ../NMEARTCM3Packet.cpp \
+    ../NMEARTCM3Forwarder.cpp \
+    ../NMEAScan.cpp \
+    ../NMEAGeodesy.cpp \
+    ../NMEATrace.cpp \
+    ../NMEAHistogram.cpp \
+    ../NMEAParser.cpp \
+    ../NMEALogIngest.cpp
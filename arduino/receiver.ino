@@ -6,25 +6,137 @@
 
 #define PI 3.1415926535897932384626433832795
 
+// Binary telemetry, see telemetrydecoder.cpp on the host side.
+// Frame: channel (type << 5 | id), sequence, exponent, count, samples, CRC-16/CCITT,
+// COBS encoded and terminated by a zero byte.
+#define NEGOTIATE_BINARY 'B'
+#define NEGOTIATE_ASCII 'A'
+#define TYPE_INT16 0
+#define TYPE_TEXT 2
+#define CHANNEL_SENSOR 1
+#define CHANNEL_NMEA 2
+#define SENSOR_EXPONENT -4            // samples in units of 1e-4
+#define SAMPLES_PER_FRAME 16
+#define SAMPLE_INTERVAL_MS 10
+#define MAX_FRAME 96             // fits the GGA text frame
+
+const char *gga = "$GPGGA,145416.00,3350.10959,N,11751.22870,W,1,09,0.85,70.3,M,-32.7,M,,*5B";
+
+bool binary = false;
+uint8_t sequence = 0;
+int16_t samples[SAMPLES_PER_FRAME];
+int sampleCount = 0;
+unsigned long lastSample = 0;
+unsigned long lastFix = 0;
+int step = 1;
+
+uint16_t crc16(const uint8_t *data, int length) {
+  uint16_t crc = 0xffff;
+  for (int i = 0; i < length; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+// COBS encode and send a frame, then the zero delimiter
+void sendFrame(const uint8_t *frame, int length) {
+  int start = 0;
+  while (true) {
+    int run = 0;
+    while (start + run < length && frame[start + run] != 0 && run < 254) {
+      run++;
+    }
+    Serial.write((uint8_t)(run + 1));
+    Serial.write(frame + start, run);
+    start += run;
+    if (start >= length) {
+      break;
+    }
+    if (run < 254) {
+      start++;    // the code byte stands in for this zero
+    }
+  }
+  Serial.write((uint8_t)0);
+}
+
+void sendPacket(uint8_t type, uint8_t channel, int8_t exponent, const uint8_t *payload, int count, int sampleSize) {
+  uint8_t frame[MAX_FRAME];
+  int length = 0;
+  frame[length++] = (type << 5) | channel;
+  frame[length++] = sequence++;
+  frame[length++] = (uint8_t)exponent;
+  frame[length++] = count;
+  memcpy(&frame[length], payload, count * sampleSize);
+  length += count * sampleSize;
+  uint16_t crc = crc16(frame, length);
+  frame[length++] = crc & 0xff;
+  frame[length++] = crc >> 8;
+  sendFrame(frame, length);
+}
+
+void negotiate() {
+  while (Serial.available() > 0) {
+    int c = Serial.read();
+    if (c == NEGOTIATE_BINARY || c == NEGOTIATE_ASCII) {
+      binary = (c == NEGOTIATE_BINARY);
+      sampleCount = 0;
+      Serial.write((uint8_t)0);   // the host resynchronizes on the delimiter
+    }
+  }
+}
+
 void setup() {
   // initialize serial
   Serial.begin(9600);
 }
 
-void loop() {
+void loopAscii() {
    int D = 100;
-   for (int i = 1; i <= D; i++){
+   for (int i = 1; i <= D && !binary; i++){
       if (i%2 == 0){
-        Serial.print("$GPGGA,145416.00,3350.10959,N,11751.22870,W,1,09,0.85,70.3,M,-32.7,M,,*5B");
+        Serial.print(gga);
         Serial.print("\n");
         Serial.flush();
-        delay(1000);        
+        delay(1000);
       }else{
         Serial.print(sin(2*PI/D*i));
         Serial.print(";");
         Serial.flush();
         delay(1000);
       }
+      negotiate();
    }
    delay(1000);
 }
+
+// Same signal sampled at 100 Hz, 16 samples per frame, and the fix once a second
+void loopBinary() {
+  int D = 100;
+  unsigned long now = millis();
+  if (now - lastSample >= SAMPLE_INTERVAL_MS) {
+    lastSample = now;
+    samples[sampleCount++] = (int16_t)lround(sin(2*PI/D*step) * 10000.0);
+    step = step % D + 1;
+    if (sampleCount == SAMPLES_PER_FRAME) {
+      // AVR is little endian like the wire format
+      sendPacket(TYPE_INT16, CHANNEL_SENSOR, SENSOR_EXPONENT, (const uint8_t *)samples, sampleCount, 2);
+      sampleCount = 0;
+    }
+  }
+  if (now - lastFix >= 1000) {
+    lastFix = now;
+    sendPacket(TYPE_TEXT, CHANNEL_NMEA, 0, (const uint8_t *)gga, strlen(gga), 1);
+  }
+}
+
+void loop() {
+  negotiate();
+  if (binary) {
+    loopBinary();
+  } else {
+    loopAscii();
+  }
+}
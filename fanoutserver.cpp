@@ -0,0 +1,196 @@
+#include "fanoutserver.h"
+#include "NMEAParserLib/NMEAFanOutRing.h"
+
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+/*!
+    \brief Serves the records of a CNMEAFanOutRing to any number of TCP and local socket clients.
+
+    The parser thread only appends to the ring. Each client has its own cursor into the ring
+    and a record type mask chosen by the listener it connected to (raw sentences, fix records
+    or both). A timer copies new records into every client's socket; nothing here ever holds
+    up the parser.
+
+    A client that does not drain its socket is not allowed to build an unbounded backlog:
+    above the soft limit it skips ahead to live data, above the hard limit, or after too many
+    skips in a row, it is disconnected. The ring itself moves a client that fell a whole ring
+    behind to the head as well.
+*/
+
+static const int c_pumpIntervalMs = 10;
+static const int c_scratchSize = 64 * 1024;
+
+FanOutServer::FanOutServer(const CNMEAFanOutRing &ring, QObject *parent)
+    : QObject(parent)
+    , m_ring(ring)
+    , m_scratch(c_scratchSize, Qt::Uninitialized)
+    , m_softLimit(256 * 1024)
+    , m_hardLimit(4 * 1024 * 1024)
+    , m_maxSkips(8)
+{
+    connect(&m_timer, SIGNAL(timeout()), this, SLOT(pump()));
+    m_timer.setInterval(c_pumpIntervalMs);
+}
+
+FanOutServer::~FanOutServer()
+{
+    close();
+}
+
+/*!
+    Accept TCP clients on \a port. They receive the records selected by \a typeMask,
+    see CNMEAFanOut::c_uMaskRaw and CNMEAFanOut::c_uMaskFix.
+*/
+bool FanOutServer::listenTcp(quint16 port, quint32 typeMask, const QHostAddress &address)
+{
+    QTcpServer *server = new QTcpServer(this);
+    if (!server->listen(address, port)) {
+        delete server;
+        return false;
+    }
+    m_serverMasks.insert(server, typeMask);
+    connect(server, SIGNAL(newConnection()), this, SLOT(handleNewTcpConnection()));
+    m_timer.start();
+    return true;
+}
+
+/*!
+    Accept local (Unix domain socket or named pipe) clients on \a name.
+*/
+bool FanOutServer::listenLocal(const QString &name, quint32 typeMask)
+{
+    QLocalServer::removeServer(name);
+    QLocalServer *server = new QLocalServer(this);
+    if (!server->listen(name)) {
+        delete server;
+        return false;
+    }
+    m_serverMasks.insert(server, typeMask);
+    connect(server, SIGNAL(newConnection()), this, SLOT(handleNewLocalConnection()));
+    m_timer.start();
+    return true;
+}
+
+/*!
+    Stop listening and disconnect all clients.
+*/
+void FanOutServer::close()
+{
+    m_timer.stop();
+    while (!m_clients.isEmpty())
+        dropClient(m_clients.size() - 1, QStringLiteral("server closed"));
+    foreach (QObject *server, m_serverMasks.keys())
+        delete server;
+    m_serverMasks.clear();
+}
+
+void FanOutServer::handleNewTcpConnection()
+{
+    QTcpServer *server = qobject_cast<QTcpServer *>(sender());
+    while (server && server->hasPendingConnections()) {
+        QTcpSocket *socket = server->nextPendingConnection();
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        addClient(socket, socket->peerAddress().toString() + ':' + QString::number(socket->peerPort()),
+                  m_serverMasks.value(server));
+    }
+}
+
+void FanOutServer::handleNewLocalConnection()
+{
+    QLocalServer *server = qobject_cast<QLocalServer *>(sender());
+    while (server && server->hasPendingConnections()) {
+        QLocalSocket *socket = server->nextPendingConnection();
+        addClient(socket, server->serverName(), m_serverMasks.value(server));
+    }
+}
+
+void FanOutServer::handleDisconnected()
+{
+    for (int i = 0; i < m_clients.size(); i++) {
+        if (m_clients[i].socket == sender()) {
+            dropClient(i, QStringLiteral("disconnected"));
+            return;
+        }
+    }
+}
+
+/*!
+    Clients only listen; throw away anything they send.
+*/
+void FanOutServer::discardInput()
+{
+    QIODevice *socket = qobject_cast<QIODevice *>(sender());
+    if (socket)
+        socket->readAll();
+}
+
+/*!
+    New clients start at the head: they get live data, not the history in the ring.
+*/
+void FanOutServer::addClient(QIODevice *socket, const QString &peer, quint32 typeMask)
+{
+    Client client;
+    client.socket = socket;
+    client.peer = peer;
+    client.cursor = m_ring.GetHead();
+    client.typeMask = typeMask;
+    client.skips = 0;
+    m_clients.append(client);
+
+    connect(socket, SIGNAL(disconnected()), this, SLOT(handleDisconnected()));
+    connect(socket, SIGNAL(readyRead()), this, SLOT(discardInput()));
+    emit clientConnected(peer);
+}
+
+void FanOutServer::dropClient(int index, const QString &reason)
+{
+    Client client = m_clients[index];
+    m_clients.remove(index);
+
+    client.socket->disconnect(this);
+    client.socket->close();
+    client.socket->deleteLater();
+    emit clientDropped(client.peer, reason);
+}
+
+/*!
+    Copy the records each client has not seen yet into its socket.
+*/
+void FanOutServer::pump()
+{
+    for (int i = m_clients.size() - 1; i >= 0; i--) {
+        Client &client = m_clients[i];
+        qint64 backlog = client.socket->bytesToWrite();
+
+        if (backlog > m_hardLimit) {
+            dropClient(i, QStringLiteral("backlog over hard limit"));
+            continue;
+        }
+        if (backlog > m_softLimit) {
+            // Not draining: do not queue more, continue with live data once it catches up
+            client.cursor = m_ring.GetHead();
+            if (++client.skips > m_maxSkips)
+                dropClient(i, QStringLiteral("too slow"));
+            continue;
+        }
+
+        bool skipped = false;
+        while (backlog <= m_softLimit) {
+            uint64_t skippedBytes = 0;
+            size_t length = m_ring.Read(client.cursor, client.typeMask, m_scratch.data(), m_scratch.size(), skippedBytes);
+            skipped = skipped || skippedBytes != 0;
+            if (length == 0)
+                break;
+            client.socket->write(m_scratch.constData(), (qint64)length);
+            backlog += (qint64)length;
+        }
+
+        if (!skipped)
+            client.skips = 0;
+        else if (++client.skips > m_maxSkips)
+            dropClient(i, QStringLiteral("too slow"));
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef FANOUTSERVER_H
+#define FANOUTSERVER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QHostAddress>
+#include <QTimer>
+#include <QVector>
+#include <stdint.h>
+
+class CNMEAFanOutRing;
+
+QT_BEGIN_NAMESPACE
+class QIODevice;
+class QLocalServer;
+class QTcpServer;
+QT_END_NAMESPACE
+
+class FanOutServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    FanOutServer(const CNMEAFanOutRing &ring, QObject *parent = nullptr);
+    ~FanOutServer();
+
+    bool listenTcp(quint16 port, quint32 typeMask, const QHostAddress &address = QHostAddress::Any);
+    bool listenLocal(const QString &name, quint32 typeMask);
+    void close();
+
+    void setSoftLimit(qint64 bytes) { m_softLimit = bytes; }
+    void setHardLimit(qint64 bytes) { m_hardLimit = bytes; }
+    void setMaxSkips(int skips) { m_maxSkips = skips; }
+    int clientCount() const { return m_clients.size(); }
+
+signals:
+    void clientConnected(const QString &peer);
+    void clientDropped(const QString &peer, const QString &reason);
+
+private slots:
+    void handleNewTcpConnection();
+    void handleNewLocalConnection();
+    void handleDisconnected();
+    void discardInput();
+    void pump();
+
+private:
+    struct Client {
+        QIODevice *socket;
+        QString peer;
+        uint64_t cursor;
+        quint32 typeMask;
+        int skips;
+    };
+
+    void addClient(QIODevice *socket, const QString &peer, quint32 typeMask);
+    void dropClient(int index, const QString &reason);
+
+    const CNMEAFanOutRing &m_ring;
+    QHash<QObject *, quint32> m_serverMasks;
+    QVector<Client> m_clients;
+    QByteArray m_scratch;
+    QTimer m_timer;
+    qint64 m_softLimit;
+    qint64 m_hardLimit;
+    int m_maxSkips;
+};
+
+#endif // FANOUTSERVER_H
@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT       += core gui widgets printsupport serialport webengine webenginewidgets webchannel websockets
+QT       += core gui widgets printsupport serialport webengine webenginewidgets webchannel websockets network
 
 TARGET = gstation
 TEMPLATE = app
@@ -20,6 +20,9 @@ DEFINES += QT_DEPRECATED_WARNINGS
 # You can also select to disable deprecated APIs only up to a certain version of Qt.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+# NMEA library trace level: 0 none, 1 errors (default), 2 every sentence. See NMEAParserLib/NMEATrace.h
+#DEFINES += NMEA_TRACE_LEVEL=2
+
 CONFIG += c++11
 
 SOURCES += \
@@ -32,25 +35,82 @@ SOURCES += \
     NMEAParserLib/NMEASentenceGSA.cpp \
     NMEAParserLib/NMEASentenceGGA.cpp \
     NMEAParserLib/NMEASentenceBase.cpp \
+    NMEAParserLib/NMEASatelliteDatabase.cpp \
+    NMEAParserLib/NMEAEpochAssembler.cpp \
+    NMEAParserLib/NMEAKinematicFilter.cpp \
+    NMEAParserLib/NMEAClockCorrelator.cpp \
+    NMEAParserLib/NMEAGeodesy.cpp \
+    NMEAParserLib/NMEAFieldParser.cpp \
+    NMEAParserLib/NMEASentenceFields.cpp \
     NMEAParserLib/NMEAParserPacket.cpp \
+    NMEAParserLib/NMEAUBXPacket.cpp \
+    NMEAParserLib/NMEAUBX.cpp \
+    NMEAParserLib/NMEARTCM3Packet.cpp \
+    NMEAParserLib/NMEARTCM3Forwarder.cpp \
+    NMEAParserLib/NMEAScan.cpp \
+    NMEAParserLib/NMEATrace.cpp \
+    NMEAParserLib/NMEAHistogram.cpp \
     NMEAParserLib/NMEAParser.cpp \
+    NMEAParserLib/NMEALogIngest.cpp \
+    NMEAParserLib/NMEAFanOutRing.cpp \
+    NMEAParserLib/NMEAFanOut.cpp \
     websockettransport.cpp \
-    websocketclientwrapper.cpp
+    websocketclientwrapper.cpp \
+    fanoutserver.cpp \
+    serialreader.cpp \
+    streamdemux.cpp \
+    telemetrydecoder.cpp \
+    timeseries.cpp
 
 HEADERS += \
         mainwindow.h \
     qcustomplot.h \
     ImageWidget.h \
     NMEAParserLib/NMEASentenceRMC.h \
+    NMEAParserLib/NMEASentenceVTG.h \
+    NMEAParserLib/NMEASentenceZDA.h \
+    NMEAParserLib/NMEASentenceGST.h \
+    NMEAParserLib/NMEASentenceGLL.h \
+    NMEAParserLib/NMEASentenceHDT.h \
     NMEAParserLib/NMEASentenceGSV.h \
     NMEAParserLib/NMEASentenceGSA.h \
     NMEAParserLib/NMEASentenceGGA.h \
     NMEAParserLib/NMEASentenceBase.h \
+    NMEAParserLib/NMEASchemaSentence.h \
+    NMEAParserLib/NMEAFieldSchema.h \
+    NMEAParserLib/NMEASatelliteDatabase.h \
+    NMEAParserLib/NMEAEpochAssembler.h \
+    NMEAParserLib/NMEAKinematicFilter.h \
+    NMEAParserLib/NMEAClockCorrelator.h \
+    NMEAParserLib/NMEAGeodesy.h \
+    NMEAParserLib/NMEAMatrix.h \
+    NMEAParserLib/NMEAFieldParser.h \
+    NMEAParserLib/NMEASentenceFields.h \
     NMEAParserLib/NMEAParserPacket.h \
+    NMEAParserLib/NMEAUBXPacket.h \
+    NMEAParserLib/NMEAUBX.h \
+    NMEAParserLib/NMEARTCM3Packet.h \
+    NMEAParserLib/NMEARTCM3Forwarder.h \
+    NMEAParserLib/NMEAScan.h \
+    NMEAParserLib/NMEATrace.h \
+    NMEAParserLib/NMEAHistogram.h \
+    NMEAParserLib/NMEAClock.h \
+    NMEAParserLib/NMEASnapshot.h \
     NMEAParserLib/NMEAParserData.h \
     NMEAParserLib/NMEAParser.h \
+    NMEAParserLib/NMEAParserT.h \
+    NMEAParserLib/NMEAParserPolicy.h \
+    NMEAParserLib/NMEALogIngest.h \
+    NMEAParserLib/NMEAFanOutRing.h \
+    NMEAParserLib/NMEAFanOut.h \
     websockettransport.h \
-    websocketclientwrapper.h
+    websocketclientwrapper.h \
+    fanoutserver.h \
+    serialreader.h \
+    streamdemux.h \
+    telemetrydecoder.h \
+    timeseries.h \
+    spscring.h
 
 FORMS += \
     mainwindow.ui
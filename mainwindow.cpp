@@ -3,12 +3,18 @@
 #include <stdint.h>
 #include <QDebug>
 #include <QTimer>
+#include <QThread>
 #include <QFileDialog>
 #include <qfileinfo.h>
 #include <QClipboard>
 #include "opencv2/opencv.hpp"
 #include <algorithm>
 #include "NMEAParserLib/NMEAParser.h"
+#include "NMEAParserLib/NMEAFanOut.h"
+#include "NMEAParserLib/NMEAClock.h"
+#include "fanoutserver.h"
+#include "serialreader.h"
+#include "timeseries.h"
 #include <fstream>
 #include <iomanip>
 #include "websocketclientwrapper.h"
@@ -36,64 +42,6 @@
 #include <stdio.h>
 #include <string.h>
 
-///
-/// \class MyParser
-/// \brief child class of CNMEAParser which will redefine notification calls from the parent class.
-///
-class MyNMEAParser : public CNMEAParser {
-
-    ///
-    /// \brief This method is called whenever there is a parsing error.
-    ///
-    /// Redefine this method to capture errors.
-    ///
-    /// \param pCmd Pointer to NMEA command that caused the error. Please note that this parameter may be NULL of not completely defined. Use with caution.
-    ///
-    virtual void OnError(CNMEAParserData::ERROR_E nError, char *pCmd) {
-        printf("ERROR for Cmd: %s, Number: %d\n", pCmd, nError);
-    }
-
-protected:
-    ///
-    /// \brief This method is redefined from CNMEAParserPacket::ProcessRxCommand(char *pCmd, char *pData)
-    ///
-    /// Here we are capturing the ProcessRxCommand to print out status. We also are looking for
-    /// the GPGGA message and displaying some data from it.
-    ///
-    /// \param pCmd Pointer to the NMEA command string
-    /// \param pData Comma separated data that belongs to the command
-    /// \return Returns CNMEAParserData::ERROR_OK If successful
-    ///
-    virtual CNMEAParserData::ERROR_E ProcessRxCommand(char *pCmd, char *pData) {
-
-        // Call base class to process the command
-        CNMEAParser::ProcessRxCommand(pCmd, pData);
-
-        printf("Cmd: %s\nData: %s\n", pCmd, pData);
-
-        // Check if this is the GPGGA command. If it is, then display some data
-        if (strstr(pCmd, "GPGGA") != NULL) {
-            CNMEAParserData::GGA_DATA_T ggaData;
-            if (GetGPGGA(ggaData) == CNMEAParserData::ERROR_OK) {
-                printf("GPGGA Parsed!\n");
-                printf("   Time:                %02d:%02d:%02d\n", ggaData.m_nHour, ggaData.m_nMinute, ggaData.m_nSecond);
-                printf("   Latitude:            %f\n", ggaData.m_dLatitude);
-                printf("   Longitude:           %f\n", ggaData.m_dLongitude);
-                printf("   Altitude:            %.01fM\n", ggaData.m_dAltitudeMSL);
-                printf("   GPS Quality:         %d\n", ggaData.m_nGPSQuality);
-                printf("   Satellites in view:  %d\n", ggaData.m_nSatsInView);
-                printf("   HDOP:                %.02f\n", ggaData.m_dHDOP);
-                printf("   Differential ID:     %d\n", ggaData.m_nDifferentialID);
-                printf("   Differential age:    %f\n", ggaData.m_dDifferentialAge);
-                printf("   Geoidal Separation:  %f\n", ggaData.m_dGeoidalSep);
-                printf("   Vertical Speed:      %.02f\n", ggaData.m_dVertSpeed);
-            }
-        }
-
-        return CNMEAParserData::ERROR_OK;
-    }
-};
-
 // solution 1: use cv::VideoCapture
 class Capture1 {
 private:
@@ -183,18 +131,63 @@ struct MainWindow::Private {
     Capture1 cap;
     //Capture2 cap;
     QTimer timer;
+    QTimer trackTimer;
+    CNMEAParser nmea;
+    CNMEAFanOut fanOut;
+    FanOutServer fanOutServer;
+    QThread serialThread;
+    SerialReader *serialReader;
+    QTimer plotTimer;
+    QVector<SerialSample> drained;
+    TimeSeries sensorSeries;
+    CNMEAParserData::GGA_DATA_T gpggaData;
+    uint32_t gpggaVersion;
+    Private(size_t rawCapacity, size_t tierCapacity)
+        : fanOutServer(fanOut.GetRing()), serialReader(nullptr), sensorSeries(rawCapacity, tierCapacity), gpggaVersion(0) {}
 };
 
+// NMEA fan-out: raw sentences on the usual NMEA over TCP port, fix records on the next one
+static const quint16 fanout_raw_port = 10110;
+static const quint16 fanout_fix_port = 10111;
+
+// The map marker follows the GNSS position predicted to the time it is drawn
+static const int track_interval_ms = 50;
+
+// Serial samples are read on their own thread and plotted at most once per frame
+static const int plot_interval_ms = 33;
+static const size_t serial_ring_capacity = 16384;
+static const int max_samples_per_frame = 4096;
+
+// Sensor history: one minute of raw samples at 100 Hz, an hour of 1 s buckets, 10 hours of
+// 10 s buckets and 60 hours of 1 min buckets, in constant memory
+static const size_t sensor_raw_capacity = 6000;
+static const size_t sensor_tier_capacity = 3600;
+
+// Adds the title below a plot once; QCustomPlot does not replace an occupied layout cell
+static void addTitle(QCustomPlot *plot, const QString &text)
+{
+    if (plot->plotLayout()->hasElement(1, 0))
+        return;
+    plot->plotLayout()->addElement(1, 0, new QCPTextElement(plot, text, QFont("sans", 10, QFont::Bold)));
+}
+
 MainWindow::MainWindow(QWidget *parent) :
     QMainWindow(parent),
     ui(new Ui::MainWindow)
 {
-    pv = new Private();
+    pv = new Private(sensor_raw_capacity, sensor_tier_capacity);
     ui->setupUi(this);
     //setFixedSize(2000, 800);
 
     pv->cap.open();
 
+    pv->fanOut.Attach(pv->nmea);
+    if (!pv->fanOutServer.listenTcp(fanout_raw_port, CNMEAFanOut::c_uMaskRaw))
+        qDebug() << "NMEA fan-out: cannot listen on port" << fanout_raw_port;
+    if (!pv->fanOutServer.listenTcp(fanout_fix_port, CNMEAFanOut::c_uMaskFix))
+        qDebug() << "NMEA fan-out: cannot listen on port" << fanout_fix_port;
+    pv->fanOutServer.listenLocal(QStringLiteral("gstation-nmea"), CNMEAFanOut::c_uMaskRaw | CNMEAFanOut::c_uMaskFix);
+
     QFileInfo jsFileInfo(QDir::currentPath() + "/qwebchannel.js");
 
     if (!jsFileInfo.exists())
@@ -235,11 +228,13 @@ MainWindow::MainWindow(QWidget *parent) :
     pv->timer.setInterval(0);
     pv->timer.start();
 
+    connect(&pv->trackTimer, SIGNAL(timeout()), this, SLOT(doTrack()));
+    pv->trackTimer.setInterval(track_interval_ms);
+    pv->trackTimer.start();
+
     MainWindow::makePlotMeasurement();
     MainWindow::makePlotSystem();
 
-    arduino = new QSerialPort(this);
-    serialBuffer = "";
     bool arduino_is_available = false;
     QString arduino_uno_port_name;
     foreach(const QSerialPortInfo &serialPortInfo, QSerialPortInfo::availablePorts()){
@@ -252,20 +247,22 @@ MainWindow::MainWindow(QWidget *parent) :
     }
     if(arduino_is_available){
         qDebug() << "Found the arduino port...\n";
-        arduino->setPortName(arduino_uno_port_name);
-        arduino->open(QSerialPort::ReadOnly);
-        arduino->setBaudRate(QSerialPort::Baud9600);
-        arduino->setDataBits(QSerialPort::Data8);
-        arduino->setFlowControl(QSerialPort::NoFlowControl);
-        arduino->setParity(QSerialPort::NoParity);
-        arduino->setStopBits(QSerialPort::OneStop);
-        QObject::connect(arduino, SIGNAL(readyRead()), this, SLOT(readSerial()));
+        pv->serialReader = new SerialReader(arduino_uno_port_name, QSerialPort::Baud9600, serial_ring_capacity);
+        pv->serialReader->setNmeaParser(&pv->nmea);
+        pv->serialReader->setBinaryTelemetry(true);
+        pv->serialReader->moveToThread(&pv->serialThread);
+        connect(&pv->serialThread, SIGNAL(started()), pv->serialReader, SLOT(open()));
+        connect(pv->serialReader, SIGNAL(error(QString)), this, SLOT(reportSerialError(QString)));
+        pv->serialThread.start();
+        pv->drained.resize(max_samples_per_frame);
+        connect(&pv->plotTimer, SIGNAL(timeout()), this, SLOT(drainSerial()));
+        pv->plotTimer.setInterval(plot_interval_ms);
+        pv->plotTimer.start();
     }else{
         qDebug() << "Couldn't find the correct port for the arduino.\n";
         QMessageBox::information(this, "Serial Port Error", "Couldn't open serial port to arduino.");
     }
 
-    readSerial();
     makePlotMeasurement();
     makePlotSystem();
     doGPS();
@@ -274,18 +271,22 @@ MainWindow::MainWindow(QWidget *parent) :
 MainWindow::~MainWindow()
 {
     pv->cap.close();
+    if (pv->serialReader) {
+        QMetaObject::invokeMethod(pv->serialReader, "close", Qt::BlockingQueuedConnection);
+        pv->serialThread.quit();
+        pv->serialThread.wait();
+        delete pv->serialReader;
+    }
     delete pv;
     delete ui;
-    if(arduino->isOpen()){
-        arduino->close();
-    }
 }
 
 void MainWindow::makePlotMeasurement(){
 
     // generate some data:
     QVector<double> x, y;
-    if (data.size() == 0){
+    TimeSeriesSpan<TimeSeries::Point> raw = pv->sensorSeries.raw();
+    if (raw.isEmpty()){
         x.resize(1000); y.resize(1000);
         for (int i=0; i<1000; ++i)
         {
@@ -302,11 +303,12 @@ void MainWindow::makePlotMeasurement(){
         }
 
     }else{
-        x.resize(data.size()); y.resize(data.size()); // initialize with entries 0..100
-        for (int i=0; i<data.size(); ++i)
+        // the newest samples, read in place from the raw ring
+        x.resize(int(raw.size())); y.resize(int(raw.size()));
+        for (int i=0; i<int(raw.size()); ++i)
         {
-           x[i] = i; // x goes from -1 to 1
-           y[i] = data[i]; // let's plot a quadratic function
+           x[i] = i;
+           y[i] = raw[size_t(i)].value;
         }
     }
     double minx = *std::min_element(x.constBegin(), x.constEnd());
@@ -326,8 +328,7 @@ void MainWindow::makePlotMeasurement(){
     // set axes ranges, so we see all data:
     ui->widget_2->xAxis->setRange(minx, maxx);
     ui->widget_2->yAxis->setRange(miny, maxy);
-    QCPTextElement *title = new QCPTextElement(ui->widget_2, "Measurment", QFont("sans", 10, QFont::Bold));
-    ui->widget_2->plotLayout()->addElement(1, 0, title);
+    addTitle(ui->widget_2, "Measurment");
     ui->widget_2->replot();
 }
 
@@ -343,8 +344,10 @@ void MainWindow::makePlotSystem(){
     ui->widget_4->axisRect()->insetLayout()->setInsetAlignment(0, Qt::AlignBottom|Qt::AlignRight);
 
     // generate some data:
+    // with samples, the graphs are the mean, min and max of the 1 s buckets, read in place
     QVector<double> x, y;
-    if (data.size() == 0){
+    TimeSeriesSpan<TimeSeries::Bucket> buckets = pv->sensorSeries.tier(TimeSeries::TierSecond);
+    if (buckets.isEmpty()){
         x.resize(1000); y.resize(1000);
         for (int i=0; i<1000; ++i)
         {
@@ -357,11 +360,11 @@ void MainWindow::makePlotSystem(){
         }
 
     }else{
-        x.resize(data.size()); y.resize(data.size()); // initialize with entries 0..100
-        for (int i=0; i<data.size(); ++i)
+        x.resize(int(buckets.size())); y.resize(int(buckets.size()));
+        for (int i=0; i<int(buckets.size()); ++i)
         {
-           x[i] = i; // x goes from -1 to 1
-           y[i] = data[i]; // let's plot a quadratic function
+           x[i] = i;
+           y[i] = buckets[size_t(i)].mean;
         }
     }
     double min1 = *std::min_element(y.constBegin(), y.constEnd());
@@ -371,19 +374,18 @@ void MainWindow::makePlotSystem(){
     ui->widget_4->addGraph();
     ui->widget_4->graph(0)->setData(x, y);
     ui->widget_4->graph(0)->setPen(QPen(QColor(255, 0, 0)));
-    ui->widget_4->graph(0)->setName("X");
+    ui->widget_4->graph(0)->setName(buckets.isEmpty() ? "X" : "mean");
     // give the axes some labels:
     ui->widget_4->xAxis->setLabel("t");
     ui->widget_4->yAxis->setLabel("P");
     // set axes ranges, so we see all data:
     ui->widget_4->xAxis->setRange(0, y.size());
     //ui->widget_4->yAxis->setRange(min1, max1);
-    QCPTextElement *title = new QCPTextElement(ui->widget_4, "System Parameters", QFont("sans", 10, QFont::Bold));
-    ui->widget_4->plotLayout()->addElement(1, 0, title);
+    addTitle(ui->widget_4, "System Parameters");
     ui->widget_4->replot();
 
     // generate some data:
-    if (data.size() == 0){
+    if (buckets.isEmpty()){
         for (int i=0; i<1000; ++i)
         {
             double noise1 = rand() % 3 + 1;
@@ -395,10 +397,10 @@ void MainWindow::makePlotSystem(){
         }
 
     }else{
-        for (int i=0; i<data.size(); ++i)
+        for (int i=0; i<int(buckets.size()); ++i)
         {
-           x[i] = i; // x goes from -1 to 1
-           y[i] = data[i]; // let's plot a quadratic function
+           x[i] = i;
+           y[i] = buckets[size_t(i)].min;
         }
     }
     double min2 = *std::min_element(y.constBegin(), y.constEnd());
@@ -407,19 +409,18 @@ void MainWindow::makePlotSystem(){
     ui->widget_4->addGraph();
     ui->widget_4->graph(1)->setData(x, y);
     ui->widget_4->graph(1)->setPen(QPen(QColor(0, 255, 0)));
-    ui->widget_4->graph(1)->setName("Y");
+    ui->widget_4->graph(1)->setName(buckets.isEmpty() ? "Y" : "min");
     // give the axes some labels:
     ui->widget_4->xAxis->setLabel("t");
     ui->widget_4->yAxis->setLabel("P");
     // set axes ranges, so we see all data:
     ui->widget_4->xAxis->setRange(0, y.size());
     //ui->widget_4->yAxis->setRange(min2, max2);
-    title = new QCPTextElement(ui->widget_4, "System Parameters", QFont("sans", 10, QFont::Bold));
-    ui->widget_4->plotLayout()->addElement(1, 0, title);
+    addTitle(ui->widget_4, "System Parameters");
     ui->widget_4->replot();
 
     // generate some data:
-    if (data.size() == 0){
+    if (buckets.isEmpty()){
         for (int i=0; i<1000; ++i)
         {
             double noise1 = rand() % 3 + 1;
@@ -431,10 +432,10 @@ void MainWindow::makePlotSystem(){
         }
 
     }else{
-        for (int i=0; i<data.size(); ++i)
+        for (int i=0; i<int(buckets.size()); ++i)
         {
-           x[i] = i; // x goes from -1 to 1
-           y[i] = data[i]; // let's plot a quadratic function
+           x[i] = i;
+           y[i] = buckets[size_t(i)].max;
         }
     }
     double min3 = *std::min_element(y.constBegin(), y.constEnd());
@@ -443,7 +444,7 @@ void MainWindow::makePlotSystem(){
     ui->widget_4->addGraph();
     ui->widget_4->graph(2)->setData(x, y);
     ui->widget_4->graph(2)->setPen(QPen(QColor(0, 0, 255)));
-    ui->widget_4->graph(2)->setName("Z");
+    ui->widget_4->graph(2)->setName(buckets.isEmpty() ? "Z" : "max");
     // give the axes some labels:
     ui->widget_4->xAxis->setLabel("t");
     ui->widget_4->yAxis->setLabel("P");
@@ -451,30 +452,27 @@ void MainWindow::makePlotSystem(){
     ui->widget_4->xAxis->setRange(0, y.size());
 
     ui->widget_4->yAxis->setRange(std::min(std::min(min1,min2),min3), std::max(std::max(max1,max2),max3));
-    title = new QCPTextElement(ui->widget_4, "System Parameters", QFont("sans", 10, QFont::Bold));
-    ui->widget_4->plotLayout()->addElement(1, 0, title);
+    addTitle(ui->widget_4, "System Parameters");
     ui->widget_4->replot();
 }
 
-void MainWindow::readSerial()
+void MainWindow::drainSerial()
 {
-    QStringList buffer_split = serialBuffer.split(",");
-    if(buffer_split.length() < 3){
-        serialData = arduino->readAll();
-        serialBuffer = serialBuffer + QString::fromStdString(serialData.toStdString());
-        serialData.clear();
-    }else{
-        serialBuffer = "";
-        parsed_data1 = buffer_split[0];
-        parsed_data2 = buffer_split[1];
-        data.push_back(parsed_data1.toDouble());
-        data.push_back(parsed_data2.toDouble());
-        qDebug() << parsed_data1.toDouble() << parsed_data2.toDouble() << "\n";
-    }
+    // Take what the serial thread queued since the last frame, bounded so a burst is spread over frames
+    size_t count = pv->serialReader->samples().pop(pv->drained.data(), pv->drained.size());
+    if (count == 0)
+        return;
+    for (size_t i = 0; i < count; ++i)
+        pv->sensorSeries.append(pv->drained[i].rxTimeNs, pv->drained[i].value);
     makePlotMeasurement();
     makePlotSystem();
 }
 
+void MainWindow::reportSerialError(const QString &message)
+{
+    qDebug() << "Serial port error:" << message;
+}
+
 void MainWindow::doCapture()
 {
     QImage image = pv->cap.capture();
@@ -500,6 +498,17 @@ void MainWindow::doMap()
     ui->widget_3->setFixedSize(w-1, h-1);
 }
 
+void MainWindow::doTrack()
+{
+    CNMEAParserData::KINEMATIC_STATE_T state;
+    pv->nmea.ExtrapolateKinematicState(CNMEAClock::GetTimeNs(), state);
+    if (!state.m_bValid)
+        return;
+    webview->page()->runJavaScript(QString("setPosition(%1, %2)")
+                                   .arg(state.m_dLatitude, 0, 'f', 8)
+                                   .arg(state.m_dLongitude, 0, 'f', 8));
+}
+
 void MainWindow::on_action_file_save_as_triggered()
 {
     QString path = QFileDialog::getSaveFileName(this, tr("Save as"), QString(), "JPEG files (*.jpg);;PNG files (*.png)");
@@ -510,13 +519,11 @@ void MainWindow::on_action_file_save_as_triggered()
 }
 
 void MainWindow::doGPS(){
-    CNMEAParserData::GGA_DATA_T gpggaData;
-    MyNMEAParser	NMEAParser;
-    NMEAParser.ResetData();
-    const char * szGGASample = "$GPGGA,145416.00,3350.10959,N,11751.22870,W,1,09,0.85,70.3,M,-32.7,M,,*5B";
-    NMEAParser.ProcessNMEABuffer((char *)szGGASample, (int)strlen(szGGASample));
-    NMEAParser.GetGPGGA(gpggaData);
-    std::cout<<gpggaData.m_dLatitude<<std::endl;
+    // The serial thread feeds the parser with the receiver's sentences, read the published
+    // snapshot instead of the parser's own copy
+    if (pv->nmea.ReadGGA(CNMEAParserData::TID_GP, pv->gpggaData, pv->gpggaVersion) == CNMEAParserData::ERROR_OK) {
+        std::cout<<pv->gpggaData.m_dLatitude<<std::endl;
+    }
 }
 
 void MainWindow::on_action_edit_copy_triggered()
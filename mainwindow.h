@@ -26,9 +26,11 @@ public:
 private slots:
     void makePlotMeasurement();
     void makePlotSystem();
-    void readSerial();
+    void drainSerial();
+    void reportSerialError(const QString &message);
     void doCapture();
     void doMap();
+    void doTrack();
     void doGPS();
     void on_action_file_save_as_triggered();
     void on_action_edit_copy_triggered();
@@ -37,14 +39,8 @@ private:
     struct Private;
     Private *pv;
     Ui::MainWindow *ui;
-    QSerialPort *arduino;
     static const quint16 arduino_uno_vendor_id = 9025;
     static const quint16 arduino_uno_product_id = 67;
-    QByteArray serialData;
-    QString serialBuffer;
-    QString parsed_data1;
-    QString parsed_data2;
-    QVector<double> data;
     QWebEngineView* webview;
     QVBoxLayout* layout;
 
@@ -0,0 +1,180 @@
+#include "serialreader.h"
+#include "NMEAParserLib/NMEAClock.h"
+#include "NMEAParserLib/NMEAParser.h"
+
+#include <QSerialPort>
+
+/*!
+    \brief Reads and demultiplexes the serial port on its own thread.
+
+    Move the reader to a QThread and invoke open() there (ie: from QThread::started), so the
+    port and its readyRead handling live on that thread. StreamDemux splits the link into
+    records: NMEA sentences, including those inside telemetry text frames, go to the parser
+    set with setNmeaParser(), which is then fed on this thread only. Every sensor value goes
+    into a single-producer/single-consumer ring that the UI drains at its own frame rate.
+    Nothing the UI does can hold up the port: when the UI falls a whole ring behind, new
+    samples are dropped and counted instead of waiting.
+
+    With setBinaryTelemetry() the reader asks the receiver for binary telemetry frames (see
+    TelemetryDecoder). A receiver that keeps talking ASCII, ie: older firmware, is detected
+    when no frame shows up for a while, and read as ASCII again.
+*/
+
+// Bytes without a single valid frame before binary telemetry is given up
+static const qint64 c_binaryFallbackBytes = 2 * Telemetry::maxFrameSize;
+
+SerialReader::SerialReader(const QString &portName, qint32 baudRate, size_t capacity, QObject *parent)
+    : QObject(parent)
+    , m_portName(portName)
+    , m_baudRate(baudRate)
+    , m_port(nullptr)
+    , m_nmea(nullptr)
+    , m_binaryRequested(false)
+    , m_binary(false)
+    , m_negotiated(false)
+    , m_bytesWithoutFrame(0)
+    , m_samples(capacity)
+    , m_dropped(0)
+{
+}
+
+SerialReader::~SerialReader()
+{
+    close();
+}
+
+/*!
+    Open the port. Call on the reader's thread.
+*/
+void SerialReader::open()
+{
+    close();
+    m_port = new QSerialPort(m_portName, this);
+    if (!m_port->open(m_binaryRequested ? QSerialPort::ReadWrite : QSerialPort::ReadOnly)) {
+        emit error(m_port->errorString());
+        delete m_port;
+        m_port = nullptr;
+        return;
+    }
+    m_port->setBaudRate(m_baudRate);
+    m_port->setDataBits(QSerialPort::Data8);
+    m_port->setFlowControl(QSerialPort::NoFlowControl);
+    m_port->setParity(QSerialPort::NoParity);
+    m_port->setStopBits(QSerialPort::OneStop);
+    connect(m_port, SIGNAL(readyRead()), this, SLOT(readSerial()));
+
+    setBinary(m_binaryRequested);
+    m_negotiated = false;
+    m_bytesWithoutFrame = 0;
+    if (m_binaryRequested)
+        m_port->write(&Telemetry::negotiateBinary, 1);
+    connect(m_port, SIGNAL(errorOccurred(QSerialPort::SerialPortError)), this, SLOT(handleError(QSerialPort::SerialPortError)));
+}
+
+/*!
+    Close the port. Call on the reader's thread, or after it has finished.
+*/
+void SerialReader::close()
+{
+    if (m_port) {
+        m_port->close();
+        delete m_port;
+        m_port = nullptr;
+    }
+    m_demux.reset();
+    m_decoder.reset();
+}
+
+void SerialReader::readSerial()
+{
+    int64_t rxTimeNs = CNMEAClock::GetTimeNs();
+
+    // Read straight into the demultiplexer, it always has room after next() returned false
+    StreamDemux::Record record;
+    for (;;) {
+        qint64 bytes = m_port->read(m_demux.writePointer(), qint64(m_demux.writeSpace()));
+        if (bytes <= 0)
+            break;
+        m_demux.commit(size_t(bytes));
+        m_bytesWithoutFrame += bytes;
+        bool wasBinary = m_demux.isBinary();
+        while (m_demux.next(record)) {
+            switch (record.kind) {
+            case StreamDemux::KindNmea:
+                processNmea(rxTimeNs, record.data, record.length);
+                break;
+            case StreamDemux::KindSample:
+                processSample(rxTimeNs, record);
+                break;
+            default:
+                processFrame(rxTimeNs, record);
+                break;
+            }
+        }
+
+        if (m_demux.isBinary() != wasBinary)
+            setBinary(m_demux.isBinary());     // the receiver acknowledged binary mode
+        if (m_demux.isBinary() && !m_negotiated) {
+            // The receiver may have missed the request while it was restarting on open
+            m_port->write(&Telemetry::negotiateBinary, 1);
+        }
+        if (m_demux.isBinary() && m_bytesWithoutFrame > c_binaryFallbackBytes) {
+            emit error(QStringLiteral("no binary telemetry from %1, reading ASCII").arg(m_portName));
+            setBinary(false);
+        }
+    }
+}
+
+void SerialReader::processNmea(int64_t rxTimeNs, char *data, size_t length)
+{
+    // Records and text frames hold exactly one sentence, decode it where it is
+    if (m_nmea)
+        m_nmea->ProcessNMEASentence(data, length, rxTimeNs);
+}
+
+void SerialReader::processSample(int64_t rxTimeNs, const StreamDemux::Record &record)
+{
+    double value;
+    if (StreamDemux::parseSample(record, value))
+        push(rxTimeNs, value);
+}
+
+void SerialReader::processFrame(int64_t rxTimeNs, const StreamDemux::Record &record)
+{
+    TelemetryFrame frame;
+    if (!m_decoder.decode(record.data, record.length, frame))
+        return;
+
+    m_negotiated = true;
+    m_bytesWithoutFrame = 0;
+
+    if (frame.type == Telemetry::TypeText) {
+        if (frame.channel == Telemetry::ChannelNmea)
+            processNmea(rxTimeNs, const_cast<char *>(frame.text()), size_t(frame.count));
+    } else if (frame.channel == Telemetry::ChannelSensor) {
+        for (int i = 0; i < frame.count; ++i)
+            push(rxTimeNs, frame.value(i));
+    }
+}
+
+void SerialReader::setBinary(bool binary)
+{
+    m_demux.setBinary(binary);
+    m_binary.store(binary, std::memory_order_relaxed);
+    m_bytesWithoutFrame = 0;
+}
+
+void SerialReader::handleError(QSerialPort::SerialPortError error)
+{
+    if (error != QSerialPort::NoError && error != QSerialPort::TimeoutError)
+        emit this->error(m_port->errorString());
+}
+
+void SerialReader::push(int64_t rxTimeNs, double value)
+{
+    SerialSample sample;
+    sample.rxTimeNs = rxTimeNs;
+    sample.value = value;
+    if (!m_samples.push(sample))
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+}
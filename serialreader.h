@@ -0,0 +1,68 @@
+#ifndef SERIALREADER_H
+#define SERIALREADER_H
+
+#include <QObject>
+#include <QSerialPort>
+#include <atomic>
+#include <stdint.h>
+#include "spscring.h"
+#include "streamdemux.h"
+#include "telemetrydecoder.h"
+
+class CNMEAParser;
+
+struct SerialSample {
+    int64_t rxTimeNs;       // CNMEAClock::GetTimeNs() when the read completed
+    double value;
+};
+
+class SerialReader : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef SpscRing<SerialSample> Ring;
+
+    SerialReader(const QString &portName, qint32 baudRate, size_t capacity, QObject *parent = nullptr);
+    ~SerialReader();
+
+    void setNmeaParser(CNMEAParser *parser) { m_nmea = parser; }
+    void setBinaryTelemetry(bool enabled) { m_binaryRequested = enabled; }
+    bool isBinary() const { return m_binary.load(std::memory_order_relaxed); }
+
+    Ring &samples() { return m_samples; }
+    quint64 droppedSamples() const { return m_dropped.load(std::memory_order_relaxed); }
+
+public slots:
+    void open();
+    void close();
+
+signals:
+    void error(const QString &message);
+
+private slots:
+    void readSerial();
+    void handleError(QSerialPort::SerialPortError error);
+
+private:
+    void push(int64_t rxTimeNs, double value);
+    void processNmea(int64_t rxTimeNs, char *data, size_t length);
+    void processSample(int64_t rxTimeNs, const StreamDemux::Record &record);
+    void processFrame(int64_t rxTimeNs, const StreamDemux::Record &record);
+    void setBinary(bool binary);
+
+    QString m_portName;
+    qint32 m_baudRate;
+    QSerialPort *m_port;
+    CNMEAParser *m_nmea;
+    bool m_binaryRequested;
+    std::atomic<bool> m_binary;
+    bool m_negotiated;
+    qint64 m_bytesWithoutFrame;
+    StreamDemux m_demux;
+    TelemetryDecoder m_decoder;
+    Ring m_samples;
+    std::atomic<quint64> m_dropped;
+};
+
+#endif // SERIALREADER_H
@@ -0,0 +1,86 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/*!
+    \brief Lock-free ring of \c T between exactly one producer thread and one consumer thread.
+
+    The producer never waits: push() fails when the ring is full and the caller decides what
+    to do with the element (SerialReader counts it as dropped). The consumer takes whatever
+    is there in bulk with pop(). Head and tail live on separate cache lines so the two
+    threads do not bounce a line on every element.
+
+    The capacity is rounded up to a power of two.
+*/
+template <typename T>
+class SpscRing
+{
+public:
+    explicit SpscRing(size_t capacity)
+        : m_mask(roundUp(capacity) - 1)
+        , m_items(m_mask + 1)
+        , m_head(0)
+        , m_tail(0)
+    {
+    }
+
+    size_t capacity() const { return m_mask + 1; }
+
+    /*!
+        Producer: append \a item. Returns false, leaving the ring unchanged, if it is full.
+    */
+    bool push(const T &item)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) > m_mask)
+            return false;
+        m_items[head & m_mask] = item;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*!
+        Consumer: move up to \a maxItems of the oldest elements to \a out. Returns the number moved.
+    */
+    size_t pop(T *out, size_t maxItems)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t count = m_head.load(std::memory_order_acquire) - tail;
+        if (count > maxItems)
+            count = maxItems;
+        for (size_t i = 0; i < count; ++i)
+            out[i] = m_items[(tail + i) & m_mask];
+        m_tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    /*!
+        Elements waiting; exact on the consumer side, a lower bound on the producer side.
+    */
+    size_t size() const
+    {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+
+private:
+    static size_t roundUp(size_t capacity)
+    {
+        size_t size = 1;
+        while (size < capacity)
+            size <<= 1;
+        return size;
+    }
+
+    SpscRing(const SpscRing &);
+    SpscRing &operator=(const SpscRing &);
+
+    const size_t m_mask;
+    std::vector<T> m_items;
+    alignas(64) std::atomic<size_t> m_head;     // written by the producer only
+    alignas(64) std::atomic<size_t> m_tail;     // written by the consumer only
+};
+
+#endif // SPSCRING_H
@@ -0,0 +1,163 @@
+#include "streamdemux.h"
+#include "NMEAParserLib/NMEAScan.h"
+#include "NMEAParserLib/NMEAFieldParser.h"
+
+#include <string.h>
+
+/*!
+    \brief Splits the one serial link into NMEA sentences, sensor samples and binary frames.
+
+    The receiver interleaves "$GPGGA...\n" sentences with bare "value;" samples in ASCII
+    mode, and sends COBS encoded telemetry frames ending in a zero byte in binary mode.
+    Bytes are read straight into the demultiplexer's fixed buffer (writePointer(),
+    writeSpace(), commit()) and next() hands out one record at a time as a pointer into
+    that buffer, for the NMEA parser, parseSample() or TelemetryDecoder. Nothing is copied.
+
+    The first byte of a record decides what it is and therefore which delimiter ends it:
+    '$' starts a sentence up to '\n', a digit or sign starts a sample up to ';'. A zero byte
+    always ends a binary frame, whatever its first byte looked like. The delimiter search
+    resumes where the previous read stopped, so every byte is scanned once. In binary mode
+    every record is a frame; the receiver sends its sentences inside text frames. The zero
+    byte that acknowledges Telemetry::negotiateBinary switches to binary mode by itself.
+*/
+
+namespace {
+    enum ByteClass { ClassOther, ClassNmea, ClassSample, ClassSpace };
+
+    inline ByteClass classify(char c)
+    {
+        if (c == '$')
+            return ClassNmea;
+        if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.')
+            return ClassSample;
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+            return ClassSpace;
+        return ClassOther;
+    }
+}
+
+StreamDemux::StreamDemux()
+    : m_begin(0)
+    , m_scan(0)
+    , m_end(0)
+    , m_kind(KindNone)
+    , m_binary(false)
+    , m_overflows(0)
+{
+}
+
+/*!
+    Adds \a bytes that were written at writePointer().
+*/
+void StreamDemux::commit(size_t bytes)
+{
+    m_end += bytes;
+}
+
+/*!
+    Switch between ASCII and binary mode. A record that is not finished yet is classified
+    again in the new mode.
+*/
+void StreamDemux::setBinary(bool binary)
+{
+    m_binary = binary;
+    m_kind = KindNone;
+    m_scan = m_begin;
+}
+
+/*!
+    Returns the next complete record in \a record. Returns false when only an unfinished
+    record is left, after making room for the next read.
+*/
+bool StreamDemux::next(Record &record)
+{
+    for (;;) {
+        if (m_begin == m_end) {
+            m_begin = m_scan = m_end = 0;
+            return false;
+        }
+
+        if (m_kind == KindNone) {
+            if (m_binary) {
+                m_kind = KindBinary;
+            } else {
+                switch (classify(m_buffer[m_begin])) {
+                case ClassNmea: m_kind = KindNmea; break;
+                case ClassSample: m_kind = KindSample; break;
+                case ClassSpace:
+                case ClassOther:
+                    // A lone zero is the receiver acknowledging binary mode
+                    if (m_buffer[m_begin] == '\0')
+                        m_binary = true;
+                    m_begin++;          // line endings and noise between records
+                    continue;
+                }
+            }
+            m_scan = m_begin;
+        }
+
+        const char *scan = m_buffer + m_scan;
+        size_t length = m_end - m_scan;
+        size_t offset;
+        switch (m_kind) {
+        case KindNmea: offset = CNMEAScan::FindEitherChar(scan, length, '\n', '\0'); break;
+        case KindSample: offset = CNMEAScan::FindEitherChar(scan, length, ';', '\0'); break;
+        default: offset = CNMEAScan::FindChar(scan, length, '\0'); break;
+        }
+        if (offset == length) {
+            m_scan = m_end;
+            compact();
+            return false;
+        }
+
+        size_t stop = m_scan + offset;
+        record.data = m_buffer + m_begin;
+        if (m_buffer[stop] == '\0') {
+            record.kind = KindBinary;
+            record.length = stop - m_begin;
+        } else {
+            record.kind = m_kind;
+            record.length = (m_kind == KindNmea) ? stop + 1 - m_begin : stop - m_begin;
+        }
+        m_begin = stop + 1;
+        m_scan = m_begin;
+        m_kind = KindNone;
+        if (record.length != 0)
+            return true;
+    }
+}
+
+void StreamDemux::reset()
+{
+    m_begin = m_scan = m_end = 0;
+    m_kind = KindNone;
+}
+
+/*!
+    Converts a KindSample \a record in place. Returns false if it is not a number.
+*/
+bool StreamDemux::parseSample(const Record &record, double &value)
+{
+    const char *p = record.data;
+    size_t length = record.length;
+    while (length > 0 && (p[length - 1] == ' ' || p[length - 1] == '\r' || p[length - 1] == '\n'))
+        length--;
+    return length > 0 && CNMEAFieldParser::ParseDouble(p, length, value) == CNMEAParserData::ERROR_OK;
+}
+
+void StreamDemux::compact()
+{
+    if (m_begin == 0 && m_end == capacity) {
+        // No delimiter in a full buffer: drop it and resynchronize on the next record
+        m_overflows++;
+        m_begin = m_scan = m_end = 0;
+        m_kind = KindNone;
+        return;
+    }
+    size_t length = m_end - m_begin;
+    if (length != 0 && m_begin != 0)
+        memmove(m_buffer, m_buffer + m_begin, length);
+    m_scan -= m_begin;
+    m_begin = 0;
+    m_end = length;
+}
@@ -0,0 +1,53 @@
+#ifndef STREAMDEMUX_H
+#define STREAMDEMUX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+class StreamDemux
+{
+public:
+    enum { capacity = 4096 };
+
+    enum Kind {
+        KindNone,
+        KindNmea,       // "$...\n", delimiter included
+        KindSample,     // "value;", delimiter excluded
+        KindBinary      // COBS encoded telemetry frame, zero delimiter excluded
+    };
+
+    struct Record {
+        Kind kind;
+        char *data;     // into the receive buffer, valid until the next read
+        size_t length;
+    };
+
+    StreamDemux();
+
+    char *writePointer() { return m_buffer + m_end; }
+    size_t writeSpace() const { return capacity - m_end; }
+    void commit(size_t bytes);
+
+    void setBinary(bool binary);
+    bool isBinary() const { return m_binary; }
+
+    bool next(Record &record);
+    void reset();
+
+    static bool parseSample(const Record &record, double &value);
+
+    uint64_t overflows() const { return m_overflows; }
+
+private:
+    void compact();
+
+    char m_buffer[capacity];
+    size_t m_begin;
+    size_t m_scan;
+    size_t m_end;
+    Kind m_kind;
+    bool m_binary;
+    uint64_t m_overflows;
+};
+
+#endif // STREAMDEMUX_H
@@ -0,0 +1,125 @@
+#include "telemetrydecoder.h"
+
+#include <string.h>
+
+/*!
+    \brief Decodes the binary telemetry frames of arduino/receiver.ino.
+
+    A frame is a header (channel byte with the sample type in bits 7-5, sequence number,
+    decimal exponent, sample count), the packed little endian samples and a CRC-16/CCITT
+    of all of that. It is COBS encoded, so it contains no zero bytes, and every frame ends
+    with a zero. A lost or corrupted byte costs at most the frame it is in: StreamDemux
+    always resynchronizes on the next zero.
+
+    The receiver starts in its ASCII mode; the host switches it with
+    Telemetry::negotiateBinary.
+*/
+
+uint16_t Telemetry::crc16(const uint8_t *data, size_t length)
+{
+    // CRC-16/CCITT-FALSE: polynomial 0x1021, initial value 0xffff
+    uint16_t crc = 0xffff;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= uint16_t(data[i]) << 8;
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc & 0x8000) ? uint16_t((crc << 1) ^ 0x1021) : uint16_t(crc << 1);
+    }
+    return crc;
+}
+
+namespace {
+    const double powersOfTen[] = { 1e-9, 1e-8, 1e-7, 1e-6, 1e-5, 1e-4, 1e-3, 1e-2, 1e-1, 1.0,
+                                   1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+
+    size_t sampleSize(Telemetry::SampleType type)
+    {
+        switch (type) {
+        case Telemetry::TypeInt16: return 2;
+        case Telemetry::TypeInt32: return 4;
+        case Telemetry::TypeText: return 1;
+        }
+        return 0;
+    }
+}
+
+double TelemetryFrame::value(int index) const
+{
+    const uint8_t *p = payload + index * sampleSize(type);
+    int32_t raw;
+    if (type == Telemetry::TypeInt16)
+        raw = int16_t(p[0] | (p[1] << 8));
+    else
+        raw = int32_t(uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24));
+    return raw * powersOfTen[exponent + 9];
+}
+
+TelemetryDecoder::TelemetryDecoder()
+    : m_sequenceKnown(false)
+    , m_nextSequence(0)
+    , m_frames(0)
+    , m_crcErrors(0)
+    , m_malformed(0)
+    , m_lost(0)
+{
+}
+
+void TelemetryDecoder::reset()
+{
+    m_sequenceKnown = false;
+}
+
+/*!
+    Decodes one COBS encoded frame of \a length bytes without its zero delimiter. Returns
+    false, and counts why, if it is not a valid frame. The payload of \a frame stays valid
+    until the next call.
+*/
+bool TelemetryDecoder::decode(const char *encoded, size_t length, TelemetryFrame &frame)
+{
+    // COBS: each code byte is one more than the number of data bytes before the next zero
+    size_t size = 0;
+    size_t i = 0;
+    while (i < length) {
+        uint8_t code = uint8_t(encoded[i++]);
+        size_t run = size_t(code) - 1;
+        if (run > length - i || size + run + 1 > sizeof(m_frame)) {
+            m_malformed++;
+            return false;
+        }
+        memcpy(m_frame + size, encoded + i, run);
+        size += run;
+        i += run;
+        if (code != 0xff && i < length)
+            m_frame[size++] = 0;
+    }
+
+    if (size < Telemetry::headerSize + Telemetry::crcSize) {
+        m_malformed++;
+        return false;
+    }
+    size -= Telemetry::crcSize;
+    uint16_t crc = uint16_t(m_frame[size] | (m_frame[size + 1] << 8));
+    if (Telemetry::crc16(m_frame, size) != crc) {
+        m_crcErrors++;
+        return false;
+    }
+
+    frame.channel = m_frame[0] & 0x1f;
+    frame.type = Telemetry::SampleType(m_frame[0] >> 5);
+    frame.sequence = m_frame[1];
+    frame.exponent = int8_t(m_frame[2]);
+    frame.count = m_frame[3];
+    frame.payload = m_frame + Telemetry::headerSize;
+    size_t bytes = sampleSize(frame.type);
+    if (bytes == 0 || frame.exponent < -9 || frame.exponent > 9
+            || Telemetry::headerSize + frame.count * bytes != size) {
+        m_malformed++;
+        return false;
+    }
+
+    if (m_sequenceKnown)
+        m_lost += uint8_t(frame.sequence - m_nextSequence);
+    m_sequenceKnown = true;
+    m_nextSequence = uint8_t(frame.sequence + 1);
+    m_frames++;
+    return true;
+}
@@ -0,0 +1,67 @@
+#ifndef TELEMETRYDECODER_H
+#define TELEMETRYDECODER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Wire format shared with arduino/receiver.ino
+namespace Telemetry {
+    enum SampleType {
+        TypeInt16 = 0,      // little endian, value = raw * 10^exponent
+        TypeInt32 = 1,
+        TypeText = 2        // count bytes of text, ie: an NMEA sentence
+    };
+
+    enum Channel {
+        ChannelSensor = 1,
+        ChannelNmea = 2
+    };
+
+    // Sent by the host; the receiver answers with a frame delimiter and switches mode
+    const char negotiateBinary = 'B';
+    const char negotiateAscii = 'A';
+
+    const size_t headerSize = 4;    // channel, sequence, exponent, count
+    const size_t crcSize = 2;
+    const size_t maxFrameSize = 256;
+
+    inline uint8_t channelByte(SampleType type, int channel) { return uint8_t((type << 5) | (channel & 0x1f)); }
+    uint16_t crc16(const uint8_t *data, size_t length);
+}
+
+struct TelemetryFrame {
+    int channel;
+    Telemetry::SampleType type;
+    uint8_t sequence;
+    int exponent;
+    int count;
+    const uint8_t *payload;
+
+    double value(int index) const;
+    const char *text() const { return reinterpret_cast<const char *>(payload); }   // count bytes, not terminated
+};
+
+class TelemetryDecoder
+{
+public:
+    TelemetryDecoder();
+
+    bool decode(const char *encoded, size_t length, TelemetryFrame &frame);
+    void reset();
+
+    uint64_t frames() const { return m_frames; }
+    uint64_t crcErrors() const { return m_crcErrors; }
+    uint64_t malformedFrames() const { return m_malformed; }
+    uint64_t lostFrames() const { return m_lost; }
+
+private:
+    uint8_t m_frame[Telemetry::maxFrameSize];
+    bool m_sequenceKnown;
+    uint8_t m_nextSequence;
+    uint64_t m_frames;
+    uint64_t m_crcErrors;
+    uint64_t m_malformed;
+    uint64_t m_lost;
+};
+
+#endif // TELEMETRYDECODER_H
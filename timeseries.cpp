@@ -0,0 +1,76 @@
+#include "timeseries.h"
+
+/*!
+    \brief Bounded store for one channel of samples.
+
+    The newest samples are kept as they are in a fixed capacity ring. Alongside, every
+    sample updates the open bucket of each downsampled tier (1 s, 10 s and 1 min) with
+    its min, max and mean; a bucket moves into the tier's own fixed ring when the first
+    sample of the next interval arrives. Memory is fixed when the series is constructed
+    and an append costs the same after hours as after seconds.
+
+    Views read raw() and tier() as spans straight over the rings, in time order, so drawing
+    costs at most the ring capacity whatever the length of the session. Buckets only exist
+    for intervals that had samples; use Bucket::startNs to see gaps.
+*/
+
+static const int64_t c_tierWidthsNs[TimeSeries::TierCount] = {
+    1000000000LL,
+    10000000000LL,
+    60000000000LL
+};
+
+TimeSeries::TimeSeries(size_t rawCapacity, size_t tierCapacity)
+    : m_raw(rawCapacity)
+    , m_tiers(TierCount, TierState(tierCapacity))
+    , m_count(0)
+{
+}
+
+void TimeSeries::append(int64_t timeNs, double value)
+{
+    Point point;
+    point.timeNs = timeNs;
+    point.value = value;
+    m_raw.push(point);
+    m_count++;
+
+    for (int i = 0; i < TierCount; ++i) {
+        TierState &tier = m_tiers[i];
+        int64_t startNs = timeNs - timeNs % c_tierWidthsNs[i];
+        if (tier.open.count != 0 && startNs > tier.open.startNs) {
+            tier.open.mean = tier.sum / tier.open.count;
+            tier.closed.push(tier.open);
+            tier.open.count = 0;
+        }
+        if (tier.open.count == 0) {
+            tier.open.startNs = startNs;
+            tier.open.min = value;
+            tier.open.max = value;
+            tier.sum = 0.0;
+        } else {
+            // Samples out of order stay in the open bucket
+            if (value < tier.open.min)
+                tier.open.min = value;
+            if (value > tier.open.max)
+                tier.open.max = value;
+        }
+        tier.sum += value;
+        tier.open.count++;
+    }
+}
+
+void TimeSeries::clear()
+{
+    m_raw.clear();
+    for (int i = 0; i < TierCount; ++i) {
+        m_tiers[i].closed.clear();
+        m_tiers[i].open.count = 0;
+    }
+    m_count = 0;
+}
+
+int64_t TimeSeries::tierWidthNs(Tier tier)
+{
+    return c_tierWidthsNs[tier];
+}
@@ -0,0 +1,115 @@
+#ifndef TIMESERIES_H
+#define TIMESERIES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Contents of a ring in time order, as at most two contiguous runs; no copy is made
+template <typename T>
+struct TimeSeriesSpan {
+    const T *first;
+    size_t firstSize;
+    const T *second;
+    size_t secondSize;
+
+    size_t size() const { return firstSize + secondSize; }
+    bool isEmpty() const { return size() == 0; }
+    const T &operator[](size_t i) const { return i < firstSize ? first[i] : second[i - firstSize]; }
+    const T &back() const { return secondSize ? second[secondSize - 1] : first[firstSize - 1]; }
+};
+
+// Fixed capacity ring that overwrites its oldest element
+template <typename T>
+class TimeSeriesRing
+{
+public:
+    explicit TimeSeriesRing(size_t capacity)
+        : m_items(capacity)
+        , m_next(0)
+        , m_size(0)
+    {
+    }
+
+    void push(const T &item)
+    {
+        m_items[m_next] = item;
+        if (++m_next == m_items.size())
+            m_next = 0;
+        if (m_size < m_items.size())
+            m_size++;
+    }
+
+    void clear()
+    {
+        m_next = 0;
+        m_size = 0;
+    }
+
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_items.size(); }
+
+    TimeSeriesSpan<T> span() const
+    {
+        TimeSeriesSpan<T> span;
+        size_t oldest = (m_next + m_items.size() - m_size) % m_items.size();
+        span.first = m_items.data() + oldest;
+        span.firstSize = (oldest + m_size <= m_items.size()) ? m_size : m_items.size() - oldest;
+        span.second = m_items.data();
+        span.secondSize = m_size - span.firstSize;
+        return span;
+    }
+
+private:
+    std::vector<T> m_items;
+    size_t m_next;
+    size_t m_size;
+};
+
+class TimeSeries
+{
+public:
+    struct Point {
+        int64_t timeNs;
+        double value;
+    };
+
+    struct Bucket {
+        int64_t startNs;        // multiple of the tier width
+        double min;
+        double max;
+        double mean;
+        uint32_t count;
+    };
+
+    enum Tier {
+        TierSecond,
+        TierTenSeconds,
+        TierMinute,
+        TierCount
+    };
+
+    TimeSeries(size_t rawCapacity, size_t tierCapacity);
+
+    void append(int64_t timeNs, double value);
+    void clear();
+
+    uint64_t count() const { return m_count; }
+    TimeSeriesSpan<Point> raw() const { return m_raw.span(); }
+    TimeSeriesSpan<Bucket> tier(Tier tier) const { return m_tiers[tier].closed.span(); }
+    static int64_t tierWidthNs(Tier tier);
+
+private:
+    struct TierState {
+        explicit TierState(size_t capacity) : sum(0.0), closed(capacity) { open.count = 0; }
+        Bucket open;
+        double sum;
+        TimeSeriesRing<Bucket> closed;
+    };
+
+    TimeSeriesRing<Point> m_raw;
+    std::vector<TierState> m_tiers;
+    uint64_t m_count;
+};
+
+#endif // TIMESERIES_H